@@ -0,0 +1,123 @@
+#include <stdio.h>
+#include <time.h>
+#include "../mz/arraylist.h"
+#include "../mz/linkedlist.h"
+
+//compares the default api, as compiled for MZ_CHECK_POLICY, with the _unchecked variants
+#define BENCH_LEN 1000000
+#define BENCH_ROUNDS 20
+
+//keeps the compiler from dropping the loops
+volatile long bench_sink;
+
+double bench_now() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+void bench_report(const char *name, double checked, double unchecked) {
+  double ops = (double) BENCH_LEN * BENCH_ROUNDS;
+  printf("%-16s default %6.2f ns/op  unchecked %6.2f ns/op  %5.1fx\n", name, checked / ops, unchecked / ops,
+         checked / unchecked);
+}
+
+void bench_arraylist_get(mz_ArrayList *list) {
+  long sum = 0;
+  double start = bench_now();
+  for (int r = 0; r < BENCH_ROUNDS; r++) {
+    for (size_t i = 0; i < BENCH_LEN; i++) {
+      sum += (long) mz_arraylist_get(list, i);
+    }
+  }
+  double checked = bench_now() - start;
+  start = bench_now();
+  for (int r = 0; r < BENCH_ROUNDS; r++) {
+    for (size_t i = 0; i < BENCH_LEN; i++) {
+      sum += (long) mz_arraylist_get_unchecked(list, i);
+    }
+  }
+  bench_sink = sum;
+  bench_report("arraylist get", checked, bench_now() - start);
+}
+
+void bench_arraylist_set(mz_ArrayList *list) {
+  double start = bench_now();
+  for (int r = 0; r < BENCH_ROUNDS; r++) {
+    for (size_t i = 0; i < BENCH_LEN; i++) {
+      mz_arraylist_set(list, i, (void *) (long) (i + r));
+    }
+  }
+  double checked = bench_now() - start;
+  start = bench_now();
+  for (int r = 0; r < BENCH_ROUNDS; r++) {
+    for (size_t i = 0; i < BENCH_LEN; i++) {
+      mz_arraylist_set_unchecked(list, i, (void *) (long) (i + r));
+    }
+  }
+  bench_sink = (long) list->array[BENCH_LEN / 2];
+  bench_report("arraylist set", checked, bench_now() - start);
+}
+
+void bench_arraylist_append(mz_ArrayList *list) {
+  double start = bench_now();
+  for (int r = 0; r < BENCH_ROUNDS; r++) {
+    //the capacity stays reserved, so neither loop reallocates
+    list->size = 0;
+    for (size_t i = 0; i < BENCH_LEN; i++) {
+      mz_arraylist_append(list, (void *) (long) i);
+    }
+  }
+  double checked = bench_now() - start;
+  start = bench_now();
+  for (int r = 0; r < BENCH_ROUNDS; r++) {
+    list->size = 0;
+    for (size_t i = 0; i < BENCH_LEN; i++) {
+      mz_arraylist_append_unchecked(list, (void *) (long) i);
+    }
+  }
+  bench_sink = (long) list->array[BENCH_LEN - 1];
+  bench_report("arraylist append", checked, bench_now() - start);
+}
+
+void bench_linkedlist_push_shift() {
+  mz_LinkedList *list = mz_linkedlist_new();
+  long sum = 0;
+  double start = bench_now();
+  for (int r = 0; r < BENCH_ROUNDS; r++) {
+    for (size_t i = 0; i < BENCH_LEN; i++) {
+      mz_linkedlist_push(list, (void *) (long) i);
+    }
+    for (size_t i = 0; i < BENCH_LEN; i++) {
+      sum += (long) mz_linkedlist_shift(list);
+    }
+  }
+  double checked = bench_now() - start;
+  start = bench_now();
+  for (int r = 0; r < BENCH_ROUNDS; r++) {
+    for (size_t i = 0; i < BENCH_LEN; i++) {
+      mz_linkedlist_push_unchecked(list, (void *) (long) i);
+    }
+    for (size_t i = 0; i < BENCH_LEN; i++) {
+      sum += (long) mz_linkedlist_shift_unchecked(list);
+    }
+  }
+  bench_sink = sum;
+  bench_report("push and shift", checked, bench_now() - start);
+  mz_linkedlist_free(list);
+}
+
+int main() {
+  printf("MZ_CHECK_POLICY %d, %d operations per benchmark\n", MZ_CHECK_POLICY, BENCH_LEN * BENCH_ROUNDS);
+  mz_ArrayList *list = mz_arraylist_new(MZ_ARRAYLIST_INLINE_CAPACITY, sizeof(void *));
+  mz_arraylist_reserve(list, BENCH_LEN);
+  for (size_t i = 0; i < BENCH_LEN; i++) {
+    mz_arraylist_append(list, (void *) (long) i);
+  }
+  bench_arraylist_get(list);
+  bench_arraylist_set(list);
+  bench_arraylist_append(list);
+  bench_linkedlist_push_shift();
+  mz_arraylist_free(list);
+  return 0;
+}
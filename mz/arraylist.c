@@ -1,74 +1,146 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "arraylist.h"
 #include "logger.h"
 #include "type.h"
 
-bool _mz_arraylist_optimize_capacity(mz_ArrayList *list, int new_size) {
+bool _mz_arraylist_optimize_capacity(mz_ArrayList *list, size_t new_size) {
   bool result = true;
   size_t new_capacity = list->initial_capacity;
   while (new_capacity <= new_size) {
     new_capacity *= 2;
   }
-  void *array = realloc(list->array, new_capacity * sizeof(void *));
-  if (!array) {
-    ERROR("could not reallocate memory for arraylist->array");
-    result = false;
-  } else {
+  if (new_capacity == list->capacity) {
+    //nothing to do
+  } else if (new_capacity <= MZ_ARRAYLIST_INLINE_CAPACITY) {
+    //fits in the inline buffer: move back from the heap if the list has shrunk
+    if (!mz_arraylist_is_inline(list)) {
+      memcpy(list->inline_array, list->array, list->size * sizeof(void *));
+      free(list->array);
+      list->array = list->inline_array;
+    }
     list->capacity = new_capacity;
-    list->array = array;
+  } else if (mz_arraylist_is_inline(list)) {
+    //spill the inline buffer to the heap
+    void **array = malloc(new_capacity * sizeof(void *));
+    if (!array) {
+      ERROR("could not allocate memory for arraylist->array");
+      result = false;
+    } else {
+      memcpy(array, list->inline_array, list->size * sizeof(void *));
+      list->capacity = new_capacity;
+      list->array = array;
+    }
+  } else {
+    void *array = realloc(list->array, new_capacity * sizeof(void *));
+    if (!array) {
+      ERROR("could not reallocate memory for arraylist->array");
+      result = false;
+    } else {
+      list->capacity = new_capacity;
+      list->array = array;
+    }
   }
-  return true;
+  return result;
 }
 
-int _mz_arraylist_normalize_index(int size, int index) {
+size_t _mz_arraylist_normalize_index(size_t size, ptrdiff_t index) {
   if (index < 0) {
     //if the list is not empty, count from the back of the array
-    //otherwise, set the index to zero
-    index = size > 0 ? size + index : 0;
+    //otherwise, set the index to zero.
+    //an index before the start of the list wraps around and fails the range check
+    return size > 0 ? size - (size_t) -index : 0;
   }
-  return index;
+  return (size_t) index;
 }
 
-bool _mz_arraylist_is_index_within_range(int size, int index) {
-  return 0 <= index && index < size;
+bool _mz_arraylist_is_index_within_range(size_t size, size_t index) {
+  return index < size;
 }
 
-mz_ArrayList *mz_arraylist_new(size_t initial_capacity, size_t element_size) {
-  mz_ArrayList *list = NULL;
+bool mz_arraylist_init(mz_ArrayList *list, size_t initial_capacity, size_t element_size) {
+  bool result = false;
   if (initial_capacity < 1) {
     ERROR("invalid initial_capacity for arraylist. initial_capacity must be greater than 1");
   } else {
-    list = calloc(1, sizeof(mz_ArrayList));
-    if (!list) {
-      ERROR("could not allocate memory for arraylist");
+    list->initial_capacity = initial_capacity;
+    list->element_size = element_size;
+    list->size = 0;
+    list->capacity = initial_capacity;
+    if (initial_capacity <= MZ_ARRAYLIST_INLINE_CAPACITY) {
+      memset(list->inline_array, 0, sizeof(list->inline_array));
+      list->array = list->inline_array;
+      result = true;
     } else {
-      list->initial_capacity = initial_capacity;
-      list->element_size = element_size;
-      list->size = 0;
-      list->capacity = initial_capacity;
       list->array = calloc(list->capacity, sizeof(void *));
       if (!list->array) {
         ERROR("could not allocate memory for arraylist->array");
-        free(list);
+      } else {
+        result = true;
       }
     }
   }
-  return list;
+  return result;
 }
 
-void mz_arraylist_free(mz_ArrayList *list) {
+void mz_arraylist_destroy(mz_ArrayList *list) {
   if (list) {
-    if (list->array) {
+    if (list->array && !mz_arraylist_is_inline(list)) {
       free(list->array);
     }
+    list->array = list->inline_array;
+    list->size = 0;
+    list->capacity = 0;
+  }
+}
+
+void mz_arraylist_move(mz_ArrayList *destination, mz_ArrayList *source) {
+  *destination = *source;
+  if (mz_arraylist_is_inline(source)) {
+    destination->array = destination->inline_array;
+  }
+  source->array = source->inline_array;
+  source->size = 0;
+  source->capacity = 0;
+}
+
+mz_ArrayList *mz_arraylist_new(size_t initial_capacity, size_t element_size) {
+  mz_ArrayList *list = NULL;
+  if (initial_capacity < 1) {
+    ERROR("invalid initial_capacity for arraylist. initial_capacity must be greater than 1");
+  } else {
+    list = malloc(sizeof(mz_ArrayList));
+    if (!list) {
+      ERROR("could not allocate memory for arraylist");
+    } else if (!mz_arraylist_init(list, initial_capacity, element_size)) {
+      free(list);
+      list = NULL;
+    }
+  }
+  return list;
+}
+
+void mz_arraylist_free(mz_ArrayList *list) {
+  if (list) {
+    mz_arraylist_destroy(list);
     free(list);
   }
 }
 
+bool mz_arraylist_reserve(mz_ArrayList *list, size_t capacity) {
+  bool result = true;
+  if (capacity > list->capacity && !_mz_arraylist_optimize_capacity(list, capacity - 1)) {
+    ERROR("could not optimize array capacity");
+    result = false;
+  }
+  return result;
+}
+
 bool mz_arraylist_append(mz_ArrayList *list, void *element) {
   bool result = true;
-  if (!_mz_arraylist_optimize_capacity(list, list->size)) {
+  //growing only, so capacity set aside by mz_arraylist_reserve is kept
+  if (!mz_arraylist_reserve(list, list->size + 1)) {
     ERROR("could not optimize array capacity");
     result = false;
   } else {
@@ -77,35 +149,28 @@ bool mz_arraylist_append(mz_ArrayList *list, void *element) {
   return result;
 }
 
-bool mz_arraylist_append_range(mz_ArrayList *list, void **elements, unsigned int len) {
+bool mz_arraylist_append_range(mz_ArrayList *list, void **elements, size_t len) {
   bool result = true;
-  if (!_mz_arraylist_optimize_capacity(list, list->size + len)) {
+  if (!mz_arraylist_reserve(list, list->size + len)) {
     ERROR("could not optimize array capacity");
     result = false;
   } else {
-    for (int i = 0; i < len; i++) {
-      list->array[list->size++] = elements[i];
-    }
+    memcpy(list->array + list->size, elements, len * sizeof(void *));
+    list->size += len;
   }
   return result;
 }
 
-bool mz_arraylist_insert_at(mz_ArrayList *list, int index, void *element) {
+bool mz_arraylist_insert_at(mz_ArrayList *list, size_t index, void *element) {
   bool result = false;
-  //negative to positive conversion:
-  index = _mz_arraylist_normalize_index(list->size, index);
-  //if index is out of range or the following is also not true -
-  //the list is empty and the index is either 0 or -1
-  if (!_mz_arraylist_is_index_within_range(list->size, index) &&
-      !(list->size == 0 && (index == 0 || index == -1))) {
-    ERROR("index is out of range - %d", index);
+  //an index within range, or 0 for an empty list
+  if (!_MZ_CHECK(_mz_arraylist_is_index_within_range(list->size, index) || (list->size == 0 && index == 0))) {
+    ERROR("index is out of range - %zu", index);
   } else {
-    if (!_mz_arraylist_optimize_capacity(list, list->size)) {
+    if (!mz_arraylist_reserve(list, list->size + 1)) {
       ERROR("could not optimize capacity");
     } else {
-      for (int i = list->size - 1; i >= index; i--) {
-        list->array[i + 1] = list->array[i];
-      }
+      memmove(list->array + index + 1, list->array + index, (list->size - index) * sizeof(void *));
       list->size += 1;
       list->array[index] = element;
       result = true;
@@ -114,16 +179,12 @@ bool mz_arraylist_insert_at(mz_ArrayList *list, int index, void *element) {
   return result;
 }
 
-bool mz_arraylist_remove_at(mz_ArrayList *list, int index) {
+bool mz_arraylist_remove_at(mz_ArrayList *list, size_t index) {
   bool result = false;
-  //negative to positive conversion:
-  index = _mz_arraylist_normalize_index(list->size, index);
   if (!_mz_arraylist_is_index_within_range(list->size, index)) {
-    ERROR("index is out of range - %d", index);
+    ERROR("index is out of range - %zu", index);
   } else {
-    for (int i = index; i < list->size - 1; i++) {
-      list->array[i] = list->array[i + 1];
-    }
+    memmove(list->array + index, list->array + index + 1, (list->size - index - 1) * sizeof(void *));
     list->array[list->size - 1] = NULL;
     list->size -= 1;
     if (!_mz_arraylist_optimize_capacity(list, list->size)) {
@@ -135,27 +196,20 @@ bool mz_arraylist_remove_at(mz_ArrayList *list, int index) {
   return result;
 }
 
-bool mz_arraylist_remove_range(mz_ArrayList *list, int from_index, int to_index) {
+bool mz_arraylist_remove_range(mz_ArrayList *list, size_t from_index, size_t to_index) {
   bool result = false;
-  //negative to positive conversion:
-  from_index = _mz_arraylist_normalize_index(list->size, from_index);
-  to_index = _mz_arraylist_normalize_index(list->size, to_index);
   if (!_mz_arraylist_is_index_within_range(list->size, from_index)) {
-    ERROR("'from' index is out of range - %d", from_index);
+    ERROR("'from' index is out of range - %zu", from_index);
   } else if (!_mz_arraylist_is_index_within_range(list->size, to_index)) {
-    ERROR("'to' index is out of range - %d", to_index);
+    ERROR("'to' index is out of range - %zu", to_index);
   } else if (from_index > to_index) {
-    ERROR("'from_index' is larger than the 'to_index' - %d > %d", from_index, to_index);
+    ERROR("'from_index' is larger than the 'to_index' - %zu > %zu", from_index, to_index);
   } else {
     //remove 3,6 from 01234567890, must result in = 012|67890 where 345 is removed
-    int range = to_index - from_index;
-    for (int i = to_index; i < list->size; i++) {
-      list->array[i - range] = list->array[i];
-    }
+    size_t range = to_index - from_index;
+    memmove(list->array + from_index, list->array + to_index, (list->size - to_index) * sizeof(void *));
     //clear end of the array
-    for (int i = list->size - 1; i >= list->size - range; i--) {
-      list->array[i] = NULL;
-    }
+    memset(list->array + list->size - range, 0, range * sizeof(void *));
     list->size -= range;
     //optimize capacity
     if (!_mz_arraylist_optimize_capacity(list, list->size)) {
@@ -167,11 +221,28 @@ bool mz_arraylist_remove_range(mz_ArrayList *list, int from_index, int to_index)
   return result;
 }
 
-bool mz_arraylist_set(mz_ArrayList *list, int index, void *element) {
+bool mz_arraylist_truncate(mz_ArrayList *list, size_t size) {
+  bool result = false;
+  if (size > list->size) {
+    ERROR("size is larger than the list - %zu > %zu", size, list->size);
+  } else {
+    //clear end of the array
+    memset(list->array + size, 0, (list->size - size) * sizeof(void *));
+    list->size = size;
+    if (!_mz_arraylist_optimize_capacity(list, list->size)) {
+      ERROR("could not optimize capacity");
+    } else {
+      result = true;
+    }
+  }
+  return result;
+}
+
+#if MZ_CHECK_POLICY == MZ_CHECK_POLICY_CHECKED
+bool mz_arraylist_set(mz_ArrayList *list, size_t index, void *element) {
   bool result = false;
-  index = _mz_arraylist_normalize_index(list->size, index);
   if (!_mz_arraylist_is_index_within_range(list->size, index)) {
-    ERROR("index is out of range - %d", index);
+    ERROR("index is out of range - %zu", index);
   } else {
     list->array[index] = element;
     result = true;
@@ -179,47 +250,85 @@ bool mz_arraylist_set(mz_ArrayList *list, int index, void *element) {
   return result;
 }
 
-void *mz_arraylist_get(mz_ArrayList *list, int index) {
-  index = _mz_arraylist_normalize_index(list->size, index);
+void *mz_arraylist_get(mz_ArrayList *list, size_t index) {
   if (!_mz_arraylist_is_index_within_range(list->size, index)) {
-    ERROR("index is out of range - %d", index);
+    ERROR("index is out of range - %zu", index);
     return NULL;
   } else {
     return list->array[index];
   }
 }
+#endif
 
-void **mz_arraylist_get_range(mz_ArrayList *list, int from_index, int to_index) {
+void **mz_arraylist_get_range(mz_ArrayList *list, size_t from_index, size_t to_index) {
   void **result = NULL;
-  from_index = _mz_arraylist_normalize_index(list->size, from_index);
-  to_index = _mz_arraylist_normalize_index(list->size, to_index);
   if (!_mz_arraylist_is_index_within_range(list->size, from_index)) {
-    ERROR("'from' index is out of range - %d", from_index);
+    ERROR("'from' index is out of range - %zu", from_index);
   } else if (!_mz_arraylist_is_index_within_range(list->size, to_index)) {
-    ERROR("'to' index is out of range - %d", to_index);
+    ERROR("'to' index is out of range - %zu", to_index);
   } else if (from_index > to_index) {
-    ERROR("'from_index' is larger than the 'to_index' - %d > %d", from_index, to_index);
+    ERROR("'from_index' is larger than the 'to_index' - %zu > %zu", from_index, to_index);
   } else {
-    int range = to_index - from_index;
+    size_t range = to_index - from_index;
     result = calloc(range, sizeof(void *));
-    for (int i = 0; i < range; i++) {
-      result[i] = list->array[i + from_index];
+    if (!result) {
+      ERROR("could not allocate memory for range");
+    } else {
+      memcpy(result, list->array + from_index, range * sizeof(void *));
     }
   }
   return result;
 }
 
+bool mz_arraylist_insert_at_relative(mz_ArrayList *list, ptrdiff_t index, void *element) {
+  return mz_arraylist_insert_at(list, _mz_arraylist_normalize_index(list->size, index), element);
+}
+
+bool mz_arraylist_remove_at_relative(mz_ArrayList *list, ptrdiff_t index) {
+  return mz_arraylist_remove_at(list, _mz_arraylist_normalize_index(list->size, index));
+}
+
+bool mz_arraylist_remove_range_relative(mz_ArrayList *list, ptrdiff_t from_index, ptrdiff_t to_index) {
+  return mz_arraylist_remove_range(list,
+                                   _mz_arraylist_normalize_index(list->size, from_index),
+                                   _mz_arraylist_normalize_index(list->size, to_index));
+}
+
+bool mz_arraylist_set_relative(mz_ArrayList *list, ptrdiff_t index, void *element) {
+  return mz_arraylist_set(list, _mz_arraylist_normalize_index(list->size, index), element);
+}
+
+void *mz_arraylist_get_relative(mz_ArrayList *list, ptrdiff_t index) {
+  return mz_arraylist_get(list, _mz_arraylist_normalize_index(list->size, index));
+}
+
+void **mz_arraylist_get_range_relative(mz_ArrayList *list, ptrdiff_t from_index, ptrdiff_t to_index) {
+  return mz_arraylist_get_range(list,
+                                _mz_arraylist_normalize_index(list->size, from_index),
+                                _mz_arraylist_normalize_index(list->size, to_index));
+}
+
+mz_ArraySlice mz_arraylist_slice(mz_ArrayList *list, size_t from_index, size_t to_index) {
+  mz_ArraySlice result = {NULL, 0};
+  if (!list) {
+    ERROR("list is null");
+  } else if (to_index > list->size) {
+    ERROR("'to' index is out of range - %zu", to_index);
+  } else if (from_index > to_index) {
+    ERROR("'from_index' is larger than the 'to_index' - %zu > %zu", from_index, to_index);
+  } else {
+    result.array = list->array + from_index;
+    result.size = to_index - from_index;
+  }
+  return result;
+}
+
 mz_ArrayList *mz_arraylist_map(mz_ArrayList *list, void *(*mz_arraylist_fn)(const void *)) {
   mz_ArrayList *result = NULL;
   if (!list) {
     ERROR("list is null");
   } else {
-    result = mz_arraylist_new(list->initial_capacity, sizeof(void *));
-    for (int i = 0; i < list->size; i++) {
-      void *r = (*mz_arraylist_fn)(list->array[i]);
-      mz_arraylist_append(result, r);
-      free(r);
-    }
+    result = mz_arrayslice_map(mz_arraylist_as_slice(list), (*mz_arraylist_fn));
   }
   return result;
 }
@@ -229,98 +338,244 @@ mz_ArrayList *mz_arraylist_filter(mz_ArrayList *list, bool (*mz_arraylist_filter
   if (!list) {
     ERROR("list is null");
   } else {
-    result = mz_arraylist_new(list->initial_capacity, sizeof(void *));
-    for (int i = 0; i < list->size; i++) {
-      if ((*mz_arraylist_filter_fn)(list->array[i])) {
-        mz_arraylist_append(result, list->array[i]);
-      }
-    }
+    result = mz_arrayslice_filter(mz_arraylist_as_slice(list), (*mz_arraylist_filter_fn));
   }
   return result;
 }
 
 size_t mz_arraylist_index_of(mz_ArrayList *list, bool (*mz_arraylist_filter_fn)(const void *)) {
-  size_t result = -1;
+  size_t result = MZ_NPOS;
   if (!list) {
     ERROR("list is null");
   } else {
-    for (int i = 0; i < list->size; i++) {
-      if ((*mz_arraylist_filter_fn)(list->array[i])) {
-        result = i;
-        break;
-      }
-    }
+    result = mz_arrayslice_index_of(mz_arraylist_as_slice(list), (*mz_arraylist_filter_fn));
   }
   return result;
 }
 
-
-void *_mz_arraylist_reduce_recur(mz_ArrayList *list, void *accl, size_t idx,
-                                 void *(*mz_arraylist_reduce_fn)(const void *, const void *)) {
-  if (idx == list->size - 1) {
-    return accl;
+void *mz_arraylist_reduce(mz_ArrayList *list, void *(*mz_arraylist_reduce_fn)(const void *, const void *)) {
+  void *result = NULL;
+  if (!list) {
+    ERROR("list is null");
   } else {
-    accl = (*mz_arraylist_reduce_fn)(accl, list->array[++idx]);
-    return _mz_arraylist_reduce_recur(list, accl, idx, (*mz_arraylist_reduce_fn));
+    result = mz_arrayslice_reduce(mz_arraylist_as_slice(list), (*mz_arraylist_reduce_fn));
   }
+  return result;
 }
 
-void *mz_arraylist_reduce(mz_ArrayList *list, void *(*mz_arraylist_reduce_fn)(const void *, const void *)) {
-  void *result = NULL;
+size_t mz_arraylist_binary_search(mz_ArrayList *list, void *element,
+                                  int (*mz_arraylist_comparator_fn)(const void *, const void *)) {
+  size_t result = MZ_NPOS;
   if (!list) {
     ERROR("list is null");
-  } else if (list->size == 1) {
-    result = list->array[0];
   } else {
-    void *accl = list->array[0];
-    result = _mz_arraylist_reduce_recur(list, accl, 0, (*mz_arraylist_reduce_fn));
+    result = mz_arrayslice_binary_search(mz_arraylist_as_slice(list), element, (*mz_arraylist_comparator_fn));
   }
   return result;
 }
 
-size_t _mz_arraylist_binary_search_recur(mz_ArrayList *list, void *element,
-                                         int (*mz_arraylist_comparator_fn)(const void *, const void *), size_t start,
-                                         size_t end) {
-  size_t len = end - start;
-  size_t mid = (int) (len / 2) + start;
-  void *current_element = list->array[mid];
-  int comparison = (*mz_arraylist_comparator_fn)(&element, &current_element);
-  if (comparison < 0) { //element < list[mid]
-    return _mz_arraylist_binary_search_recur(list, element, (*mz_arraylist_comparator_fn), start, mid);
-  } else if (comparison > 0) { // element > list[mid]
-    return _mz_arraylist_binary_search_recur(list, element, (*mz_arraylist_comparator_fn), mid, end);
+bool mz_arraylist_sort(mz_ArrayList *list, mz_ArrayListSortOption sort_option,
+                       int (*mz_arraylist_comparator_fn)(const void *, const void *)) {
+  bool result = false;
+  if (!list) {
+    ERROR("list is null");
   } else {
-    return mid;
+    result = mz_arrayslice_sort(mz_arraylist_as_slice(list), sort_option, (*mz_arraylist_comparator_fn));
   }
+  return result;
 }
 
-size_t mz_arraylist_binary_search(mz_ArrayList *list, void *element,
-                                  int (*mz_arraylist_comparator_fn)(const void *, const void *)) {
-  int result = -1;
+bool mz_arraylist_nth_element(mz_ArrayList *list, size_t n,
+                              int (*mz_arraylist_comparator_fn)(const void *, const void *)) {
+  bool result = false;
   if (!list) {
     ERROR("list is null");
   } else {
-    result = _mz_arraylist_binary_search_recur(list, element, (*mz_arraylist_comparator_fn), 0, list->size);
+    result = mz_arrayslice_nth_element(mz_arraylist_as_slice(list), n, (*mz_arraylist_comparator_fn));
   }
   return result;
 }
 
-bool mz_arraylist_sort(mz_ArrayList *list, mz_ArrayListSortOption sort_option,
-                       int (*mz_arraylist_comparator_fn)(const void *, const void *)) {
+bool mz_arraylist_partial_sort(mz_ArrayList *list, size_t k,
+                               int (*mz_arraylist_comparator_fn)(const void *, const void *)) {
   bool result = false;
   if (!list) {
     ERROR("list is null");
-  } else if (sort_option == mz_ArrayListSortOptionMerge &&
-             mergesort(list->array, list->size, sizeof(void *), (*mz_arraylist_comparator_fn)) == -1) {
+  } else {
+    result = mz_arrayslice_partial_sort(mz_arraylist_as_slice(list), k, (*mz_arraylist_comparator_fn));
+  }
+  return result;
+}
+
+mz_ArrayList *mz_arrayslice_map(mz_ArraySlice slice, void *(*mz_arraylist_fn)(const void *)) {
+  mz_ArrayList *result = mz_arraylist_new(slice.size > 0 ? slice.size : 1, sizeof(void *));
+  if (!result) {
+    ERROR("could not allocate result list");
+  } else {
+    for (size_t i = 0; i < slice.size; i++) {
+      mz_arraylist_append(result, (*mz_arraylist_fn)(slice.array[i]));
+    }
+  }
+  return result;
+}
+
+mz_ArrayList *mz_arrayslice_filter(mz_ArraySlice slice, bool (*mz_arraylist_filter_fn)(const void *)) {
+  mz_ArrayList *result = mz_arraylist_new(MZ_ARRAYLIST_INLINE_CAPACITY, sizeof(void *));
+  if (!result) {
+    ERROR("could not allocate result list");
+  } else {
+    for (size_t i = 0; i < slice.size; i++) {
+      if ((*mz_arraylist_filter_fn)(slice.array[i])) {
+        mz_arraylist_append(result, slice.array[i]);
+      }
+    }
+  }
+  return result;
+}
+
+size_t mz_arrayslice_index_of(mz_ArraySlice slice, bool (*mz_arraylist_filter_fn)(const void *)) {
+  size_t result = MZ_NPOS;
+  for (size_t i = 0; i < slice.size; i++) {
+    if ((*mz_arraylist_filter_fn)(slice.array[i])) {
+      result = i;
+      break;
+    }
+  }
+  return result;
+}
+
+void *mz_arrayslice_reduce(mz_ArraySlice slice, void *(*mz_arraylist_reduce_fn)(const void *, const void *)) {
+  void *result = NULL;
+  if (slice.size > 0) {
+    result = slice.array[0];
+    for (size_t i = 1; i < slice.size; i++) {
+      result = (*mz_arraylist_reduce_fn)(result, slice.array[i]);
+    }
+  }
+  return result;
+}
+
+size_t mz_arrayslice_binary_search(mz_ArraySlice slice, void *element,
+                                   int (*mz_arraylist_comparator_fn)(const void *, const void *)) {
+  size_t result = MZ_NPOS;
+  //search the half-open range [start, end)
+  size_t start = 0;
+  size_t end = slice.size;
+  while (start < end) {
+    size_t mid = start + (end - start) / 2;
+    void *current_element = slice.array[mid];
+    int comparison = (*mz_arraylist_comparator_fn)(&element, &current_element);
+    if (comparison < 0) { //element < list[mid]
+      end = mid;
+    } else if (comparison > 0) { // element > list[mid]
+      start = mid + 1;
+    } else {
+      result = mid;
+      break;
+    }
+  }
+  return result;
+}
+
+bool mz_arrayslice_sort(mz_ArraySlice slice, mz_ArrayListSortOption sort_option,
+                        int (*mz_arraylist_comparator_fn)(const void *, const void *)) {
+  bool result = false;
+  if (sort_option == mz_ArrayListSortOptionMerge &&
+      mergesort(slice.array, slice.size, sizeof(void *), (*mz_arraylist_comparator_fn)) == -1) {
     ERROR("merge sort failed");
   } else if (sort_option == mz_ArrayListSortOptionHeap &&
-             heapsort(list->array, list->size, sizeof(void *), (*mz_arraylist_comparator_fn)) == -1) {
+             heapsort(slice.array, slice.size, sizeof(void *), (*mz_arraylist_comparator_fn)) == -1) {
     ERROR("heap sort failed");
   } else if (sort_option == mz_ArrayListSortOptionQuick) {
-    qsort(list->array, list->size, sizeof(void *), (*mz_arraylist_comparator_fn));
+    qsort(slice.array, slice.size, sizeof(void *), (*mz_arraylist_comparator_fn));
     result = true;
   } else {
     result = true;
   }
   return result;
 }
+
+void _mz_arrayslice_swap(void **array, size_t i, size_t j) {
+  void *element = array[i];
+  array[i] = array[j];
+  array[j] = element;
+}
+
+//introselect: quickselect on median-of-three pivots. once the depth budget is spent the
+//remaining range is sorted instead, which bounds the worst case at O(n log n)
+void _mz_arrayslice_select(void **array, size_t size, size_t n,
+                           int (*mz_arraylist_comparator_fn)(const void *, const void *)) {
+  size_t low = 0;
+  size_t high = size;
+  size_t budget = 2 * (size_t) (64 - __builtin_clzll(size));
+  while (high - low > 16) {
+    if (budget-- == 0) {
+      qsort(array + low, high - low, sizeof(void *), (*mz_arraylist_comparator_fn));
+      return;
+    }
+    size_t mid = low + (high - low - 1) / 2;
+    if ((*mz_arraylist_comparator_fn)(&array[mid], &array[low]) < 0) {
+      _mz_arrayslice_swap(array, mid, low);
+    }
+    if ((*mz_arraylist_comparator_fn)(&array[high - 1], &array[mid]) < 0) {
+      _mz_arrayslice_swap(array, high - 1, mid);
+      if ((*mz_arraylist_comparator_fn)(&array[mid], &array[low]) < 0) {
+        _mz_arrayslice_swap(array, mid, low);
+      }
+    }
+    //hoare partition: afterwards [low, j] holds no greater and (j, high) no smaller element than pivot
+    void *pivot = array[mid];
+    size_t i = low;
+    size_t j = high - 1;
+    for (;;) {
+      while ((*mz_arraylist_comparator_fn)(&array[i], &pivot) < 0) {
+        i++;
+      }
+      while ((*mz_arraylist_comparator_fn)(&pivot, &array[j]) < 0) {
+        j--;
+      }
+      if (i >= j) {
+        break;
+      }
+      _mz_arrayslice_swap(array, i++, j--);
+    }
+    if (n <= j) {
+      high = j + 1;
+    } else {
+      low = j + 1;
+    }
+  }
+  //insertion sort the small range that is left
+  for (size_t i = low + 1; i < high; i++) {
+    for (size_t j = i; j > low && (*mz_arraylist_comparator_fn)(&array[j], &array[j - 1]) < 0; j--) {
+      _mz_arrayslice_swap(array, j, j - 1);
+    }
+  }
+}
+
+bool mz_arrayslice_nth_element(mz_ArraySlice slice, size_t n,
+                               int (*mz_arraylist_comparator_fn)(const void *, const void *)) {
+  bool result = false;
+  if (n >= slice.size) {
+    ERROR("index is out of range - %zu", n);
+  } else {
+    _mz_arrayslice_select(slice.array, slice.size, n, (*mz_arraylist_comparator_fn));
+    result = true;
+  }
+  return result;
+}
+
+bool mz_arrayslice_partial_sort(mz_ArraySlice slice, size_t k,
+                                int (*mz_arraylist_comparator_fn)(const void *, const void *)) {
+  if (k > slice.size) {
+    k = slice.size;
+  }
+  if (k > 0) {
+    //select the k smallest into the front, then sort just those
+    if (k < slice.size) {
+      _mz_arrayslice_select(slice.array, slice.size, k - 1, (*mz_arraylist_comparator_fn));
+    }
+    qsort(slice.array, k, sizeof(void *), (*mz_arraylist_comparator_fn));
+  }
+  return true;
+}
@@ -3,16 +3,32 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include "type.h"
 
+//number of slots stored inside the list itself before spilling to the heap
+#ifndef MZ_ARRAYLIST_INLINE_CAPACITY
+#define MZ_ARRAYLIST_INLINE_CAPACITY 8
+#endif
+
+//array points at inline_array while capacity fits in it, so a list must not be
+//copied by value, only moved with mz_arraylist_move into an uninitialized or destroyed list
 typedef struct mz_ArrayList {
   size_t initial_capacity;
   size_t element_size;
-  int size;
-  int capacity;
+  size_t size;
+  size_t capacity;
   void **array;
+  void *inline_array[MZ_ARRAYLIST_INLINE_CAPACITY];
 } mz_ArrayList;
 
+//a window into the elements of a list. the elements are borrowed: a slice is
+//invalidated by any operation that changes the size or capacity of its list
+typedef struct mz_ArraySlice {
+  void **array;
+  size_t size;
+} mz_ArraySlice;
+
 typedef enum mz_ArrayListSortOption {
   mz_ArrayListSortOptionMerge,
   mz_ArrayListSortOptionHeap,
@@ -31,21 +47,53 @@ mz_ArrayList *mz_arraylist_new(size_t initial_capacity, size_t element_size);
 
 void mz_arraylist_free(mz_ArrayList *list);
 
+//initializes an embedded or stack allocated list, release it with mz_arraylist_destroy
+bool mz_arraylist_init(mz_ArrayList *list, size_t initial_capacity, size_t element_size);
+
+void mz_arraylist_destroy(mz_ArrayList *list);
+
+//destination is overwritten without being released, so it must be uninitialized or already
+//destroyed with mz_arraylist_destroy. source is left empty and can be reused
+void mz_arraylist_move(mz_ArrayList *destination, mz_ArrayList *source);
+
+bool mz_arraylist_reserve(mz_ArrayList *list, size_t capacity);
+
 bool mz_arraylist_append(mz_ArrayList *list, void *element);
 
-bool mz_arraylist_append_range(mz_ArrayList *list, void **elements, unsigned int len);
+bool mz_arraylist_append_range(mz_ArrayList *list, void **elements, size_t len);
+
+bool mz_arraylist_insert_at(mz_ArrayList *list, size_t index, void *element);
 
-bool mz_arraylist_insert_at(mz_ArrayList *list, int index, void *element);
+bool mz_arraylist_remove_at(mz_ArrayList *list, size_t index);
 
-bool mz_arraylist_remove_at(mz_ArrayList *list, int index);
+bool mz_arraylist_remove_range(mz_ArrayList *list, size_t from_index, size_t to_index);
 
-bool mz_arraylist_remove_range(mz_ArrayList *list, int from_index, int to_index);
+//removes the elements from size on, shrinking the capacity once
+bool mz_arraylist_truncate(mz_ArrayList *list, size_t size);
+
+#if MZ_CHECK_POLICY == MZ_CHECK_POLICY_CHECKED
+bool mz_arraylist_set(mz_ArrayList *list, size_t index, void *element);
+
+void *mz_arraylist_get(mz_ArrayList *list, size_t index);
+#endif
 
-bool mz_arraylist_set(mz_ArrayList *list, int index, void *element);
+void **mz_arraylist_get_range(mz_ArrayList *list, size_t from_index, size_t to_index);
 
-void *mz_arraylist_get(mz_ArrayList *list, int index);
+//relative variants: a negative index counts from the back of the list (-1 is the last element)
 
-void **mz_arraylist_get_range(mz_ArrayList *list, int from_index, int to_index);
+bool mz_arraylist_insert_at_relative(mz_ArrayList *list, ptrdiff_t index, void *element);
+
+bool mz_arraylist_remove_at_relative(mz_ArrayList *list, ptrdiff_t index);
+
+bool mz_arraylist_remove_range_relative(mz_ArrayList *list, ptrdiff_t from_index, ptrdiff_t to_index);
+
+bool mz_arraylist_set_relative(mz_ArrayList *list, ptrdiff_t index, void *element);
+
+void *mz_arraylist_get_relative(mz_ArrayList *list, ptrdiff_t index);
+
+void **mz_arraylist_get_range_relative(mz_ArrayList *list, ptrdiff_t from_index, ptrdiff_t to_index);
+
+mz_ArraySlice mz_arraylist_slice(mz_ArrayList *list, size_t from_index, size_t to_index);
 
 mz_ArrayList *mz_arraylist_map(mz_ArrayList *list, void *(*mz_arraylist_fn)(const void *));
 
@@ -61,15 +109,73 @@ size_t mz_arraylist_binary_search(mz_ArrayList *list, void *element,
 bool mz_arraylist_sort(mz_ArrayList *list, mz_ArrayListSortOption sort_option,
                        int (*mz_arraylist_comparator_fn)(const void *, const void *));
 
+bool mz_arraylist_nth_element(mz_ArrayList *list, size_t n,
+                              int (*mz_arraylist_comparator_fn)(const void *, const void *));
+
+bool mz_arraylist_partial_sort(mz_ArrayList *list, size_t k,
+                               int (*mz_arraylist_comparator_fn)(const void *, const void *));
+
+mz_ArrayList *mz_arrayslice_map(mz_ArraySlice slice, void *(*mz_arraylist_fn)(const void *));
+
+mz_ArrayList *mz_arrayslice_filter(mz_ArraySlice slice, bool (*mz_arraylist_filter_fn)(const void *));
+
+size_t mz_arrayslice_index_of(mz_ArraySlice slice, bool (*mz_arraylist_filter_fn)(const void *));
+
+void *mz_arrayslice_reduce(mz_ArraySlice slice, void *(*mz_arraylist_reduce_fn)(const void *, const void *));
+
+size_t mz_arrayslice_binary_search(mz_ArraySlice slice, void *element,
+                                   int (*mz_arraylist_comparator_fn)(const void *, const void *));
+
+//sorts the borrowed elements in place, i.e. the corresponding range of the list
+bool mz_arrayslice_sort(mz_ArraySlice slice, mz_ArrayListSortOption sort_option,
+                        int (*mz_arraylist_comparator_fn)(const void *, const void *));
+
+//moves the element that sorting would put at index n there, with no greater element
+//before it and no smaller one after it, in O(n) on average
+bool mz_arrayslice_nth_element(mz_ArraySlice slice, size_t n,
+                               int (*mz_arraylist_comparator_fn)(const void *, const void *));
+
+//sorts only the k smallest elements into the front, the order of the rest is unspecified
+bool mz_arrayslice_partial_sort(mz_ArraySlice slice, size_t k,
+                                int (*mz_arraylist_comparator_fn)(const void *, const void *));
+
+//for loops that already validated their indices: index must be below the size, and append
+//needs capacity set aside with mz_arraylist_reserve. nothing is checked or logged
+static inline void *mz_arraylist_get_unchecked(mz_ArrayList *list, size_t index) {
+  return list->array[index];
+}
+
+static inline void mz_arraylist_set_unchecked(mz_ArrayList *list, size_t index, void *element) {
+  list->array[index] = element;
+}
+
+static inline void mz_arraylist_append_unchecked(mz_ArrayList *list, void *element) {
+  list->array[list->size++] = element;
+}
+
+#if MZ_CHECK_POLICY != MZ_CHECK_POLICY_CHECKED
+//without error reporting get and set are small enough to inline
+static inline bool mz_arraylist_set(mz_ArrayList *list, size_t index, void *element) {
+  (void) _MZ_CHECK(index < list->size);
+  mz_arraylist_set_unchecked(list, index, element);
+  return true;
+}
+
+static inline void *mz_arraylist_get(mz_ArrayList *list, size_t index) {
+  (void) _MZ_CHECK(index < list->size);
+  return mz_arraylist_get_unchecked(list, index);
+}
+#endif
+
 static inline bool mz_arraylist_insert_first(mz_ArrayList *list, void *element) {
   return mz_arraylist_insert_at(list, 0, element);
 }
 
 static inline bool mz_arraylist_remove_last(mz_ArrayList *list) {
-  return mz_arraylist_remove_at(list, -1);
+  return mz_arraylist_remove_at_relative(list, -1);
 }
 
-static inline int mz_arraylist_size(mz_ArrayList *list) {
+static inline size_t mz_arraylist_size(mz_ArrayList *list) {
   return list->size;
 }
 
@@ -81,9 +187,30 @@ static inline bool mz_arraylist_is_empty(mz_ArrayList *list) {
   return list->size == 0;
 }
 
-#define mzm_arraylist_foreach(L, E, I) void * E = L != NULL && L->size > 0 ? L->array[0] : NULL;\
-                                        int I = 0;\
-                                        for (; I < L->size; E = L->array[++I])
+static inline bool mz_arraylist_is_inline(mz_ArrayList *list) {
+  return list->array == list->inline_array;
+}
+
+static inline mz_ArraySlice mz_arraylist_as_slice(mz_ArrayList *list) {
+  mz_ArraySlice slice = {list->array, list->size};
+  return slice;
+}
+
+static inline mz_ArraySlice mz_arrayslice_sub(mz_ArraySlice slice, size_t from_index, size_t to_index) {
+  //clamps the window to the slice
+  to_index = to_index < slice.size ? to_index : slice.size;
+  from_index = from_index < to_index ? from_index : to_index;
+  mz_ArraySlice result = {slice.array + from_index, to_index - from_index};
+  return result;
+}
+
+#define mzm_arraylist_foreach(L, E, I) void * E = NULL;\
+                                        size_t I = 0;\
+                                        for (; I < L->size && ((E = L->array[I]) || 1); ++I)
+
+#define mzm_arrayslice_foreach(S, E, I) void * E = NULL;\
+                                        size_t I = 0;\
+                                        for (; I < (S).size && ((E = (S).array[I]) || 1); ++I)
 
 
 #endif
@@ -0,0 +1,577 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <sched.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include "asynclog.h"
+#include "logger.h"
+#include "type.h"
+
+#define _MZ_ASYNCLOG_BATCH_BYTES 65536
+
+//a conversion of the format, flags, width and precision as written. a width or precision
+//of * takes an argument
+typedef struct _mz_AsyncLogConversion {
+  const char *start;
+  const char *end;
+  const char *flags;
+  size_t flags_len;
+  const char *width;
+  size_t width_len;
+  const char *precision;
+  size_t precision_len;
+  char length[3];
+  char conversion;
+} _mz_AsyncLogConversion;
+
+atomic_int _mz_asynclog_running;
+pthread_t _mz_asynclog_writer;
+mz_AsyncLogOptions _mz_asynclog_options;
+_Atomic(mz_AsyncLogBuffer *) _mz_asynclog_buffers;
+atomic_size_t _mz_asynclog_submitted;
+atomic_size_t _mz_asynclog_written;
+atomic_size_t _mz_asynclog_dropped_total;
+pthread_once_t _mz_asynclog_once = PTHREAD_ONCE_INIT;
+pthread_key_t _mz_asynclog_key;
+_Thread_local mz_AsyncLogBuffer *_mz_asynclog_buffer;
+
+//only touched by the thread draining the rings, the writer or the thread stopping it
+char _mz_asynclog_batch[_MZ_ASYNCLOG_BATCH_BYTES];
+size_t _mz_asynclog_batch_size;
+size_t _mz_asynclog_batch_records;
+
+//parses the conversion starting at the % of format, false for one the writer can not format
+bool _mz_asynclog_parse(const char *format, _mz_AsyncLogConversion *conversion) {
+  const char *p = format + 1;
+  conversion->start = format;
+  conversion->flags = p;
+  while (*p && strchr("-+ #0'", *p)) {
+    p++;
+  }
+  conversion->flags_len = p - conversion->flags;
+  conversion->width = p;
+  if (*p == '*') {
+    p++;
+  } else {
+    while (*p >= '0' && *p <= '9') {
+      p++;
+    }
+  }
+  conversion->width_len = p - conversion->width;
+  conversion->precision = p;
+  if (*p == '.') {
+    p++;
+    if (*p == '*') {
+      p++;
+    } else {
+      while (*p >= '0' && *p <= '9') {
+        p++;
+      }
+    }
+  }
+  conversion->precision_len = p - conversion->precision;
+  size_t length = 0;
+  while (*p && strchr("hlLqjzt", *p) && length < 2) {
+    conversion->length[length++] = *p++;
+  }
+  conversion->length[length] = '\0';
+  conversion->conversion = *p;
+  conversion->end = *p ? p + 1 : p;
+  if (!*p || !strchr("diouxXcsfFeEgGaAp%", *p)) {
+    return false;
+  }
+  //wide characters and strings are not copied
+  return !(conversion->length[0] == 'l' && (*p == 'c' || *p == 's'));
+}
+
+//the arguments a conversion reads, or 0 for %%
+size_t _mz_asynclog_arg_count(const _mz_AsyncLogConversion *conversion) {
+  if (conversion->conversion == '%') {
+    return 0;
+  }
+  return 1 + (conversion->width_len == 1 && conversion->width[0] == '*') +
+         (conversion->precision_len == 2 && conversion->precision[1] == '*');
+}
+
+intmax_t _mz_asynclog_read_signed(const char *length, va_list *args) {
+  if (strcmp(length, "hh") == 0) {
+    return (signed char) va_arg(*args, int);
+  } else if (strcmp(length, "h") == 0) {
+    return (short) va_arg(*args, int);
+  } else if (strcmp(length, "l") == 0) {
+    return va_arg(*args, long);
+  } else if (strcmp(length, "ll") == 0 || strcmp(length, "q") == 0) {
+    return va_arg(*args, long long);
+  } else if (strcmp(length, "z") == 0) {
+    return va_arg(*args, ssize_t);
+  } else if (strcmp(length, "j") == 0) {
+    return va_arg(*args, intmax_t);
+  } else if (strcmp(length, "t") == 0) {
+    return va_arg(*args, ptrdiff_t);
+  }
+  return va_arg(*args, int);
+}
+
+uintmax_t _mz_asynclog_read_unsigned(const char *length, va_list *args) {
+  if (strcmp(length, "hh") == 0) {
+    return (unsigned char) va_arg(*args, unsigned int);
+  } else if (strcmp(length, "h") == 0) {
+    return (unsigned short) va_arg(*args, unsigned int);
+  } else if (strcmp(length, "l") == 0) {
+    return va_arg(*args, unsigned long);
+  } else if (strcmp(length, "ll") == 0 || strcmp(length, "q") == 0) {
+    return va_arg(*args, unsigned long long);
+  } else if (strcmp(length, "z") == 0) {
+    return va_arg(*args, size_t);
+  } else if (strcmp(length, "j") == 0) {
+    return va_arg(*args, uintmax_t);
+  } else if (strcmp(length, "t") == 0) {
+    return (size_t) va_arg(*args, ptrdiff_t);
+  }
+  return va_arg(*args, unsigned int);
+}
+
+//reads the arguments of format into the record without formatting them. strings are the
+//only arguments that are copied, the caller may free them as soon as this returns
+void _mz_asynclog_capture(mz_AsyncLogRecord *record, mz_AsyncLogLevel level, const char *file, int line,
+                          int error_number, const char *format, va_list *args) {
+  record->level = level;
+  record->file = file;
+  record->line = line;
+  record->error_number = error_number;
+  record->format = format;
+  record->arg_count = 0;
+  record->string_size = 0;
+  _mz_AsyncLogConversion conversion;
+  for (const char *p = strchr(format, '%'); p; p = strchr(conversion.end, '%')) {
+    //the writer prints the format as is from the first conversion it has no arguments for
+    if (!_mz_asynclog_parse(p, &conversion) ||
+        record->arg_count + _mz_asynclog_arg_count(&conversion) > MZ_ASYNCLOG_MAX_ARGS) {
+      break;
+    }
+    if (conversion.conversion == '%') {
+      continue;
+    }
+    if (conversion.width_len == 1 && conversion.width[0] == '*') {
+      record->args[record->arg_count++].i = va_arg(*args, int);
+    }
+    if (conversion.precision_len == 2 && conversion.precision[1] == '*') {
+      record->args[record->arg_count++].i = va_arg(*args, int);
+    }
+    mz_AsyncLogArg *arg = &record->args[record->arg_count++];
+    switch (conversion.conversion) {
+      case 'd':
+      case 'i':
+        arg->i = _mz_asynclog_read_signed(conversion.length, args);
+        break;
+      case 'c':
+        arg->i = va_arg(*args, int);
+        break;
+      case 'o':
+      case 'u':
+      case 'x':
+      case 'X':
+        arg->u = _mz_asynclog_read_unsigned(conversion.length, args);
+        break;
+      case 'p':
+        arg->p = va_arg(*args, void *);
+        break;
+      case 's': {
+        const char *string = va_arg(*args, const char *);
+        string = string ? string : "(null)";
+        size_t room = MZ_ASYNCLOG_STRING_BYTES - record->string_size;
+        if (room == 0) {
+          //the last byte is the terminator of the last string copied
+          arg->string_offset = MZ_ASYNCLOG_STRING_BYTES - 1;
+        } else {
+          size_t len = strnlen(string, room - 1);
+          memcpy(record->strings + record->string_size, string, len);
+          record->strings[record->string_size + len] = '\0';
+          arg->string_offset = record->string_size;
+          record->string_size += len + 1;
+        }
+        break;
+      }
+      default:
+        arg->d = conversion.length[0] == 'L' ? (double) va_arg(*args, long double) : va_arg(*args, double);
+        break;
+    }
+  }
+}
+
+//appends up to len bytes of text to out, which keeps room for the terminator
+size_t _mz_asynclog_append(char *out, size_t len, size_t used, const char *text, size_t text_len) {
+  size_t room = len - 1 - used;
+  text_len = text_len < room ? text_len : room;
+  memcpy(out + used, text, text_len);
+  out[used + text_len] = '\0';
+  return used + text_len;
+}
+
+size_t _mz_asynclog_appended(size_t len, size_t used, int written) {
+  if (written < 0) {
+    return used;
+  }
+  return used + (size_t) written < len - 1 ? used + (size_t) written : len - 1;
+}
+
+//formats one conversion with the arguments the record captured for it
+size_t _mz_asynclog_format_conversion(const mz_AsyncLogRecord *record, const _mz_AsyncLogConversion *conversion,
+                                      const mz_AsyncLogArg *args, char *out, size_t len, size_t used) {
+  char spec[48];
+  size_t spec_len = 0;
+  spec[spec_len++] = '%';
+  if (conversion->flags_len > 8 || conversion->width_len > 10 || conversion->precision_len > 10) {
+    //longer than any spec the writer builds, so it goes out as it is
+    return _mz_asynclog_append(out, len, used, conversion->start, conversion->end - conversion->start);
+  }
+  memcpy(spec + spec_len, conversion->flags, conversion->flags_len);
+  spec_len += conversion->flags_len;
+  if (conversion->width_len == 1 && conversion->width[0] == '*') {
+    spec_len += snprintf(spec + spec_len, sizeof(spec) - spec_len, "%d", (int) (args++)->i);
+  } else {
+    memcpy(spec + spec_len, conversion->width, conversion->width_len);
+    spec_len += conversion->width_len;
+  }
+  if (conversion->precision_len == 2 && conversion->precision[1] == '*') {
+    spec_len += snprintf(spec + spec_len, sizeof(spec) - spec_len, ".%d", (int) (args++)->i);
+  } else {
+    memcpy(spec + spec_len, conversion->precision, conversion->precision_len);
+    spec_len += conversion->precision_len;
+  }
+  int written = 0;
+  switch (conversion->conversion) {
+    case 'd':
+    case 'i':
+    case 'o':
+    case 'u':
+    case 'x':
+    case 'X':
+      spec[spec_len++] = 'j';
+      spec[spec_len++] = conversion->conversion;
+      spec[spec_len] = '\0';
+      if (conversion->conversion == 'd' || conversion->conversion == 'i') {
+        written = snprintf(out + used, len - used, spec, args->i);
+      } else {
+        written = snprintf(out + used, len - used, spec, args->u);
+      }
+      break;
+    case 'c':
+      spec[spec_len++] = 'c';
+      spec[spec_len] = '\0';
+      written = snprintf(out + used, len - used, spec, (int) args->i);
+      break;
+    case 'p':
+      spec[spec_len++] = 'p';
+      spec[spec_len] = '\0';
+      written = snprintf(out + used, len - used, spec, args->p);
+      break;
+    case 's':
+      spec[spec_len++] = 's';
+      spec[spec_len] = '\0';
+      written = snprintf(out + used, len - used, spec, record->strings + args->string_offset);
+      break;
+    default:
+      spec[spec_len++] = conversion->conversion;
+      spec[spec_len] = '\0';
+      written = snprintf(out + used, len - used, spec, args->d);
+      break;
+  }
+  return _mz_asynclog_appended(len, used, written);
+}
+
+size_t mz_asynclog_format(const mz_AsyncLogRecord *record, char *out, size_t len) {
+  if (len < 2) {
+    return 0;
+  }
+  //the body is formatted into len - 1 bytes so the newline always fits
+  size_t body_len = len - 1;
+  const char *error = record->error_number == 0 ? "None" : strerror(record->error_number);
+  int written = 0;
+  switch (record->level) {
+    case mz_AsyncLogLevelError:
+      written = snprintf(out, body_len, "[ERROR] (%s:%d: errno: %s) ", record->file, record->line, error);
+      break;
+    case mz_AsyncLogLevelWarn:
+      written = snprintf(out, body_len, "[WARN] (%s:%d: errno: %s) ", record->file, record->line, error);
+      break;
+    case mz_AsyncLogLevelInfo:
+      written = snprintf(out, body_len, "[INFO] (%s:%d:) ", record->file, record->line);
+      break;
+    default:
+      written = snprintf(out, body_len, "[DEBUG] %s:%d: ", record->file, record->line);
+      break;
+  }
+  size_t used = _mz_asynclog_appended(body_len, 0, written);
+  size_t arg = 0;
+  const char *p = record->format;
+  _mz_AsyncLogConversion conversion;
+  for (const char *next = strchr(p, '%'); next; next = strchr(p, '%')) {
+    used = _mz_asynclog_append(out, body_len, used, p, next - p);
+    bool parsed = _mz_asynclog_parse(next, &conversion);
+    size_t count = _mz_asynclog_arg_count(&conversion);
+    if (!parsed || arg + count > record->arg_count) {
+      //capture stopped here, the rest of the format goes out as it is
+      p = next;
+      break;
+    }
+    if (conversion.conversion == '%') {
+      used = _mz_asynclog_append(out, body_len, used, "%", 1);
+    } else {
+      used = _mz_asynclog_format_conversion(record, &conversion, record->args + arg, out, body_len, used);
+    }
+    arg += count;
+    p = conversion.end;
+  }
+  used = _mz_asynclog_append(out, body_len, used, p, strlen(p));
+  out[used++] = '\n';
+  out[used] = '\0';
+  return used;
+}
+
+void _mz_asynclog_write(int fd, const char *data, size_t len) {
+  while (len > 0) {
+    ssize_t written = write(fd, data, len);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      //nowhere left to report it
+      break;
+    }
+    data += written;
+    len -= (size_t) written;
+  }
+}
+
+void _mz_asynclog_batch_write() {
+  if (_mz_asynclog_batch_size > 0) {
+    _mz_asynclog_write(_mz_asynclog_options.fd, _mz_asynclog_batch, _mz_asynclog_batch_size);
+  }
+  atomic_fetch_add_explicit(&_mz_asynclog_written, _mz_asynclog_batch_records, memory_order_release);
+  _mz_asynclog_batch_size = 0;
+  _mz_asynclog_batch_records = 0;
+}
+
+void _mz_asynclog_batch_record(const mz_AsyncLogRecord *record) {
+  if (_MZ_ASYNCLOG_BATCH_BYTES - _mz_asynclog_batch_size <= MZ_ASYNCLOG_LINE_BYTES) {
+    _mz_asynclog_batch_write();
+  }
+  _mz_asynclog_batch_size += mz_asynclog_format(record, _mz_asynclog_batch + _mz_asynclog_batch_size,
+                                                MZ_ASYNCLOG_LINE_BYTES);
+}
+
+//reports the records a buffer dropped since the last report
+void _mz_asynclog_batch_drops(mz_AsyncLogBuffer *buffer) {
+  size_t dropped = atomic_load_explicit(&buffer->dropped, memory_order_relaxed);
+  size_t rate_limited = atomic_load_explicit(&buffer->rate_limited, memory_order_relaxed);
+  if (dropped != buffer->reported_dropped || rate_limited != buffer->reported_rate_limited) {
+    if (_MZ_ASYNCLOG_BATCH_BYTES - _mz_asynclog_batch_size <= MZ_ASYNCLOG_LINE_BYTES) {
+      _mz_asynclog_batch_write();
+    }
+    int written = snprintf(_mz_asynclog_batch + _mz_asynclog_batch_size, MZ_ASYNCLOG_LINE_BYTES,
+                           "[WARN] (asynclog) dropped %zu records of a full ring, %zu over the rate limit\n",
+                           dropped - buffer->reported_dropped, rate_limited - buffer->reported_rate_limited);
+    _mz_asynclog_batch_size = _mz_asynclog_appended(MZ_ASYNCLOG_LINE_BYTES, 0, written) + _mz_asynclog_batch_size;
+    buffer->reported_dropped = dropped;
+    buffer->reported_rate_limited = rate_limited;
+  }
+}
+
+//formats every record waiting in the rings into batched writes, returns how many there were.
+//only one thread drains at a time
+size_t _mz_asynclog_drain() {
+  size_t drained = 0;
+  mz_AsyncLogBuffer *previous = NULL;
+  mz_AsyncLogBuffer *buffer = atomic_load_explicit(&_mz_asynclog_buffers, memory_order_acquire);
+  while (buffer) {
+    mz_AsyncLogBuffer *next = buffer->next;
+    //read before the tail, a thread does not log after it abandons its buffer
+    bool abandoned = atomic_load_explicit(&buffer->abandoned, memory_order_acquire);
+    size_t head = atomic_load_explicit(&buffer->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&buffer->tail, memory_order_acquire);
+    for (; head != tail; head++) {
+      _mz_asynclog_batch_record(&buffer->records[head & (MZ_ASYNCLOG_RING_SIZE - 1)]);
+      _mz_asynclog_batch_records++;
+      drained++;
+    }
+    atomic_store_explicit(&buffer->head, head, memory_order_release);
+    _mz_asynclog_batch_drops(buffer);
+    bool unlinked = false;
+    if (abandoned) {
+      //threads only push at the head of the list, so any other buffer can be unlinked
+      if (previous) {
+        previous->next = next;
+        unlinked = true;
+      } else {
+        mz_AsyncLogBuffer *expected = buffer;
+        unlinked = atomic_compare_exchange_strong(&_mz_asynclog_buffers, &expected, next);
+      }
+    }
+    if (unlinked) {
+      free(buffer);
+    } else {
+      previous = buffer;
+    }
+    buffer = next;
+  }
+  _mz_asynclog_batch_write();
+  return drained;
+}
+
+void *_mz_asynclog_run(void *unused) {
+  struct timespec idle = {
+      _mz_asynclog_options.idle_microseconds / 1000000,
+      (long) (_mz_asynclog_options.idle_microseconds % 1000000) * 1000
+  };
+  while (atomic_load_explicit(&_mz_asynclog_running, memory_order_acquire)) {
+    if (_mz_asynclog_drain() == 0) {
+      nanosleep(&idle, NULL);
+    }
+  }
+  while (_mz_asynclog_drain() > 0) {
+  }
+  return NULL;
+}
+
+void _mz_asynclog_abandon(void *value) {
+  mz_AsyncLogBuffer *buffer = value;
+  _mz_asynclog_buffer = NULL;
+  atomic_store_explicit(&buffer->abandoned, true, memory_order_release);
+}
+
+void _mz_asynclog_create_key() {
+  pthread_key_create(&_mz_asynclog_key, _mz_asynclog_abandon);
+}
+
+mz_AsyncLogBuffer *_mz_asynclog_thread_buffer() {
+  if (!_mz_asynclog_buffer) {
+    pthread_once(&_mz_asynclog_once, _mz_asynclog_create_key);
+    mz_AsyncLogBuffer *buffer = NULL;
+    if (posix_memalign((void **) &buffer, MZ_CACHE_LINE_SIZE, sizeof(mz_AsyncLogBuffer)) != 0) {
+      return NULL;
+    }
+    memset(buffer, 0, offsetof(mz_AsyncLogBuffer, records));
+    atomic_init(&buffer->abandoned, false);
+    atomic_init(&buffer->dropped, 0);
+    atomic_init(&buffer->rate_limited, 0);
+    atomic_init(&buffer->head, 0);
+    atomic_init(&buffer->tail, 0);
+    buffer->next = atomic_load_explicit(&_mz_asynclog_buffers, memory_order_relaxed);
+    while (!atomic_compare_exchange_weak_explicit(&_mz_asynclog_buffers, &buffer->next, buffer,
+                                                  memory_order_release, memory_order_relaxed)) {
+    }
+    pthread_setspecific(_mz_asynclog_key, buffer);
+    _mz_asynclog_buffer = buffer;
+  }
+  return _mz_asynclog_buffer;
+}
+
+//false once the thread logged max_records_per_second records in the current second
+bool _mz_asynclog_within_rate(mz_AsyncLogBuffer *buffer) {
+  size_t limit = _mz_asynclog_options.max_records_per_second;
+  if (limit == 0) {
+    return true;
+  }
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  if (now.tv_sec != buffer->window) {
+    buffer->window = now.tv_sec;
+    buffer->window_count = 0;
+  }
+  return buffer->window_count++ < limit;
+}
+
+//formats and writes the record on the calling thread
+void _mz_asynclog_log_now(mz_AsyncLogLevel level, const char *file, int line, int error_number,
+                          const char *format, va_list *args) {
+  mz_AsyncLogRecord record;
+  char out[MZ_ASYNCLOG_LINE_BYTES];
+  _mz_asynclog_capture(&record, level, file, line, error_number, format, args);
+  size_t len = mz_asynclog_format(&record, out, sizeof(out));
+  fwrite(out, 1, len, stderr);
+}
+
+void mz_asynclog_log(mz_AsyncLogLevel level, const char *file, int line, int error_number, const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+  mz_AsyncLogBuffer *buffer = NULL;
+  if (!atomic_load_explicit(&_mz_asynclog_running, memory_order_acquire) || !(buffer = _mz_asynclog_thread_buffer())) {
+    _mz_asynclog_log_now(level, file, line, error_number, format, &args);
+  } else if (!_mz_asynclog_within_rate(buffer)) {
+    atomic_fetch_add_explicit(&buffer->rate_limited, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&_mz_asynclog_dropped_total, 1, memory_order_relaxed);
+  } else {
+    size_t tail = atomic_load_explicit(&buffer->tail, memory_order_relaxed);
+    bool full = tail - buffer->cached_head == MZ_ASYNCLOG_RING_SIZE;
+    while (full) {
+      buffer->cached_head = atomic_load_explicit(&buffer->head, memory_order_acquire);
+      full = tail - buffer->cached_head == MZ_ASYNCLOG_RING_SIZE;
+      if (!full || _mz_asynclog_options.policy == mz_AsyncLogPolicyDrop ||
+          !atomic_load_explicit(&_mz_asynclog_running, memory_order_acquire)) {
+        break;
+      }
+      sched_yield();
+    }
+    if (!full) {
+      _mz_asynclog_capture(&buffer->records[tail & (MZ_ASYNCLOG_RING_SIZE - 1)], level, file, line, error_number,
+                           format, &args);
+      //counted before it is published, so written never passes submitted
+      atomic_fetch_add_explicit(&_mz_asynclog_submitted, 1, memory_order_relaxed);
+      atomic_store_explicit(&buffer->tail, tail + 1, memory_order_release);
+    } else if (_mz_asynclog_options.policy == mz_AsyncLogPolicyBlock) {
+      //the writer stopped while the thread was waiting for it
+      _mz_asynclog_log_now(level, file, line, error_number, format, &args);
+    } else {
+      atomic_fetch_add_explicit(&buffer->dropped, 1, memory_order_relaxed);
+      atomic_fetch_add_explicit(&_mz_asynclog_dropped_total, 1, memory_order_relaxed);
+    }
+  }
+  va_end(args);
+}
+
+bool mz_asynclog_start(const mz_AsyncLogOptions *options) {
+  bool result = false;
+  mz_AsyncLogOptions defaults = {STDERR_FILENO, mz_AsyncLogPolicyDrop, 0, 1000};
+  if (atomic_load(&_mz_asynclog_running)) {
+    ERROR("asynclog is already started");
+  } else {
+    _mz_asynclog_options = options ? *options : defaults;
+    atomic_store(&_mz_asynclog_dropped_total, 0);
+    atomic_store(&_mz_asynclog_running, true);
+    if (pthread_create(&_mz_asynclog_writer, NULL, _mz_asynclog_run, NULL) != 0) {
+      atomic_store(&_mz_asynclog_running, false);
+      ERROR("could not start the asynclog writer");
+    } else {
+      result = true;
+    }
+  }
+  return result;
+}
+
+void mz_asynclog_stop() {
+  int running = true;
+  if (atomic_compare_exchange_strong(&_mz_asynclog_running, &running, false)) {
+    pthread_join(_mz_asynclog_writer, NULL);
+    //records pushed after the writer's last look
+    _mz_asynclog_drain();
+  }
+}
+
+void mz_asynclog_flush() {
+  size_t submitted = atomic_load_explicit(&_mz_asynclog_submitted, memory_order_relaxed);
+  while (atomic_load_explicit(&_mz_asynclog_running, memory_order_acquire) &&
+         atomic_load_explicit(&_mz_asynclog_written, memory_order_acquire) < submitted) {
+    sched_yield();
+  }
+}
+
+size_t mz_asynclog_dropped() {
+  return atomic_load_explicit(&_mz_asynclog_dropped_total, memory_order_relaxed);
+}
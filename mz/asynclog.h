@@ -0,0 +1,109 @@
+#ifndef __mz_asynclog__
+#define __mz_asynclog__
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include "type.h"
+
+//records every thread can have waiting for the writer, a power of two
+#ifndef MZ_ASYNCLOG_RING_SIZE
+#define MZ_ASYNCLOG_RING_SIZE 256
+#endif
+
+#define MZ_ASYNCLOG_MAX_ARGS 8
+//bytes of %s arguments a record can copy, longer strings are cut
+#define MZ_ASYNCLOG_STRING_BYTES 128
+//longest line the writer formats, longer lines are cut
+#define MZ_ASYNCLOG_LINE_BYTES 1024
+
+typedef enum mz_AsyncLogLevel {
+  mz_AsyncLogLevelError,
+  mz_AsyncLogLevelWarn,
+  mz_AsyncLogLevelInfo,
+  mz_AsyncLogLevelDebug
+} mz_AsyncLogLevel;
+
+//what a thread does when its ring is full
+typedef enum mz_AsyncLogPolicy {
+  //the record is dropped and counted, logging never waits for the writer
+  mz_AsyncLogPolicyDrop,
+  //the thread yields until the writer makes room
+  mz_AsyncLogPolicyBlock
+} mz_AsyncLogPolicy;
+
+typedef struct mz_AsyncLogOptions {
+  int fd;
+  mz_AsyncLogPolicy policy;
+  //records a thread may log per second before the rest of the second is dropped, 0 for no limit
+  size_t max_records_per_second;
+  //how long the writer sleeps when every ring is empty
+  unsigned int idle_microseconds;
+} mz_AsyncLogOptions;
+
+//an argument as read from the va_list, strings are copied into the record
+typedef union mz_AsyncLogArg {
+  intmax_t i;
+  uintmax_t u;
+  double d;
+  const void *p;
+  size_t string_offset;
+} mz_AsyncLogArg;
+
+//a call to log before formatting. the format string and file name are only referenced,
+//so they have to be literals or otherwise outlive the writer
+typedef struct mz_AsyncLogRecord {
+  mz_AsyncLogLevel level;
+  int line;
+  int error_number;
+  const char *file;
+  const char *format;
+  size_t arg_count;
+  mz_AsyncLogArg args[MZ_ASYNCLOG_MAX_ARGS];
+  size_t string_size;
+  char strings[MZ_ASYNCLOG_STRING_BYTES];
+} mz_AsyncLogRecord;
+
+//the ring of one thread: the thread pushes records, the writer pops them. buffers are linked
+//into a list the writer walks and stay there until their thread exits and they are drained
+typedef struct mz_AsyncLogBuffer {
+  struct mz_AsyncLogBuffer *next;
+  atomic_int abandoned;
+  atomic_size_t dropped;
+  atomic_size_t rate_limited;
+  size_t reported_dropped;
+  size_t reported_rate_limited;
+  long window;
+  size_t window_count;
+  _Alignas(MZ_CACHE_LINE_SIZE) atomic_size_t head;
+  size_t cached_tail;
+  _Alignas(MZ_CACHE_LINE_SIZE) atomic_size_t tail;
+  size_t cached_head;
+  mz_AsyncLogRecord records[MZ_ASYNCLOG_RING_SIZE];
+} mz_AsyncLogBuffer;
+
+//starts the writer thread, options can be NULL for stderr, dropping and no rate limit.
+//until it is started, and after it is stopped, every record is written to stderr by the
+//calling thread. options are read by logging threads, so it should not be restarted while
+//other threads log
+bool mz_asynclog_start(const mz_AsyncLogOptions *options);
+
+//writes what is left in the rings and joins the writer. records logged while it stops
+//may be lost
+void mz_asynclog_stop();
+
+//waits until every record logged before the call has been written
+void mz_asynclog_flush();
+
+//records dropped because a ring was full or over the rate limit, since the start
+size_t mz_asynclog_dropped();
+
+//captures the arguments into the ring of the calling thread, the writer formats them.
+//supports the conversions of printf without %n, with at most MZ_ASYNCLOG_MAX_ARGS arguments
+void mz_asynclog_log(mz_AsyncLogLevel level, const char *file, int line, int error_number, const char *format, ...)
+    __attribute__((format(printf, 5, 6)));
+
+//formats a record into out the way the writer does, and returns the length of the line
+size_t mz_asynclog_format(const mz_AsyncLogRecord *record, char *out, size_t len);
+
+#endif
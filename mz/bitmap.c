@@ -0,0 +1,270 @@
+#include <stdlib.h>
+#include <string.h>
+#include "bitmap.h"
+#include "logger.h"
+#include "type.h"
+
+//clears the bits past size in the last word
+void _mz_bitmap_trim(mz_Bitmap *bitmap) {
+  if (bitmap->size % 64 != 0) {
+    bitmap->words[bitmap->word_count - 1] &= ((uint64_t) 1 << (bitmap->size % 64)) - 1;
+  }
+}
+
+bool _mz_bitmap_same_size(const mz_Bitmap *a, const mz_Bitmap *b) {
+  if (a->size != b->size) {
+    ERROR("bitmap sizes differ - %zu and %zu", a->size, b->size);
+    return false;
+  }
+  return true;
+}
+
+mz_Bitmap *mz_bitmap_new(size_t size) {
+  mz_Bitmap *bitmap = calloc(1, sizeof(mz_Bitmap));
+  if (!bitmap) {
+    ERROR("could not allocate memory for bitmap");
+  } else {
+    bitmap->size = size;
+    bitmap->word_count = (size + 63) / 64;
+    //one word even for an empty bitmap, so words is never NULL
+    bitmap->words = calloc(bitmap->word_count > 0 ? bitmap->word_count : 1, sizeof(uint64_t));
+    if (!bitmap->words) {
+      ERROR("could not allocate memory for bitmap->words");
+      free(bitmap);
+      bitmap = NULL;
+    }
+  }
+  return bitmap;
+}
+
+void mz_bitmap_free(mz_Bitmap *bitmap) {
+  if (bitmap) {
+    free(bitmap->words);
+    free(bitmap);
+  }
+}
+
+void mz_bitmap_fill(mz_Bitmap *bitmap, bool value) {
+  memset(bitmap->words, value ? 0xff : 0, bitmap->word_count * sizeof(uint64_t));
+  _mz_bitmap_trim(bitmap);
+}
+
+bool mz_bitmap_and(mz_Bitmap *result, const mz_Bitmap *a, const mz_Bitmap *b) {
+  if (!_mz_bitmap_same_size(result, a) || !_mz_bitmap_same_size(a, b)) {
+    return false;
+  }
+  for (size_t i = 0; i < result->word_count; i++) {
+    result->words[i] = a->words[i] & b->words[i];
+  }
+  return true;
+}
+
+bool mz_bitmap_or(mz_Bitmap *result, const mz_Bitmap *a, const mz_Bitmap *b) {
+  if (!_mz_bitmap_same_size(result, a) || !_mz_bitmap_same_size(a, b)) {
+    return false;
+  }
+  for (size_t i = 0; i < result->word_count; i++) {
+    result->words[i] = a->words[i] | b->words[i];
+  }
+  return true;
+}
+
+bool mz_bitmap_not(mz_Bitmap *result, const mz_Bitmap *a) {
+  if (!_mz_bitmap_same_size(result, a)) {
+    return false;
+  }
+  for (size_t i = 0; i < result->word_count; i++) {
+    result->words[i] = ~a->words[i];
+  }
+  _mz_bitmap_trim(result);
+  return true;
+}
+
+size_t mz_bitmap_count(const mz_Bitmap *bitmap) {
+  size_t count = 0;
+  for (size_t i = 0; i < bitmap->word_count; i++) {
+    count += (size_t) __builtin_popcountll(bitmap->words[i]);
+  }
+  return count;
+}
+
+size_t mz_bitmap_next(const mz_Bitmap *bitmap, size_t from) {
+  if (from >= bitmap->size) {
+    return MZ_NPOS;
+  }
+  size_t i = from / 64;
+  //drop the bits below from in the first word
+  uint64_t word = bitmap->words[i] & (~(uint64_t) 0 << (from % 64));
+  while (word == 0) {
+    if (++i == bitmap->word_count) {
+      return MZ_NPOS;
+    }
+    word = bitmap->words[i];
+  }
+  return i * 64 + (size_t) __builtin_ctzll(word);
+}
+
+mz_PackedList *mz_bitmap_to_selection(const mz_Bitmap *bitmap) {
+  size_t count = mz_bitmap_count(bitmap);
+  mz_PackedList *selection = mz_packedlist_new(count > 0 ? count : 1, sizeof(size_t));
+  if (!selection) {
+    ERROR("could not allocate selection");
+  } else {
+    size_t *indices = mz_packedlist_data(selection);
+    for (size_t i = 0; i < bitmap->word_count; i++) {
+      //peel off the lowest set bit until the word is empty
+      for (uint64_t word = bitmap->words[i]; word != 0; word &= word - 1) {
+        indices[selection->size++] = i * 64 + (size_t) __builtin_ctzll(word);
+      }
+    }
+  }
+  return selection;
+}
+
+mz_Bitmap *mz_arrayslice_filter_bitmap(mz_ArraySlice slice, bool (*mz_arraylist_filter_fn)(const void *)) {
+  mz_Bitmap *bitmap = mz_bitmap_new(slice.size);
+  if (!bitmap) {
+    ERROR("could not allocate result bitmap");
+  } else {
+    //build each word in a register instead of setting bits in memory
+    for (size_t i = 0; i < bitmap->word_count; i++) {
+      uint64_t word = 0;
+      size_t end = slice.size - i * 64 < 64 ? slice.size - i * 64 : 64;
+      for (size_t bit = 0; bit < end; bit++) {
+        word |= (uint64_t) ((*mz_arraylist_filter_fn)(slice.array[i * 64 + bit]) != 0) << bit;
+      }
+      bitmap->words[i] = word;
+    }
+  }
+  return bitmap;
+}
+
+bool mz_arrayslice_filter_bitmap_and(mz_ArraySlice slice, mz_Bitmap *bitmap,
+                                     bool (*mz_arraylist_filter_fn)(const void *)) {
+  bool result = false;
+  if (bitmap->size != slice.size) {
+    ERROR("bitmap size %zu differs from slice size %zu", bitmap->size, slice.size);
+  } else {
+    for (size_t i = 0; i < bitmap->word_count; i++) {
+      uint64_t word = bitmap->words[i];
+      for (uint64_t remaining = word; remaining != 0; remaining &= remaining - 1) {
+        int bit = __builtin_ctzll(remaining);
+        if (!(*mz_arraylist_filter_fn)(slice.array[i * 64 + bit])) {
+          word &= ~((uint64_t) 1 << bit);
+        }
+      }
+      bitmap->words[i] = word;
+    }
+    result = true;
+  }
+  return result;
+}
+
+mz_PackedList *mz_arrayslice_filter_selection(mz_ArraySlice slice, bool (*mz_arraylist_filter_fn)(const void *)) {
+  mz_PackedList *selection = mz_packedlist_new(MZ_ARRAYLIST_INLINE_CAPACITY, sizeof(size_t));
+  if (!selection) {
+    ERROR("could not allocate selection");
+  } else {
+    for (size_t i = 0; i < slice.size; i++) {
+      if ((*mz_arraylist_filter_fn)(slice.array[i]) && !mz_packedlist_append(selection, &i)) {
+        ERROR("could not append to selection");
+        mz_packedlist_free(selection);
+        return NULL;
+      }
+    }
+  }
+  return selection;
+}
+
+mz_ArrayList *mz_arrayslice_gather(mz_ArraySlice slice, const size_t *indices, size_t len) {
+  mz_ArrayList *result = mz_arraylist_new(MZ_ARRAYLIST_INLINE_CAPACITY, sizeof(void *));
+  if (!result) {
+    ERROR("could not allocate result list");
+  } else if (!mz_arraylist_reserve(result, len)) {
+    ERROR("could not reserve arraylist capacity");
+    mz_arraylist_free(result);
+    result = NULL;
+  } else {
+    for (size_t i = 0; i < len; i++) {
+      if (indices[i] >= slice.size) {
+        ERROR("index is out of range - %zu", indices[i]);
+        mz_arraylist_free(result);
+        return NULL;
+      }
+      result->array[i] = slice.array[indices[i]];
+    }
+    result->size = len;
+  }
+  return result;
+}
+
+mz_ArrayList *mz_arrayslice_compact(mz_ArraySlice slice, const mz_Bitmap *bitmap) {
+  mz_ArrayList *result = NULL;
+  if (bitmap->size != slice.size) {
+    ERROR("bitmap size %zu differs from slice size %zu", bitmap->size, slice.size);
+  } else if (!(result = mz_arraylist_new(MZ_ARRAYLIST_INLINE_CAPACITY, sizeof(void *)))) {
+    ERROR("could not allocate result list");
+  } else if (!mz_arraylist_reserve(result, mz_bitmap_count(bitmap))) {
+    ERROR("could not reserve arraylist capacity");
+    mz_arraylist_free(result);
+    result = NULL;
+  } else {
+    for (size_t i = 0; i < bitmap->word_count; i++) {
+      for (uint64_t word = bitmap->words[i]; word != 0; word &= word - 1) {
+        result->array[result->size++] = slice.array[i * 64 + (size_t) __builtin_ctzll(word)];
+      }
+    }
+  }
+  return result;
+}
+
+mz_Bitmap *mz_arraylist_filter_bitmap(mz_ArrayList *list, bool (*mz_arraylist_filter_fn)(const void *)) {
+  mz_Bitmap *result = NULL;
+  if (!list) {
+    ERROR("list is null");
+  } else {
+    result = mz_arrayslice_filter_bitmap(mz_arraylist_as_slice(list), (*mz_arraylist_filter_fn));
+  }
+  return result;
+}
+
+bool mz_arraylist_filter_bitmap_and(mz_ArrayList *list, mz_Bitmap *bitmap,
+                                    bool (*mz_arraylist_filter_fn)(const void *)) {
+  bool result = false;
+  if (!list) {
+    ERROR("list is null");
+  } else {
+    result = mz_arrayslice_filter_bitmap_and(mz_arraylist_as_slice(list), bitmap, (*mz_arraylist_filter_fn));
+  }
+  return result;
+}
+
+mz_PackedList *mz_arraylist_filter_selection(mz_ArrayList *list, bool (*mz_arraylist_filter_fn)(const void *)) {
+  mz_PackedList *result = NULL;
+  if (!list) {
+    ERROR("list is null");
+  } else {
+    result = mz_arrayslice_filter_selection(mz_arraylist_as_slice(list), (*mz_arraylist_filter_fn));
+  }
+  return result;
+}
+
+mz_ArrayList *mz_arraylist_gather(mz_ArrayList *list, const size_t *indices, size_t len) {
+  mz_ArrayList *result = NULL;
+  if (!list) {
+    ERROR("list is null");
+  } else {
+    result = mz_arrayslice_gather(mz_arraylist_as_slice(list), indices, len);
+  }
+  return result;
+}
+
+mz_ArrayList *mz_arraylist_compact(mz_ArrayList *list, const mz_Bitmap *bitmap) {
+  mz_ArrayList *result = NULL;
+  if (!list) {
+    ERROR("list is null");
+  } else {
+    result = mz_arrayslice_compact(mz_arraylist_as_slice(list), bitmap);
+  }
+  return result;
+}
@@ -0,0 +1,83 @@
+#ifndef __mz_bitmap__
+#define __mz_bitmap__
+
+#include <stdlib.h>
+#include <stdint.h>
+#include "type.h"
+#include "arraylist.h"
+#include "packedlist.h"
+
+//dense set of row indices, one bit per element of the list it was built from.
+//bits past size are always clear so whole words can be combined and counted
+typedef struct mz_Bitmap {
+  size_t size;
+  size_t word_count;
+  uint64_t *words;
+} mz_Bitmap;
+
+//every bit starts clear
+mz_Bitmap *mz_bitmap_new(size_t size);
+
+void mz_bitmap_free(mz_Bitmap *bitmap);
+
+void mz_bitmap_fill(mz_Bitmap *bitmap, bool value);
+
+//result may be one of the operands, every bitmap must have the same size
+bool mz_bitmap_and(mz_Bitmap *result, const mz_Bitmap *a, const mz_Bitmap *b);
+
+bool mz_bitmap_or(mz_Bitmap *result, const mz_Bitmap *a, const mz_Bitmap *b);
+
+bool mz_bitmap_not(mz_Bitmap *result, const mz_Bitmap *a);
+
+//number of set bits
+size_t mz_bitmap_count(const mz_Bitmap *bitmap);
+
+//index of the first set bit at or after from, or MZ_NPOS
+size_t mz_bitmap_next(const mz_Bitmap *bitmap, size_t from);
+
+//the indices of the set bits in ascending order, as a packedlist of size_t
+mz_PackedList *mz_bitmap_to_selection(const mz_Bitmap *bitmap);
+
+//index must be below size
+static inline void mz_bitmap_set(mz_Bitmap *bitmap, size_t index) {
+  bitmap->words[index / 64] |= (uint64_t) 1 << (index % 64);
+}
+
+static inline void mz_bitmap_clear(mz_Bitmap *bitmap, size_t index) {
+  bitmap->words[index / 64] &= ~((uint64_t) 1 << (index % 64));
+}
+
+static inline bool mz_bitmap_test(const mz_Bitmap *bitmap, size_t index) {
+  return (bitmap->words[index / 64] >> (index % 64)) & 1;
+}
+
+//filters that only record which elements matched. predicates combine with the bitmap
+//operations, or with filter_bitmap_and, which only calls the predicate for set bits
+mz_Bitmap *mz_arrayslice_filter_bitmap(mz_ArraySlice slice, bool (*mz_arraylist_filter_fn)(const void *));
+
+bool mz_arrayslice_filter_bitmap_and(mz_ArraySlice slice, mz_Bitmap *bitmap,
+                                     bool (*mz_arraylist_filter_fn)(const void *));
+
+//the indices of the matching elements in ascending order, as a packedlist of size_t
+mz_PackedList *mz_arrayslice_filter_selection(mz_ArraySlice slice, bool (*mz_arraylist_filter_fn)(const void *));
+
+//materializes the elements at the given indices, in the order given
+mz_ArrayList *mz_arrayslice_gather(mz_ArraySlice slice, const size_t *indices, size_t len);
+
+//materializes the elements whose bit is set, bitmap must have the slice's size
+mz_ArrayList *mz_arrayslice_compact(mz_ArraySlice slice, const mz_Bitmap *bitmap);
+
+mz_Bitmap *mz_arraylist_filter_bitmap(mz_ArrayList *list, bool (*mz_arraylist_filter_fn)(const void *));
+
+bool mz_arraylist_filter_bitmap_and(mz_ArrayList *list, mz_Bitmap *bitmap,
+                                    bool (*mz_arraylist_filter_fn)(const void *));
+
+mz_PackedList *mz_arraylist_filter_selection(mz_ArrayList *list, bool (*mz_arraylist_filter_fn)(const void *));
+
+mz_ArrayList *mz_arraylist_gather(mz_ArrayList *list, const size_t *indices, size_t len);
+
+mz_ArrayList *mz_arraylist_compact(mz_ArrayList *list, const mz_Bitmap *bitmap);
+
+#define mzm_bitmap_foreach(B, I) for (size_t I = mz_bitmap_next(B, 0); I != MZ_NPOS; I = mz_bitmap_next(B, I + 1))
+
+#endif
@@ -0,0 +1,226 @@
+#include <stdlib.h>
+#include <string.h>
+#include "columnlist.h"
+#include "logger.h"
+#include "type.h"
+
+//stable bottom-up merge sort of row indices by the values they point at in column
+bool _mz_columnlist_sort_indices(mz_ColumnList *list, size_t column, size_t *indices,
+                                 int (*mz_columnlist_comparator_fn)(const void *, const void *)) {
+  size_t len = list->size;
+  size_t *scratch = malloc(len * sizeof(size_t));
+  if (!scratch) {
+    ERROR("could not allocate memory for columnlist sort");
+    return false;
+  }
+  const char *data = list->columns[column]->data;
+  size_t element_size = list->fields[column].size;
+  size_t *from = indices;
+  size_t *to = scratch;
+  for (size_t width = 1; width < len; width *= 2) {
+    for (size_t start = 0; start < len; start += 2 * width) {
+      size_t middle = start + width < len ? start + width : len;
+      size_t end = start + 2 * width < len ? start + 2 * width : len;
+      size_t i = start, j = middle, k = start;
+      while (i < middle && j < end) {
+        //ties take the left run, which keeps the sort stable
+        if ((*mz_columnlist_comparator_fn)(data + from[j] * element_size, data + from[i] * element_size) < 0) {
+          to[k++] = from[j++];
+        } else {
+          to[k++] = from[i++];
+        }
+      }
+      while (i < middle) {
+        to[k++] = from[i++];
+      }
+      while (j < end) {
+        to[k++] = from[j++];
+      }
+    }
+    size_t *swap = from;
+    from = to;
+    to = swap;
+  }
+  if (from != indices) {
+    memcpy(indices, from, len * sizeof(size_t));
+  }
+  free(scratch);
+  return true;
+}
+
+mz_ColumnList *mz_columnlist_new(size_t initial_capacity, const mz_ColumnListField *fields, size_t column_count) {
+  mz_ColumnList *list = NULL;
+  if (initial_capacity < 1) {
+    ERROR("invalid initial_capacity for columnlist. initial_capacity must be greater than 1");
+  } else if (column_count < 1) {
+    ERROR("invalid column_count for columnlist. column_count must be greater than 1");
+  } else if (!(list = calloc(1, sizeof(mz_ColumnList)))) {
+    ERROR("could not allocate memory for columnlist");
+  } else {
+    list->fields = malloc(column_count * sizeof(mz_ColumnListField));
+    list->columns = calloc(column_count, sizeof(mz_PackedList *));
+    if (!list->fields || !list->columns) {
+      ERROR("could not allocate memory for columnlist");
+      mz_columnlist_free(list);
+      return NULL;
+    }
+    memcpy(list->fields, fields, column_count * sizeof(mz_ColumnListField));
+    list->column_count = column_count;
+    for (size_t c = 0; c < column_count; c++) {
+      //packedlist_new reports invalid sizes
+      list->columns[c] = mz_packedlist_new(initial_capacity, fields[c].size);
+      if (!list->columns[c]) {
+        mz_columnlist_free(list);
+        return NULL;
+      }
+    }
+  }
+  return list;
+}
+
+void mz_columnlist_free(mz_ColumnList *list) {
+  if (list) {
+    if (list->columns) {
+      for (size_t c = 0; c < list->column_count; c++) {
+        mz_packedlist_free(list->columns[c]);
+      }
+    }
+    free(list->columns);
+    free(list->fields);
+    free(list);
+  }
+}
+
+bool mz_columnlist_reserve(mz_ColumnList *list, size_t capacity) {
+  for (size_t c = 0; c < list->column_count; c++) {
+    if (!mz_packedlist_reserve(list->columns[c], capacity)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool mz_columnlist_append_row(mz_ColumnList *list, const void *row) {
+  bool result = false;
+  //reserve every column first, so a failure leaves the columns the same length
+  if (!mz_columnlist_reserve(list, list->size + 1)) {
+    ERROR("could not reserve columnlist capacity");
+  } else {
+    for (size_t c = 0; c < list->column_count; c++) {
+      mz_packedlist_append(list->columns[c], (const char *) row + list->fields[c].offset);
+    }
+    list->size++;
+    result = true;
+  }
+  return result;
+}
+
+bool mz_columnlist_get_row(mz_ColumnList *list, size_t index, void *row) {
+  bool result = false;
+  if (index >= list->size) {
+    ERROR("index is out of range - %zu", index);
+  } else {
+    for (size_t c = 0; c < list->column_count; c++) {
+      memcpy((char *) row + list->fields[c].offset, mz_columnlist_get(list, c, index), list->fields[c].size);
+    }
+    result = true;
+  }
+  return result;
+}
+
+mz_Bitmap *mz_columnlist_filter_bitmap(mz_ColumnList *list, size_t column,
+                                       bool (*mz_columnlist_filter_fn)(const void *value)) {
+  mz_Bitmap *bitmap = NULL;
+  if (column >= list->column_count) {
+    ERROR("column is out of range - %zu", column);
+  } else if ((bitmap = mz_bitmap_new(list->size))) {
+    mz_ColumnView view = mz_columnlist_view(list, column);
+    for (size_t i = 0; i < view.size; i++) {
+      if ((*mz_columnlist_filter_fn)(mz_columnview_get(view, i))) {
+        mz_bitmap_set(bitmap, i);
+      }
+    }
+  }
+  return bitmap;
+}
+
+bool mz_columnlist_filter_bitmap_and(mz_ColumnList *list, size_t column, mz_Bitmap *bitmap,
+                                     bool (*mz_columnlist_filter_fn)(const void *value)) {
+  bool result = false;
+  if (column >= list->column_count) {
+    ERROR("column is out of range - %zu", column);
+  } else if (bitmap->size != list->size) {
+    ERROR("bitmap size %zu does not match columnlist size %zu", bitmap->size, list->size);
+  } else {
+    mz_ColumnView view = mz_columnlist_view(list, column);
+    mzm_bitmap_foreach(bitmap, i) {
+      if (!(*mz_columnlist_filter_fn)(mz_columnview_get(view, i))) {
+        mz_bitmap_clear(bitmap, i);
+      }
+    }
+    result = true;
+  }
+  return result;
+}
+
+bool mz_columnlist_compact(mz_ColumnList *list, const mz_Bitmap *bitmap) {
+  bool result = false;
+  if (bitmap->size != list->size) {
+    ERROR("bitmap size %zu does not match columnlist size %zu", bitmap->size, list->size);
+  } else {
+    size_t kept = 0;
+    for (size_t c = 0; c < list->column_count; c++) {
+      char *data = list->columns[c]->data;
+      size_t element_size = list->fields[c].size;
+      kept = 0;
+      mzm_bitmap_foreach(bitmap, i) {
+        //kept never passes i, so rows only move towards the front
+        if (kept != i) {
+          memcpy(data + kept * element_size, data + i * element_size, element_size);
+        }
+        kept++;
+      }
+      list->columns[c]->size = kept;
+    }
+    list->size = kept;
+    result = true;
+  }
+  return result;
+}
+
+bool mz_columnlist_sort(mz_ColumnList *list, size_t column,
+                        int (*mz_columnlist_comparator_fn)(const void *, const void *)) {
+  bool result = false;
+  size_t largest = 0;
+  for (size_t c = 0; c < list->column_count; c++) {
+    largest = list->fields[c].size > largest ? list->fields[c].size : largest;
+  }
+  size_t *indices = NULL;
+  char *scratch = NULL;
+  if (column >= list->column_count) {
+    ERROR("column is out of range - %zu", column);
+  } else if (list->size < 2) {
+    result = true;
+  } else if (!(indices = malloc(list->size * sizeof(size_t))) || !(scratch = malloc(list->size * largest))) {
+    ERROR("could not allocate memory for columnlist sort");
+  } else {
+    for (size_t i = 0; i < list->size; i++) {
+      indices[i] = i;
+    }
+    if (_mz_columnlist_sort_indices(list, column, indices, mz_columnlist_comparator_fn)) {
+      //apply the same permutation to every column
+      for (size_t c = 0; c < list->column_count; c++) {
+        char *data = list->columns[c]->data;
+        size_t element_size = list->fields[c].size;
+        for (size_t i = 0; i < list->size; i++) {
+          memcpy(scratch + i * element_size, data + indices[i] * element_size, element_size);
+        }
+        memcpy(data, scratch, list->size * element_size);
+      }
+      result = true;
+    }
+  }
+  free(indices);
+  free(scratch);
+  return result;
+}
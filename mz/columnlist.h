@@ -0,0 +1,90 @@
+#ifndef __mz_columnlist__
+#define __mz_columnlist__
+
+#include <stdlib.h>
+#include <stddef.h>
+#include "type.h"
+#include "packedlist.h"
+#include "bitmap.h"
+
+//a column of the schema: the size of its values and their offset in the row struct
+//passed to append_row and get_row
+typedef struct mz_ColumnListField {
+  size_t size;
+  size_t offset;
+} mz_ColumnListField;
+
+#define MZ_COLUMNLIST_FIELD(T, F) {sizeof(((T *) 0)->F), offsetof(T, F)}
+
+//struct of arrays: every field of the rows lives in its own packedlist, so a scan of one
+//field only reads that field's bytes. rows are addressed by their index in every column
+typedef struct mz_ColumnList {
+  size_t size;
+  size_t column_count;
+  mz_ColumnListField *fields;
+  mz_PackedList **columns;
+} mz_ColumnList;
+
+//a window into the values of a column. the values are borrowed: a view is invalidated
+//by any operation that changes the rows of its list
+typedef struct mz_ColumnView {
+  char *data;
+  size_t element_size;
+  size_t size;
+} mz_ColumnView;
+
+mz_ColumnList *mz_columnlist_new(size_t initial_capacity, const mz_ColumnListField *fields, size_t column_count);
+
+void mz_columnlist_free(mz_ColumnList *list);
+
+bool mz_columnlist_reserve(mz_ColumnList *list, size_t capacity);
+
+//copies every field of the row struct into its column
+bool mz_columnlist_append_row(mz_ColumnList *list, const void *row);
+
+//gathers the fields of a row back into a row struct
+bool mz_columnlist_get_row(mz_ColumnList *list, size_t index, void *row);
+
+//a bit per row whose value in column matches
+mz_Bitmap *mz_columnlist_filter_bitmap(mz_ColumnList *list, size_t column,
+                                       bool (*mz_columnlist_filter_fn)(const void *value));
+
+//clears the bits of rows whose value in column does not match, only testing set bits
+bool mz_columnlist_filter_bitmap_and(mz_ColumnList *list, size_t column, mz_Bitmap *bitmap,
+                                     bool (*mz_columnlist_filter_fn)(const void *value));
+
+//keeps the rows whose bit is set, in place
+bool mz_columnlist_compact(mz_ColumnList *list, const mz_Bitmap *bitmap);
+
+//stable sort of the rows by the values of column, every column is permuted the same way.
+//the comparator receives pointers to two values, as with mz_packedlist_sort
+bool mz_columnlist_sort(mz_ColumnList *list, size_t column,
+                        int (*mz_columnlist_comparator_fn)(const void *, const void *));
+
+static inline size_t mz_columnlist_size(mz_ColumnList *list) {
+  return list->size;
+}
+
+//column and index must be in range
+static inline void *mz_columnlist_get(mz_ColumnList *list, size_t column, size_t index) {
+  return list->columns[column]->data + index * list->fields[column].size;
+}
+
+static inline mz_ColumnView mz_columnlist_view(mz_ColumnList *list, size_t column) {
+  mz_ColumnView view = {list->columns[column]->data, list->fields[column].size, list->size};
+  return view;
+}
+
+static inline mz_ColumnView mz_columnview_sub(mz_ColumnView view, size_t from_index, size_t to_index) {
+  //clamps the window to the view
+  to_index = to_index < view.size ? to_index : view.size;
+  from_index = from_index < to_index ? from_index : to_index;
+  mz_ColumnView result = {view.data + from_index * view.element_size, view.element_size, to_index - from_index};
+  return result;
+}
+
+static inline void *mz_columnview_get(mz_ColumnView view, size_t index) {
+  return view.data + index * view.element_size;
+}
+
+#endif
@@ -0,0 +1,336 @@
+#include <stdlib.h>
+#include <string.h>
+#include "compressedlist.h"
+#include "simd.h"
+#include "logger.h"
+#include "type.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define _MZ_COMPRESSEDLIST_X86
+#endif
+
+#define _MZ_COMPRESSEDLIST_LANES 4
+
+uint32_t _mz_compressedlist_mask(uint32_t bits) {
+  return bits >= 32 ? UINT32_MAX : (UINT32_C(1) << bits) - 1;
+}
+
+//value i of a lane starts at bit i * bits of the lane, and word j of lane l is words[4 * j + l]
+void _mz_compressedlist_pack(const uint32_t *deltas, uint32_t bits, uint32_t *words) {
+  memset(words, 0, _MZ_COMPRESSEDLIST_LANES * bits * sizeof(uint32_t));
+  if (bits == 0) {
+    return;
+  }
+  for (size_t i = 0; i < MZ_COMPRESSEDLIST_BLOCK_SIZE; i++) {
+    size_t lane = i % _MZ_COMPRESSEDLIST_LANES;
+    size_t position = (i / _MZ_COMPRESSEDLIST_LANES) * bits;
+    size_t word = position / 32;
+    uint32_t shift = position % 32;
+    words[_MZ_COMPRESSEDLIST_LANES * word + lane] |= deltas[i] << shift;
+    if (shift + bits > 32) {
+      words[_MZ_COMPRESSEDLIST_LANES * (word + 1) + lane] |= deltas[i] >> (32 - shift);
+    }
+  }
+}
+
+void _mz_compressedlist_unpack_scalar(const uint32_t *words, uint32_t bits, uint32_t first, uint32_t *out) {
+  uint32_t mask = _mz_compressedlist_mask(bits);
+  uint32_t value = first;
+  for (size_t i = 0; i < MZ_COMPRESSEDLIST_BLOCK_SIZE; i++) {
+    uint32_t delta = 0;
+    if (bits > 0) {
+      size_t lane = i % _MZ_COMPRESSEDLIST_LANES;
+      size_t position = (i / _MZ_COMPRESSEDLIST_LANES) * bits;
+      size_t word = position / 32;
+      uint32_t shift = position % 32;
+      delta = words[_MZ_COMPRESSEDLIST_LANES * word + lane] >> shift;
+      if (shift + bits > 32) {
+        delta |= words[_MZ_COMPRESSEDLIST_LANES * (word + 1) + lane] << (32 - shift);
+      }
+      delta &= mask;
+    }
+    value += delta;
+    out[i] = value;
+  }
+}
+
+#ifdef _MZ_COMPRESSEDLIST_X86
+
+#pragma GCC push_options
+#pragma GCC target("sse2")
+
+typedef uint32_t _mz_compressedlist_v4 __attribute__((vector_size(16)));
+typedef int32_t _mz_compressedlist_i4 __attribute__((vector_size(16)));
+
+//every iteration unpacks the next delta of all four lanes, i.e. four consecutive deltas, and
+//turns them into values with a prefix sum in two shifted adds plus the last value so far
+void _mz_compressedlist_unpack_sse2(const uint32_t *words, uint32_t bits, uint32_t first, uint32_t *out) {
+  const _mz_compressedlist_v4 zero = {0, 0, 0, 0};
+  const _mz_compressedlist_i4 by_one = {4, 0, 1, 2};
+  const _mz_compressedlist_i4 by_two = {4, 5, 0, 1};
+  const _mz_compressedlist_i4 last = {3, 3, 3, 3};
+  _mz_compressedlist_v4 mask = zero + _mz_compressedlist_mask(bits);
+  _mz_compressedlist_v4 carry = zero + first;
+  for (size_t i = 0; i < MZ_COMPRESSEDLIST_BLOCK_SIZE / _MZ_COMPRESSEDLIST_LANES; i++) {
+    _mz_compressedlist_v4 deltas = zero;
+    if (bits > 0) {
+      size_t position = i * bits;
+      size_t word = position / 32;
+      uint32_t shift = position % 32;
+      _mz_compressedlist_v4 low;
+      memcpy(&low, words + _MZ_COMPRESSEDLIST_LANES * word, sizeof(low));
+      deltas = low >> shift;
+      if (shift + bits > 32) {
+        _mz_compressedlist_v4 high;
+        memcpy(&high, words + _MZ_COMPRESSEDLIST_LANES * (word + 1), sizeof(high));
+        deltas |= high << (32 - shift);
+      }
+      deltas &= mask;
+    }
+    deltas += __builtin_shuffle(deltas, zero, by_one);
+    deltas += __builtin_shuffle(deltas, zero, by_two);
+    deltas += carry;
+    memcpy(out + i * _MZ_COMPRESSEDLIST_LANES, &deltas, sizeof(deltas));
+    carry = __builtin_shuffle(deltas, last);
+  }
+}
+
+#pragma GCC pop_options
+
+#endif
+
+void _mz_compressedlist_unpack(const uint32_t *words, uint32_t bits, uint32_t first, uint32_t *out) {
+#ifdef _MZ_COMPRESSEDLIST_X86
+  if (mz_simd_level() >= mz_SimdLevelSse2) {
+    _mz_compressedlist_unpack_sse2(words, bits, first, out);
+    return;
+  }
+#endif
+  _mz_compressedlist_unpack_scalar(words, bits, first, out);
+}
+
+//packs the full tail into a new block
+bool _mz_compressedlist_flush_tail(mz_CompressedList *list) {
+  uint32_t deltas[MZ_COMPRESSEDLIST_BLOCK_SIZE];
+  uint32_t largest = 0;
+  deltas[0] = 0;
+  for (size_t i = 1; i < MZ_COMPRESSEDLIST_BLOCK_SIZE; i++) {
+    deltas[i] = list->tail[i] - list->tail[i - 1];
+    largest |= deltas[i];
+  }
+  uint32_t bits = largest == 0 ? 0 : 32 - (uint32_t) __builtin_clz(largest);
+  size_t word_count = _MZ_COMPRESSEDLIST_LANES * bits;
+  mz_CompressedListBlock block = {
+      .first = list->tail[0],
+      .last = list->tail[MZ_COMPRESSEDLIST_BLOCK_SIZE - 1],
+      .offset = (uint32_t) list->words->size,
+      .bits = bits
+  };
+  if (!mz_packedlist_reserve(list->words, list->words->size + word_count) ||
+      !mz_packedlist_append(list->blocks, &block)) {
+    ERROR("could not allocate memory for compressedlist block");
+    return false;
+  }
+  _mz_compressedlist_pack(deltas, bits, (uint32_t *) list->words->data + list->words->size);
+  list->words->size += word_count;
+  list->tail_size = 0;
+  return true;
+}
+
+//first and last value of a block, including the tail
+void _mz_compressedlist_bounds(mz_CompressedList *list, size_t block, uint32_t *first, uint32_t *last) {
+  if (block < list->blocks->size) {
+    mz_CompressedListBlock *entry = (mz_CompressedListBlock *) list->blocks->data + block;
+    *first = entry->first;
+    *last = entry->last;
+  } else {
+    *first = list->tail[0];
+    *last = list->tail[list->tail_size - 1];
+  }
+}
+
+mz_CompressedList *mz_compressedlist_new() {
+  mz_CompressedList *list = calloc(1, sizeof(mz_CompressedList));
+  if (!list) {
+    ERROR("could not allocate memory for compressedlist");
+  } else {
+    list->blocks = mz_packedlist_new(16, sizeof(mz_CompressedListBlock));
+    list->words = mz_packedlist_new(256, sizeof(uint32_t));
+    if (!list->blocks || !list->words) {
+      ERROR("could not allocate memory for compressedlist");
+      mz_compressedlist_free(list);
+      list = NULL;
+    }
+  }
+  return list;
+}
+
+void mz_compressedlist_free(mz_CompressedList *list) {
+  if (list) {
+    mz_packedlist_free(list->blocks);
+    mz_packedlist_free(list->words);
+    free(list);
+  }
+}
+
+bool mz_compressedlist_append(mz_CompressedList *list, uint32_t value) {
+  bool result = false;
+  bool has_last = list->tail_size > 0 || list->blocks->size > 0;
+  uint32_t first, last;
+  if (has_last) {
+    _mz_compressedlist_bounds(list, mz_compressedlist_block_count(list) - 1, &first, &last);
+  }
+  if (has_last && value < last) {
+    ERROR("compressedlist values must not decrease - %u after %u", value, last);
+  } else {
+    list->tail[list->tail_size++] = value;
+    list->size++;
+    result = list->tail_size < MZ_COMPRESSEDLIST_BLOCK_SIZE || _mz_compressedlist_flush_tail(list);
+    if (!result) {
+      list->tail_size--;
+      list->size--;
+    }
+  }
+  return result;
+}
+
+bool mz_compressedlist_append_range(mz_CompressedList *list, const uint32_t *values, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    if (!mz_compressedlist_append(list, values[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+size_t mz_compressedlist_decode_block(mz_CompressedList *list, size_t block, uint32_t *out) {
+  if (block < list->blocks->size) {
+    mz_CompressedListBlock *entry = (mz_CompressedListBlock *) list->blocks->data + block;
+    _mz_compressedlist_unpack((uint32_t *) list->words->data + entry->offset, entry->bits, entry->first, out);
+    return MZ_COMPRESSEDLIST_BLOCK_SIZE;
+  } else if (block == list->blocks->size) {
+    memcpy(out, list->tail, list->tail_size * sizeof(uint32_t));
+    return list->tail_size;
+  }
+  ERROR("block is out of range - %zu", block);
+  return 0;
+}
+
+bool mz_compressedlist_get(mz_CompressedList *list, size_t index, uint32_t *value) {
+  uint32_t values[MZ_COMPRESSEDLIST_BLOCK_SIZE];
+  if (index >= list->size) {
+    ERROR("index is out of range - %zu", index);
+    return false;
+  }
+  mz_compressedlist_decode_block(list, index / MZ_COMPRESSEDLIST_BLOCK_SIZE, values);
+  *value = values[index % MZ_COMPRESSEDLIST_BLOCK_SIZE];
+  return true;
+}
+
+size_t mz_compressedlist_lower_bound(mz_CompressedList *list, uint32_t value) {
+  //the first block whose last value is not less than value, through the skip index
+  mz_CompressedListBlock *blocks = (mz_CompressedListBlock *) list->blocks->data;
+  size_t start = 0;
+  size_t end = list->blocks->size;
+  while (start < end) {
+    size_t mid = start + (end - start) / 2;
+    if (blocks[mid].last < value) {
+      start = mid + 1;
+    } else {
+      end = mid;
+    }
+  }
+  uint32_t values[MZ_COMPRESSEDLIST_BLOCK_SIZE];
+  size_t len = start < mz_compressedlist_block_count(list) ? mz_compressedlist_decode_block(list, start, values) : 0;
+  size_t i = 0;
+  while (i < len && values[i] < value) {
+    i++;
+  }
+  return start * MZ_COMPRESSEDLIST_BLOCK_SIZE + i;
+}
+
+bool mz_compressedlist_contains(mz_CompressedList *list, uint32_t value) {
+  size_t index = mz_compressedlist_lower_bound(list, value);
+  uint32_t found;
+  return index < list->size && mz_compressedlist_get(list, index, &found) && found == value;
+}
+
+mz_PackedList *mz_compressedlist_intersect(mz_CompressedList *a, mz_CompressedList *b) {
+  mz_PackedList *result = mz_packedlist_new(MZ_COMPRESSEDLIST_BLOCK_SIZE, sizeof(uint32_t));
+  if (!result) {
+    ERROR("could not allocate memory for intersection");
+    return NULL;
+  }
+  uint32_t a_values[MZ_COMPRESSEDLIST_BLOCK_SIZE];
+  uint32_t b_values[MZ_COMPRESSEDLIST_BLOCK_SIZE];
+  size_t a_blocks = mz_compressedlist_block_count(a);
+  size_t b_blocks = mz_compressedlist_block_count(b);
+  size_t a_block = 0, b_block = 0;
+  size_t a_decoded = MZ_NPOS, b_decoded = MZ_NPOS;
+  size_t a_len = 0, b_len = 0, i = 0, j = 0;
+  while (a_block < a_blocks && b_block < b_blocks) {
+    uint32_t a_first, a_last, b_first, b_last;
+    _mz_compressedlist_bounds(a, a_block, &a_first, &a_last);
+    _mz_compressedlist_bounds(b, b_block, &b_first, &b_last);
+    //blocks that cannot overlap are skipped without decoding them
+    if (a_last < b_first) {
+      a_block++;
+      continue;
+    }
+    if (b_last < a_first) {
+      b_block++;
+      continue;
+    }
+    if (a_decoded != a_block) {
+      a_len = mz_compressedlist_decode_block(a, a_block, a_values);
+      a_decoded = a_block;
+      i = 0;
+    }
+    if (b_decoded != b_block) {
+      b_len = mz_compressedlist_decode_block(b, b_block, b_values);
+      b_decoded = b_block;
+      j = 0;
+    }
+    while (i < a_len && j < b_len) {
+      if (a_values[i] < b_values[j]) {
+        i++;
+      } else if (a_values[i] > b_values[j]) {
+        j++;
+      } else {
+        if (!mz_packedlist_append(result, &a_values[i])) {
+          ERROR("could not append to intersection");
+          mz_packedlist_free(result);
+          return NULL;
+        }
+        i++;
+        j++;
+      }
+    }
+    if (i == a_len) {
+      a_block++;
+    }
+    if (j == b_len) {
+      b_block++;
+    }
+  }
+  return result;
+}
+
+mz_PackedList *mz_compressedlist_to_packedlist(mz_CompressedList *list) {
+  mz_PackedList *result = mz_packedlist_new(list->size > 0 ? list->size : 1, sizeof(uint32_t));
+  if (!result) {
+    ERROR("could not allocate memory for packedlist");
+  } else {
+    uint32_t *out = (uint32_t *) result->data;
+    for (size_t block = 0; block < mz_compressedlist_block_count(list); block++) {
+      out += mz_compressedlist_decode_block(list, block, out);
+    }
+    result->size = list->size;
+  }
+  return result;
+}
+
+size_t mz_compressedlist_memory_size(mz_CompressedList *list) {
+  return sizeof(mz_CompressedList) + sizeof(mz_PackedList) * 2 +
+         list->blocks->capacity * list->blocks->element_size + list->words->capacity * list->words->element_size;
+}
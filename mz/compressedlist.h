@@ -0,0 +1,70 @@
+#ifndef __mz_compressedlist__
+#define __mz_compressedlist__
+
+#include <stdlib.h>
+#include <stdint.h>
+#include "type.h"
+#include "packedlist.h"
+
+#define MZ_COMPRESSEDLIST_BLOCK_SIZE 128
+
+//skip index entry of a packed block. offset is the first word of the block in words
+typedef struct mz_CompressedListBlock {
+  uint32_t first;
+  uint32_t last;
+  uint32_t offset;
+  uint32_t bits;
+} mz_CompressedListBlock;
+
+//append-only list of sorted uint32 values. every full block of 128 values is stored as the
+//deltas between neighbours, bit-packed with the width of the largest delta of the block, and
+//the skip index keeps the first and last value of every block so searches and intersections
+//only decode the blocks they need. deltas are packed in 4 interleaved lanes, value i in lane
+//i % 4, so a block decodes 4 values per vector operation. values not filling a block yet stay
+//unpacked in tail
+typedef struct mz_CompressedList {
+  size_t size;
+  mz_PackedList *blocks;
+  mz_PackedList *words;
+  size_t tail_size;
+  uint32_t tail[MZ_COMPRESSEDLIST_BLOCK_SIZE];
+} mz_CompressedList;
+
+mz_CompressedList *mz_compressedlist_new();
+
+void mz_compressedlist_free(mz_CompressedList *list);
+
+//values have to be appended in non-decreasing order
+bool mz_compressedlist_append(mz_CompressedList *list, uint32_t value);
+
+bool mz_compressedlist_append_range(mz_CompressedList *list, const uint32_t *values, size_t len);
+
+//writes the values of a block to out, which has room for MZ_COMPRESSEDLIST_BLOCK_SIZE values,
+//and returns how many there are. the last block may be partial
+size_t mz_compressedlist_decode_block(mz_CompressedList *list, size_t block, uint32_t *out);
+
+bool mz_compressedlist_get(mz_CompressedList *list, size_t index, uint32_t *value);
+
+//the index of the first value not less than value, or the size of the list
+size_t mz_compressedlist_lower_bound(mz_CompressedList *list, uint32_t value);
+
+bool mz_compressedlist_contains(mz_CompressedList *list, uint32_t value);
+
+//the values in both lists into a new packedlist of uint32_t, duplicates matched one to one
+mz_PackedList *mz_compressedlist_intersect(mz_CompressedList *a, mz_CompressedList *b);
+
+//every value into a new packedlist of uint32_t
+mz_PackedList *mz_compressedlist_to_packedlist(mz_CompressedList *list);
+
+//bytes held by the blocks, the skip index and the tail
+size_t mz_compressedlist_memory_size(mz_CompressedList *list);
+
+static inline size_t mz_compressedlist_size(mz_CompressedList *list) {
+  return list->size;
+}
+
+static inline size_t mz_compressedlist_block_count(mz_CompressedList *list) {
+  return list->blocks->size + (list->tail_size > 0);
+}
+
+#endif
@@ -0,0 +1,261 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "externalsort.h"
+#include "serialize.h"
+#include "losertree.h"
+#include "logger.h"
+#include "type.h"
+
+void _mz_externalsort_release(mz_ExternalSort *sorter, void *element) {
+  if (sorter->free_fn) {
+    (*sorter->free_fn)(element);
+  }
+}
+
+void _mz_externalsort_close_runs(mz_ExternalSort *sorter) {
+  mz_ExternalSortRun *runs = (mz_ExternalSortRun *) sorter->runs->data;
+  for (size_t i = 0; i < sorter->runs->size; i++) {
+    close(runs[i].fd);
+  }
+  sorter->runs->size = 0;
+}
+
+//the file is unlinked right away, so it disappears with its descriptor even if the process dies
+int _mz_externalsort_temp_file(mz_ExternalSort *sorter) {
+  const char *name = "/mz_externalsort_XXXXXX";
+  size_t dir_len = strlen(sorter->temp_dir);
+  char *path = malloc(dir_len + strlen(name) + 1);
+  if (!path) {
+    ERROR("could not allocate memory for path");
+    return -1;
+  }
+  memcpy(path, sorter->temp_dir, dir_len);
+  strcpy(path + dir_len, name);
+  int fd = mkstemp(path);
+  if (fd == -1) {
+    ERROR("could not create a temporary file in %s", sorter->temp_dir);
+  } else {
+    unlink(path);
+  }
+  free(path);
+  return fd;
+}
+
+bool _mz_externalsort_spill(mz_ExternalSort *sorter) {
+  bool result = false;
+  mz_StreamWriter writer;
+  mz_ExternalSortRun run = {.fd = -1, .count = sorter->buffer->size};
+  if (!mz_arraylist_sort(sorter->buffer, mz_ArrayListSortOptionMerge, sorter->comparator_fn)) {
+    ERROR("could not sort externalsort run");
+  } else if ((run.fd = _mz_externalsort_temp_file(sorter)) == -1) {
+    //already reported
+  } else if (!mz_streamwriter_init(&writer, mz_stream_fd_write, &run.fd, MZ_STREAM_DEFAULT_BUFFER_SIZE)) {
+    ERROR("could not create externalsort run writer");
+    close(run.fd);
+  } else {
+    for (size_t i = 0; i < sorter->buffer->size && !writer.failed; i++) {
+      mz_serialize_write_element(&writer, sorter->buffer->array[i], sorter->encode_fn);
+    }
+    if (!mz_streamwriter_flush(&writer) || !mz_packedlist_append(sorter->runs, &run)) {
+      ERROR("could not spill externalsort run");
+      close(run.fd);
+    } else {
+      for (size_t i = 0; i < sorter->buffer->size; i++) {
+        _mz_externalsort_release(sorter, sorter->buffer->array[i]);
+      }
+      //keep the capacity for the next run
+      sorter->buffer->size = 0;
+      sorter->buffered_bytes = 0;
+      result = true;
+    }
+    mz_streamwriter_destroy(&writer);
+  }
+  return result;
+}
+
+//opens a reader per run and puts the first element of every run into the tree
+bool _mz_externalsort_start(mz_ExternalSort *sorter, mz_StreamReader *readers, size_t *initialized,
+                            size_t *remaining, mz_LoserTree *tree) {
+  size_t k = sorter->runs->size;
+  mz_ExternalSortRun *runs = (mz_ExternalSortRun *) sorter->runs->data;
+  size_t buffer_size = sorter->memory_budget / k > MZ_STREAM_DEFAULT_BUFFER_SIZE ? sorter->memory_budget / k
+                                                                                 : MZ_STREAM_DEFAULT_BUFFER_SIZE;
+  for (size_t i = 0; i < k; i++) {
+    if (lseek(runs[i].fd, 0, SEEK_SET) == -1 ||
+        !mz_streamreader_init(&readers[i], mz_stream_fd_read, &runs[i].fd, buffer_size)) {
+      ERROR("could not open externalsort run %zu", i);
+      return false;
+    }
+    *initialized = i + 1;
+    remaining[i] = runs[i].count;
+    if (remaining[i] > 0) {
+      void *element = NULL;
+      if (!mz_serialize_read_element(&readers[i], &element, sorter->decode_fn)) {
+        ERROR("could not read externalsort run %zu", i);
+        return false;
+      }
+      remaining[i]--;
+      mz_losertree_set(tree, i, element);
+    }
+  }
+  mz_losertree_build(tree);
+  return true;
+}
+
+bool _mz_externalsort_drain(mz_ExternalSort *sorter, mz_StreamReader *readers, size_t *remaining,
+                            mz_LoserTree *tree, bool (*mz_externalsort_output_fn)(void *context, void *element),
+                            void *context) {
+  size_t winner;
+  while ((winner = mz_losertree_winner(tree)) != MZ_NPOS) {
+    void *element = mz_losertree_winner_key(tree);
+    bool more = (*mz_externalsort_output_fn)(context, element);
+    if (!more || remaining[winner] == 0) {
+      //the element belongs to output_fn now, take it out of the tree
+      mz_losertree_exhaust_winner(tree);
+      if (!more) {
+        break;
+      }
+    } else if (!mz_serialize_read_element(&readers[winner], &element, sorter->decode_fn)) {
+      ERROR("could not read externalsort run %zu", winner);
+      mz_losertree_exhaust_winner(tree);
+      return false;
+    } else {
+      remaining[winner]--;
+      mz_losertree_replace_winner(tree, element);
+    }
+  }
+  return true;
+}
+
+//merges every run, each read through its own share of the memory budget
+bool _mz_externalsort_merge(mz_ExternalSort *sorter, bool (*mz_externalsort_output_fn)(void *context, void *element),
+                            void *context) {
+  bool result = false;
+  size_t k = sorter->runs->size;
+  size_t initialized = 0;
+  mz_StreamReader *readers = calloc(k, sizeof(mz_StreamReader));
+  size_t *remaining = calloc(k, sizeof(size_t));
+  mz_LoserTree *tree = mz_losertree_new(k, sorter->comparator_fn);
+  if (!readers || !remaining || !tree) {
+    ERROR("could not allocate memory for externalsort merge");
+  } else if (_mz_externalsort_start(sorter, readers, &initialized, remaining, tree)) {
+    result = _mz_externalsort_drain(sorter, readers, remaining, tree, mz_externalsort_output_fn, context);
+  }
+  if (tree) {
+    //elements read but never handed out
+    for (size_t i = 0; i < k; i++) {
+      if (!tree->exhausted[i]) {
+        _mz_externalsort_release(sorter, tree->keys[i]);
+      }
+    }
+    mz_losertree_free(tree);
+  }
+  for (size_t i = 0; i < initialized; i++) {
+    mz_streamreader_destroy(&readers[i]);
+  }
+  free(readers);
+  free(remaining);
+  return result;
+}
+
+mz_ExternalSort *mz_externalsort_new(size_t memory_budget,
+                                     int (*mz_externalsort_comparator_fn)(const void *, const void *),
+                                     const void *(*mz_serialize_encode_fn)(const void *element, size_t *len),
+                                     void *(*mz_serialize_decode_fn)(const void *data, size_t len),
+                                     void (*mz_externalsort_free_fn)(void *element), const char *temp_dir) {
+  mz_ExternalSort *sorter = NULL;
+  if (memory_budget < 1) {
+    ERROR("invalid memory_budget for externalsort. memory_budget must be greater than 1");
+  } else if (!mz_externalsort_comparator_fn) {
+    ERROR("externalsort needs a comparator");
+  } else if (!mz_serialize_encode_fn != !mz_serialize_decode_fn) {
+    ERROR("externalsort needs both an encode and a decode function or neither");
+  } else if (mz_externalsort_free_fn && !mz_serialize_encode_fn) {
+    //spilled pointer values come back as they were, so releasing them would leave them dangling
+    ERROR("externalsort can only release elements it encodes, free_fn needs encode and decode functions");
+  } else if (!(sorter = calloc(1, sizeof(mz_ExternalSort)))) {
+    ERROR("could not allocate memory for externalsort");
+  } else {
+    if (!temp_dir) {
+      temp_dir = getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp";
+    }
+    sorter->memory_budget = memory_budget;
+    sorter->comparator_fn = mz_externalsort_comparator_fn;
+    sorter->encode_fn = mz_serialize_encode_fn;
+    sorter->decode_fn = mz_serialize_decode_fn;
+    sorter->free_fn = mz_externalsort_free_fn;
+    sorter->buffer = mz_arraylist_new(MZ_ARRAYLIST_INLINE_CAPACITY, sizeof(void *));
+    sorter->runs = mz_packedlist_new(8, sizeof(mz_ExternalSortRun));
+    sorter->temp_dir = strdup(temp_dir);
+    if (!sorter->buffer || !sorter->runs || !sorter->temp_dir) {
+      ERROR("could not allocate memory for externalsort");
+      mz_externalsort_free(sorter);
+      sorter = NULL;
+    }
+  }
+  return sorter;
+}
+
+void mz_externalsort_free(mz_ExternalSort *sorter) {
+  if (sorter) {
+    if (sorter->buffer) {
+      for (size_t i = 0; i < sorter->buffer->size; i++) {
+        _mz_externalsort_release(sorter, sorter->buffer->array[i]);
+      }
+      mz_arraylist_free(sorter->buffer);
+    }
+    if (sorter->runs) {
+      _mz_externalsort_close_runs(sorter);
+      mz_packedlist_free(sorter->runs);
+    }
+    free(sorter->temp_dir);
+    free(sorter);
+  }
+}
+
+bool mz_externalsort_add(mz_ExternalSort *sorter, void *element) {
+  bool result = false;
+  size_t len = sizeof(uint64_t);
+  if (sorter->encode_fn) {
+    (*sorter->encode_fn)(element, &len);
+    len += sizeof(uint64_t);
+  }
+  if (!mz_arraylist_append(sorter->buffer, element)) {
+    ERROR("could not buffer externalsort element");
+  } else {
+    //the buffered element costs its slot and its encoded size
+    sorter->buffered_bytes += len + sizeof(void *);
+    result = sorter->buffered_bytes < sorter->memory_budget || _mz_externalsort_spill(sorter);
+  }
+  return result;
+}
+
+bool mz_externalsort_finish(mz_ExternalSort *sorter, bool (*mz_externalsort_output_fn)(void *context, void *element),
+                            void *context) {
+  bool result = false;
+  if (sorter->runs->size == 0) {
+    //everything fit in memory
+    if (mz_arraylist_sort(sorter->buffer, mz_ArrayListSortOptionMerge, sorter->comparator_fn)) {
+      size_t i = 0;
+      while (i < sorter->buffer->size && (*mz_externalsort_output_fn)(context, sorter->buffer->array[i++])) {
+      }
+      for (; i < sorter->buffer->size; i++) {
+        _mz_externalsort_release(sorter, sorter->buffer->array[i]);
+      }
+      result = true;
+    } else {
+      ERROR("could not sort externalsort buffer");
+    }
+  } else if (sorter->buffer->size == 0 || _mz_externalsort_spill(sorter)) {
+    //spill the last run too, so the whole budget goes to read buffers
+    result = _mz_externalsort_merge(sorter, mz_externalsort_output_fn, context);
+  }
+  if (result) {
+    sorter->buffer->size = 0;
+    sorter->buffered_bytes = 0;
+    _mz_externalsort_close_runs(sorter);
+  }
+  return result;
+}
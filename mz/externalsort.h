@@ -0,0 +1,57 @@
+#ifndef __mz_externalsort__
+#define __mz_externalsort__
+
+#include <stdlib.h>
+#include <stdint.h>
+#include "type.h"
+#include "arraylist.h"
+#include "packedlist.h"
+
+//a sorted run spilled to an unlinked temporary file
+typedef struct mz_ExternalSortRun {
+  int fd;
+  size_t count;
+} mz_ExternalSortRun;
+
+//merge sort for more elements than fit in memory. elements are buffered until their encoded
+//size reaches the memory budget, then the buffer is sorted and spilled as a run in the binary
+//format of mz/serialize. finishing merges every run through a loser tree, each run read through
+//its own share of the budget, and streams the elements out in order. the sort is stable
+typedef struct mz_ExternalSort {
+  size_t memory_budget;
+  size_t buffered_bytes;
+  int (*comparator_fn)(const void *, const void *);
+  const void *(*encode_fn)(const void *element, size_t *len);
+  void *(*decode_fn)(const void *data, size_t len);
+  void (*free_fn)(void *element);
+  mz_ArrayList *buffer;
+  mz_PackedList *runs;
+  char *temp_dir;
+} mz_ExternalSort;
+
+//encode and decode follow mz_arraylist_serialize, without them the pointer values themselves are
+//spilled. free_fn, which may be NULL, releases elements once they are spilled, since the elements
+//of spilled runs come back as new ones made by decode_fn. it needs encode and decode, as spilled
+//pointer values would come back dangling. temp_dir may be NULL for $TMPDIR or /tmp
+mz_ExternalSort *mz_externalsort_new(size_t memory_budget,
+                                     int (*mz_externalsort_comparator_fn)(const void *, const void *),
+                                     const void *(*mz_serialize_encode_fn)(const void *element, size_t *len),
+                                     void *(*mz_serialize_decode_fn)(const void *data, size_t len),
+                                     void (*mz_externalsort_free_fn)(void *element), const char *temp_dir);
+
+//closes, and so deletes, every run. elements still buffered go to free_fn
+void mz_externalsort_free(mz_ExternalSort *sorter);
+
+bool mz_externalsort_add(mz_ExternalSort *sorter, void *element);
+
+//hands every element to output_fn in order, which owns them from then on. output_fn returns
+//false to stop early, elements already read but not handed out then go to free_fn.
+//the sorter is empty afterwards and can be reused
+bool mz_externalsort_finish(mz_ExternalSort *sorter, bool (*mz_externalsort_output_fn)(void *context, void *element),
+                            void *context);
+
+static inline size_t mz_externalsort_run_count(mz_ExternalSort *sorter) {
+  return sorter->runs->size;
+}
+
+#endif
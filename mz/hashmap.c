@@ -0,0 +1,324 @@
+#include <stdlib.h>
+#include <string.h>
+#include "hashmap.h"
+#include "logger.h"
+#include "type.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+//control bytes: 0..127 are the low 7 bits of a full slot's hash, both markers have the high bit set
+#define _MZ_HASHMAP_EMPTY ((int8_t) -128)
+#define _MZ_HASHMAP_DELETED ((int8_t) -2)
+
+//bit i is set if control byte i of the group equals byte
+uint32_t _mz_hashmap_match(const int8_t *group, int8_t byte) {
+#ifdef __SSE2__
+  __m128i control = _mm_load_si128((const __m128i *) group);
+  return (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(control, _mm_set1_epi8(byte)));
+#else
+  uint32_t mask = 0;
+  for (uint32_t i = 0; i < MZ_HASHMAP_GROUP_SIZE; i++) {
+    mask |= (uint32_t) (group[i] == byte) << i;
+  }
+  return mask;
+#endif
+}
+
+//bit i is set if slot i of the group is empty or deleted
+uint32_t _mz_hashmap_match_free(const int8_t *group) {
+#ifdef __SSE2__
+  return (uint32_t) _mm_movemask_epi8(_mm_load_si128((const __m128i *) group));
+#else
+  uint32_t mask = 0;
+  for (uint32_t i = 0; i < MZ_HASHMAP_GROUP_SIZE; i++) {
+    mask |= (uint32_t) (group[i] < 0) << i;
+  }
+  return mask;
+#endif
+}
+
+//finalizer of murmur3, spreads every input bit over the whole hash
+uint64_t _mz_hashmap_mix(uint64_t hash) {
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash == MZ_HASHMAP_HOLE ? MZ_HASHMAP_HOLE - 1 : hash;
+}
+
+uint64_t mz_hash_pointer(const void *key) {
+  return (uint64_t) (uintptr_t) key;
+}
+
+bool mz_equal_pointer(const void *a, const void *b) {
+  return a == b;
+}
+
+uint64_t mz_hash_string(const void *key) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (const unsigned char *c = key; *c; c++) {
+    hash = (hash ^ *c) * 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+bool mz_equal_string(const void *a, const void *b) {
+  return strcmp(a, b) == 0;
+}
+
+//groups are visited in triangular steps, which reaches every group of a power of two table
+size_t _mz_hashmap_find(mz_HashMap *map, const void *key, uint64_t hash) {
+  size_t group_mask = map->capacity / MZ_HASHMAP_GROUP_SIZE - 1;
+  size_t group = (size_t) (hash >> 7) & group_mask;
+  int8_t tag = (int8_t) (hash & 0x7f);
+  for (size_t step = 1;; step++) {
+    const int8_t *control = map->control + group * MZ_HASHMAP_GROUP_SIZE;
+    for (uint32_t match = _mz_hashmap_match(control, tag); match != 0; match &= match - 1) {
+      size_t slot = group * MZ_HASHMAP_GROUP_SIZE + (size_t) __builtin_ctz(match);
+      size_t index = map->slots[slot];
+      if ((*map->equal_fn)(map->keys->array[index], key)) {
+        return slot;
+      }
+    }
+    //a probe for this key would have stopped at an empty slot of this group
+    if (_mz_hashmap_match(control, _MZ_HASHMAP_EMPTY) != 0 || step > group_mask) {
+      return MZ_NPOS;
+    }
+    group = (group + step) & group_mask;
+  }
+}
+
+//the first empty or deleted slot on the probe sequence of hash
+size_t _mz_hashmap_find_free(mz_HashMap *map, uint64_t hash) {
+  size_t group_mask = map->capacity / MZ_HASHMAP_GROUP_SIZE - 1;
+  size_t group = (size_t) (hash >> 7) & group_mask;
+  for (size_t step = 1;; step++) {
+    uint32_t free_slots = _mz_hashmap_match_free(map->control + group * MZ_HASHMAP_GROUP_SIZE);
+    if (free_slots != 0) {
+      return group * MZ_HASHMAP_GROUP_SIZE + (size_t) __builtin_ctz(free_slots);
+    }
+    group = (group + step) & group_mask;
+  }
+}
+
+void _mz_hashmap_place(mz_HashMap *map, size_t slot, uint64_t hash, size_t index) {
+  map->control[slot] = (int8_t) (hash & 0x7f);
+  map->slots[slot] = index;
+}
+
+//rebuilds the table with capacity slots and moves the live entries together
+bool _mz_hashmap_resize(mz_HashMap *map, size_t capacity) {
+  int8_t *control = NULL;
+  size_t *slots = malloc(capacity * sizeof(size_t));
+  if (!slots || posix_memalign((void **) &control, MZ_HASHMAP_GROUP_SIZE, capacity) != 0) {
+    ERROR("could not allocate memory for hashmap table");
+    free(slots);
+    return false;
+  }
+  memset(control, _MZ_HASHMAP_EMPTY, capacity);
+  free(map->control);
+  free(map->slots);
+  map->control = control;
+  map->slots = slots;
+  map->capacity = capacity;
+  map->tombstones = 0;
+
+  //the stored hashes spare calling hash_fn again
+  uint64_t *hashes = mz_packedlist_data(map->hashes);
+  size_t kept = 0;
+  for (size_t i = 0; i < map->hashes->size; i++) {
+    if (hashes[i] != MZ_HASHMAP_HOLE) {
+      hashes[kept] = hashes[i];
+      map->keys->array[kept] = map->keys->array[i];
+      if (map->values) {
+        map->values->array[kept] = map->values->array[i];
+      }
+      _mz_hashmap_place(map, _mz_hashmap_find_free(map, hashes[kept]), hashes[kept], kept);
+      kept++;
+    }
+  }
+  map->hashes->size = kept;
+  map->keys->size = kept;
+  if (map->values) {
+    map->values->size = kept;
+  }
+  return true;
+}
+
+//the smallest table that holds count entries below the maximum load of 7/8
+size_t _mz_hashmap_capacity_for(size_t count) {
+  size_t capacity = MZ_HASHMAP_GROUP_SIZE;
+  while (capacity - capacity / 8 < count) {
+    capacity *= 2;
+  }
+  return capacity;
+}
+
+mz_HashMap *_mz_hashmap_new(size_t initial_capacity, uint64_t (*mz_hashmap_hash_fn)(const void *),
+                            bool (*mz_hashmap_equal_fn)(const void *, const void *), bool with_values) {
+  mz_HashMap *map = NULL;
+  if (!mz_hashmap_hash_fn || !mz_hashmap_equal_fn) {
+    ERROR("hash_fn and equal_fn must not be null");
+  } else if (!(map = calloc(1, sizeof(mz_HashMap)))) {
+    ERROR("could not allocate memory for hashmap");
+  } else {
+    size_t entries = initial_capacity > 0 ? initial_capacity : 1;
+    map->hash_fn = mz_hashmap_hash_fn;
+    map->equal_fn = mz_hashmap_equal_fn;
+    map->keys = mz_arraylist_new(entries, sizeof(void *));
+    map->values = with_values ? mz_arraylist_new(entries, sizeof(void *)) : NULL;
+    map->hashes = mz_packedlist_new(entries, sizeof(uint64_t));
+    if (!map->keys || (with_values && !map->values) || !map->hashes ||
+        !_mz_hashmap_resize(map, _mz_hashmap_capacity_for(initial_capacity))) {
+      ERROR("could not initialize hashmap");
+      mz_hashmap_free(map);
+      map = NULL;
+    }
+  }
+  return map;
+}
+
+mz_HashMap *mz_hashmap_new(size_t initial_capacity, uint64_t (*mz_hashmap_hash_fn)(const void *),
+                           bool (*mz_hashmap_equal_fn)(const void *, const void *)) {
+  return _mz_hashmap_new(initial_capacity, (*mz_hashmap_hash_fn), (*mz_hashmap_equal_fn), true);
+}
+
+void mz_hashmap_free(mz_HashMap *map) {
+  if (map) {
+    free(map->control);
+    free(map->slots);
+    mz_arraylist_free(map->keys);
+    mz_arraylist_free(map->values);
+    mz_packedlist_free(map->hashes);
+    free(map);
+  }
+}
+
+bool mz_hashmap_put(mz_HashMap *map, void *key, void *value) {
+  uint64_t hash = _mz_hashmap_mix((*map->hash_fn)(key));
+  size_t slot = _mz_hashmap_find(map, key, hash);
+  if (slot != MZ_NPOS) {
+    if (map->values) {
+      map->values->array[map->slots[slot]] = value;
+    }
+    return true;
+  }
+  if (map->size + map->tombstones + 1 > map->capacity - map->capacity / 8 &&
+      !_mz_hashmap_resize(map, _mz_hashmap_capacity_for(map->size + 1))) {
+    return false;
+  }
+  //append to every backing list before touching the table, so a failure leaves no trace
+  size_t index = map->hashes->size;
+  if (!mz_packedlist_append(map->hashes, &hash) || !mz_arraylist_append(map->keys, key) ||
+      (map->values && !mz_arraylist_append(map->values, value))) {
+    ERROR("could not append hashmap entry");
+    map->hashes->size = index;
+    map->keys->size = index;
+    return false;
+  }
+  slot = _mz_hashmap_find_free(map, hash);
+  if (map->control[slot] == _MZ_HASHMAP_DELETED) {
+    map->tombstones--;
+  }
+  _mz_hashmap_place(map, slot, hash, index);
+  map->size++;
+  return true;
+}
+
+size_t mz_hashmap_index_of(mz_HashMap *map, const void *key) {
+  size_t slot = _mz_hashmap_find(map, key, _mz_hashmap_mix((*map->hash_fn)(key)));
+  return slot == MZ_NPOS ? MZ_NPOS : map->slots[slot];
+}
+
+bool mz_hashmap_get(mz_HashMap *map, const void *key, void **value) {
+  size_t index = mz_hashmap_index_of(map, key);
+  if (index == MZ_NPOS) {
+    return false;
+  }
+  if (value) {
+    *value = map->values ? map->values->array[index] : NULL;
+  }
+  return true;
+}
+
+bool mz_hashmap_remove(mz_HashMap *map, const void *key) {
+  size_t slot = _mz_hashmap_find(map, key, _mz_hashmap_mix((*map->hash_fn)(key)));
+  if (slot == MZ_NPOS) {
+    return false;
+  }
+  size_t index = map->slots[slot];
+  ((uint64_t *) mz_packedlist_data(map->hashes))[index] = MZ_HASHMAP_HOLE;
+  map->keys->array[index] = NULL;
+  if (map->values) {
+    map->values->array[index] = NULL;
+  }
+  //probes never went past a group with an empty slot, so the slot can simply become empty
+  const int8_t *group = map->control + slot / MZ_HASHMAP_GROUP_SIZE * MZ_HASHMAP_GROUP_SIZE;
+  if (_mz_hashmap_match(group, _MZ_HASHMAP_EMPTY) != 0) {
+    map->control[slot] = _MZ_HASHMAP_EMPTY;
+  } else {
+    map->control[slot] = _MZ_HASHMAP_DELETED;
+    map->tombstones++;
+  }
+  map->size--;
+  //close the holes once they outnumber the entries
+  if (map->hashes->size - map->size > map->size && map->hashes->size > MZ_HASHMAP_GROUP_SIZE) {
+    _mz_hashmap_resize(map, map->capacity);
+  }
+  return true;
+}
+
+bool mz_hashmap_reserve(mz_HashMap *map, size_t count) {
+  size_t capacity = _mz_hashmap_capacity_for(count);
+  bool result = capacity <= map->capacity || _mz_hashmap_resize(map, capacity);
+  result = result && mz_arraylist_reserve(map->keys, count) && mz_packedlist_reserve(map->hashes, count) &&
+           (!map->values || mz_arraylist_reserve(map->values, count));
+  if (!result) {
+    ERROR("could not reserve hashmap capacity");
+  }
+  return result;
+}
+
+bool mz_hashmap_rehash(mz_HashMap *map) {
+  return _mz_hashmap_resize(map, _mz_hashmap_capacity_for(map->size));
+}
+
+size_t mz_hashmap_next(mz_HashMap *map, size_t index) {
+  const uint64_t *hashes = mz_packedlist_data(map->hashes);
+  for (; index < map->hashes->size; index++) {
+    if (hashes[index] != MZ_HASHMAP_HOLE) {
+      return index;
+    }
+  }
+  return MZ_NPOS;
+}
+
+mz_HashSet *mz_hashset_new(size_t initial_capacity, uint64_t (*mz_hashmap_hash_fn)(const void *),
+                           bool (*mz_hashmap_equal_fn)(const void *, const void *)) {
+  mz_HashSet *set = calloc(1, sizeof(mz_HashSet));
+  if (!set) {
+    ERROR("could not allocate memory for hashset");
+  } else if (!(set->map = _mz_hashmap_new(initial_capacity, (*mz_hashmap_hash_fn), (*mz_hashmap_equal_fn), false))) {
+    free(set);
+    set = NULL;
+  }
+  return set;
+}
+
+void mz_hashset_free(mz_HashSet *set) {
+  if (set) {
+    mz_hashmap_free(set->map);
+    free(set);
+  }
+}
+
+bool mz_hashset_add(mz_HashSet *set, void *key) {
+  return mz_hashmap_put(set->map, key, NULL);
+}
+
+bool mz_hashset_remove(mz_HashSet *set, const void *key) {
+  return mz_hashmap_remove(set->map, key);
+}
@@ -0,0 +1,116 @@
+#ifndef __mz_hashmap__
+#define __mz_hashmap__
+
+#include <stdlib.h>
+#include <stdint.h>
+#include "type.h"
+#include "arraylist.h"
+#include "packedlist.h"
+
+#define MZ_HASHMAP_GROUP_SIZE 16
+
+//open addressing hash map in the style of swiss tables. a control byte per slot holds 7 bits
+//of the hash of its entry, or marks it empty or deleted, and lookups compare a whole group
+//of 16 control bytes at once before touching any key. slots only hold entry indices, the
+//entries themselves are appended to keys, values and hashes, so iteration follows insertion
+//order. removed entries leave a hole that the next rehash closes
+typedef struct mz_HashMap {
+  uint64_t (*hash_fn)(const void *key);
+  bool (*equal_fn)(const void *a, const void *b);
+  size_t capacity;
+  size_t size;
+  size_t tombstones;
+  int8_t *control;
+  size_t *slots;
+  mz_ArrayList *keys;
+  //NULL for a set
+  mz_ArrayList *values;
+  //hash of every entry, MZ_HASHMAP_HOLE for removed ones
+  mz_PackedList *hashes;
+} mz_HashMap;
+
+#define MZ_HASHMAP_HOLE UINT64_MAX
+
+typedef struct mz_HashSet {
+  mz_HashMap *map;
+} mz_HashSet;
+
+//hash and equality for keys that are integers cast to pointers, and for C strings
+uint64_t mz_hash_pointer(const void *key);
+
+bool mz_equal_pointer(const void *a, const void *b);
+
+uint64_t mz_hash_string(const void *key);
+
+bool mz_equal_string(const void *a, const void *b);
+
+mz_HashMap *mz_hashmap_new(size_t initial_capacity, uint64_t (*mz_hashmap_hash_fn)(const void *),
+                           bool (*mz_hashmap_equal_fn)(const void *, const void *));
+
+void mz_hashmap_free(mz_HashMap *map);
+
+//inserts the entry or replaces the value of an equal key
+bool mz_hashmap_put(mz_HashMap *map, void *key, void *value);
+
+//returns false if the key is missing, value may be NULL
+bool mz_hashmap_get(mz_HashMap *map, const void *key, void **value);
+
+//the entry index of the key, usable with key_at and value_at, or MZ_NPOS
+size_t mz_hashmap_index_of(mz_HashMap *map, const void *key);
+
+//once removed entries outnumber live ones the holes are closed, which moves entries to
+//lower indices, so do not remove while iterating by index
+bool mz_hashmap_remove(mz_HashMap *map, const void *key);
+
+//makes room for count entries without growing
+bool mz_hashmap_reserve(mz_HashMap *map, size_t count);
+
+//rebuilds the table and closes the holes of removed entries
+bool mz_hashmap_rehash(mz_HashMap *map);
+
+//the index of the first live entry at or after index, or MZ_NPOS
+size_t mz_hashmap_next(mz_HashMap *map, size_t index);
+
+static inline size_t mz_hashmap_size(mz_HashMap *map) {
+  return map->size;
+}
+
+static inline bool mz_hashmap_contains(mz_HashMap *map, const void *key) {
+  return mz_hashmap_index_of(map, key) != MZ_NPOS;
+}
+
+static inline void *mz_hashmap_key_at(mz_HashMap *map, size_t index) {
+  return map->keys->array[index];
+}
+
+static inline void *mz_hashmap_value_at(mz_HashMap *map, size_t index) {
+  return map->values->array[index];
+}
+
+mz_HashSet *mz_hashset_new(size_t initial_capacity, uint64_t (*mz_hashmap_hash_fn)(const void *),
+                           bool (*mz_hashmap_equal_fn)(const void *, const void *));
+
+void mz_hashset_free(mz_HashSet *set);
+
+bool mz_hashset_add(mz_HashSet *set, void *key);
+
+bool mz_hashset_remove(mz_HashSet *set, const void *key);
+
+static inline bool mz_hashset_contains(mz_HashSet *set, const void *key) {
+  return mz_hashmap_index_of(set->map, key) != MZ_NPOS;
+}
+
+static inline size_t mz_hashset_size(mz_HashSet *set) {
+  return set->map->size;
+}
+
+#define mzm_hashmap_foreach(M, K, V, I) void * K = NULL;\
+                                        void * V = NULL;\
+                                        size_t I = mz_hashmap_next(M, 0);\
+                                        for (; I != MZ_NPOS && ((K = (M)->keys->array[I]) || 1) &&\
+                                               ((V = (M)->values ? (M)->values->array[I] : NULL) || 1);\
+                                             I = mz_hashmap_next(M, I + 1))
+
+#define mzm_hashset_foreach(S, K, I) mzm_hashmap_foreach((S)->map, K, _mzm_hashset_value_##I, I)
+
+#endif
@@ -24,7 +24,7 @@ void mz_linkedlist_free(mz_LinkedList *list) {
 }
 
 void mz_linkedlist_push(mz_LinkedList *list, void *value) {
-  if (!list) {
+  if (!_MZ_CHECK(list)) {
     ERROR("list is null");
   } else {
     mz_LinkedListNode *node = calloc(1, sizeof(mz_LinkedListNode));
@@ -101,12 +101,12 @@ void *mz_linkedlist_pop(mz_LinkedList *list) {
 }
 
 void *mz_linkedlist_shift(mz_LinkedList *list) {
-  mz_LinkedListNode *node = list->first;
-  return node != NULL ? mz_linkedlist_remove(list, node) : NULL;
+  //the first node needs none of the checks of remove
+  return list->first != NULL ? mz_linkedlist_shift_unchecked(list) : NULL;
 }
 
 void mz_linkedlist_unshift(mz_LinkedList *list, void *value) {
-  if (!list) {
+  if (!_MZ_CHECK(list)) {
     ERROR("list is null");
   } else {
     if (list->count == 0) {
@@ -126,3 +126,226 @@ void mz_linkedlist_unshift(mz_LinkedList *list, void *value) {
   }
 }
 
+
+void mz_linkedlist_unlink(mz_LinkedList *list, mz_LinkedListNode *node) {
+  if (node->prev) {
+    node->prev->next = node->next;
+  } else {
+    list->first = node->next;
+  }
+  if (node->next) {
+    node->next->prev = node->prev;
+  } else {
+    list->last = node->prev;
+  }
+  node->next = NULL;
+  node->prev = NULL;
+  list->count -= 1;
+}
+
+void mz_linkedlist_link_first(mz_LinkedList *list, mz_LinkedListNode *node) {
+  node->prev = NULL;
+  node->next = list->first;
+  if (list->first) {
+    list->first->prev = node;
+  } else {
+    list->last = node;
+  }
+  list->first = node;
+  list->count += 1;
+}
+
+void mz_linkedlist_link_last(mz_LinkedList *list, mz_LinkedListNode *node) {
+  node->next = NULL;
+  node->prev = list->last;
+  if (list->last) {
+    list->last->next = node;
+  } else {
+    list->first = node;
+  }
+  list->last = node;
+  list->count += 1;
+}
+
+void mz_linkedlist_move_to_front(mz_LinkedList *list, mz_LinkedListNode *node) {
+  if (node != list->first) {
+    mz_linkedlist_unlink(list, node);
+    mz_linkedlist_link_first(list, node);
+  }
+}
+
+//cuts the chain after count nodes and returns the rest
+mz_LinkedListNode *_mz_linkedlist_cut(mz_LinkedListNode *node, size_t count) {
+  for (size_t i = 1; node && i < count; i++) {
+    node = node->next;
+  }
+  if (!node) {
+    return NULL;
+  }
+  mz_LinkedListNode *rest = node->next;
+  node->next = NULL;
+  return rest;
+}
+
+//merges two sorted chains linked by next only, taking from left on ties
+mz_LinkedListNode *_mz_linkedlist_merge(mz_LinkedListNode *left, mz_LinkedListNode *right,
+                                        int (*mz_linkedlist_comparator_fn)(const void *, const void *),
+                                        mz_LinkedListNode **tail) {
+  mz_LinkedListNode head = {0};
+  mz_LinkedListNode *last = &head;
+  while (left && right) {
+    if ((*mz_linkedlist_comparator_fn)(&left->value, &right->value) <= 0) {
+      last->next = left;
+      left = left->next;
+    } else {
+      last->next = right;
+      right = right->next;
+    }
+    last = last->next;
+  }
+  last->next = left ? left : right;
+  while (last->next) {
+    last = last->next;
+  }
+  *tail = last;
+  return head.next;
+}
+
+bool mz_linkedlist_sort(mz_LinkedList *list, int (*mz_linkedlist_comparator_fn)(const void *, const void *)) {
+  bool result = false;
+  if (!list) {
+    ERROR("list is null");
+  } else {
+    if (list->count > 1) {
+      //merge runs of width nodes pairwise, doubling width until a single run is left
+      mz_LinkedListNode *first = list->first;
+      for (size_t width = 1; width < list->count; width *= 2) {
+        mz_LinkedListNode *remaining = first;
+        mz_LinkedListNode *tail = NULL;
+        first = NULL;
+        while (remaining) {
+          mz_LinkedListNode *left = remaining;
+          mz_LinkedListNode *right = _mz_linkedlist_cut(left, width);
+          remaining = _mz_linkedlist_cut(right, width);
+          mz_LinkedListNode *merged_tail = NULL;
+          mz_LinkedListNode *merged = _mz_linkedlist_merge(left, right, mz_linkedlist_comparator_fn, &merged_tail);
+          if (tail) {
+            tail->next = merged;
+          } else {
+            first = merged;
+          }
+          tail = merged_tail;
+        }
+      }
+      //the merges only maintained next, restore prev in one pass
+      mz_LinkedListNode *prev = NULL;
+      for (mz_LinkedListNode *node = first; node != NULL; node = node->next) {
+        node->prev = prev;
+        prev = node;
+      }
+      list->first = first;
+      list->last = prev;
+    }
+    result = true;
+  }
+  return result;
+}
+
+void mz_linkedlist_splice(mz_LinkedList *list, mz_LinkedListNode *position, mz_LinkedList *other) {
+  if (list == other || other->count == 0) {
+    return;
+  }
+  mz_LinkedListNode *before = position ? position->prev : list->last;
+  other->first->prev = before;
+  other->last->next = position;
+  if (before) {
+    before->next = other->first;
+  } else {
+    list->first = other->first;
+  }
+  if (position) {
+    position->prev = other->last;
+  } else {
+    list->last = other->last;
+  }
+  list->count += other->count;
+  other->first = NULL;
+  other->last = NULL;
+  other->count = 0;
+}
+
+void mz_linkedlist_concat(mz_LinkedList *list, mz_LinkedList *other) {
+  mz_linkedlist_splice(list, NULL, other);
+}
+
+mz_LinkedList *mz_linkedlist_split_at(mz_LinkedList *list, size_t index) {
+  mz_LinkedList *rest = NULL;
+  if (index > list->count) {
+    ERROR("index is out of range - %zu", index);
+  } else if ((rest = mz_linkedlist_new()) && index < list->count) {
+    //walk from the nearer end
+    mz_LinkedListNode *node = NULL;
+    if (index <= list->count / 2) {
+      node = list->first;
+      for (size_t i = 0; i < index; i++) {
+        node = node->next;
+      }
+    } else {
+      node = list->last;
+      for (size_t i = list->count - 1; i > index; i--) {
+        node = node->prev;
+      }
+    }
+    rest->first = node;
+    rest->last = list->last;
+    rest->count = list->count - index;
+    list->last = node->prev;
+    if (list->last) {
+      list->last->next = NULL;
+    } else {
+      list->first = NULL;
+    }
+    node->prev = NULL;
+    list->count = index;
+  }
+  return rest;
+}
+
+mz_LinkedList *mz_linkedlist_from_array(void **values, size_t len) {
+  mz_LinkedList *list = mz_linkedlist_new();
+  if (list) {
+    mz_LinkedListNode *last = NULL;
+    for (size_t i = 0; i < len; i++) {
+      mz_LinkedListNode *node = malloc(sizeof(mz_LinkedListNode));
+      if (!node) {
+        ERROR("could not alloc memory for node");
+        mz_linkedlist_free(list);
+        return NULL;
+      }
+      node->value = values[i];
+      node->prev = last;
+      node->next = NULL;
+      if (last) {
+        last->next = node;
+      } else {
+        list->first = node;
+      }
+      last = node;
+      list->last = node;
+      list->count += 1;
+    }
+  }
+  return list;
+}
+
+mz_ArrayList *mz_linkedlist_to_array(mz_LinkedList *list) {
+  mz_ArrayList *array = mz_arraylist_new(list->count > 0 ? list->count : 1, sizeof(void *));
+  if (array) {
+    size_t i = 0;
+    for (mz_LinkedListNode *node = list->first; node != NULL; node = node->next) {
+      array->array[i++] = node->value;
+    }
+    array->size = list->count;
+  }
+  return array;
+}
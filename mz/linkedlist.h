@@ -2,6 +2,8 @@
 #define __mz_linkedlist__
 
 #include <stdlib.h>
+#include "type.h"
+#include "arraylist.h"
 
 typedef struct mz_LinkedListNode {
   struct mz_LinkedListNode *next;
@@ -10,7 +12,7 @@ typedef struct mz_LinkedListNode {
 } mz_LinkedListNode;
 
 typedef struct mz_LinkedList {
-  int count;
+  size_t count;
   mz_LinkedListNode *first;
   mz_LinkedListNode *last;
 } mz_LinkedList;
@@ -29,6 +31,68 @@ void mz_linkedlist_unshift(mz_LinkedList *list, void *value);
 
 void *mz_linkedlist_shift(mz_LinkedList *list);
 
+//O(1) node operations for callers that already know the node belongs to the list, unlike
+//remove they do not search the list. unlink detaches the node without freeing it, so it can
+//be linked again later
+void mz_linkedlist_unlink(mz_LinkedList *list, mz_LinkedListNode *node);
+
+void mz_linkedlist_link_first(mz_LinkedList *list, mz_LinkedListNode *node);
+
+void mz_linkedlist_link_last(mz_LinkedList *list, mz_LinkedListNode *node);
+
+void mz_linkedlist_move_to_front(mz_LinkedList *list, mz_LinkedListNode *node);
+
+//stable bottom-up merge sort that relinks the nodes in place. the comparator receives
+//pointers to the values, as with qsort
+bool mz_linkedlist_sort(mz_LinkedList *list, int (*mz_linkedlist_comparator_fn)(const void *, const void *));
+
+//moves every node of other in front of position, or to the end if position is NULL,
+//leaving other empty. O(1)
+void mz_linkedlist_splice(mz_LinkedList *list, mz_LinkedListNode *position, mz_LinkedList *other);
+
+void mz_linkedlist_concat(mz_LinkedList *list, mz_LinkedList *other);
+
+//moves the nodes from index on into a new list
+mz_LinkedList *mz_linkedlist_split_at(mz_LinkedList *list, size_t index);
+
+mz_LinkedList *mz_linkedlist_from_array(void **values, size_t len);
+
+mz_ArrayList *mz_linkedlist_to_array(mz_LinkedList *list);
+
+//for callers that already know list is not NULL, and for shift that it is not empty.
+//push still allocates the node and returns false if that fails, without logging
+static inline bool mz_linkedlist_push_unchecked(mz_LinkedList *list, void *value) {
+  mz_LinkedListNode *node = malloc(sizeof(mz_LinkedListNode));
+  if (!node) {
+    return false;
+  }
+  node->value = value;
+  node->next = NULL;
+  node->prev = list->last;
+  if (list->last) {
+    list->last->next = node;
+  } else {
+    list->first = node;
+  }
+  list->last = node;
+  list->count += 1;
+  return true;
+}
+
+static inline void *mz_linkedlist_shift_unchecked(mz_LinkedList *list) {
+  mz_LinkedListNode *node = list->first;
+  void *value = node->value;
+  list->first = node->next;
+  if (list->first) {
+    list->first->prev = NULL;
+  } else {
+    list->last = NULL;
+  }
+  list->count -= 1;
+  free(node);
+  return value;
+}
+
 #define mz_mLinkedList_count(A) ((A)->count)
 #define mz_m_linkedlist_first(A) ((A)->first != NULL ? (A)->first->value : NULL)
 #define mz_m_linkedlist_last(A) ((A)->last != NULL ? (A)->last->value : NULL)
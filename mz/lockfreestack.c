@@ -0,0 +1,160 @@
+#include <stdlib.h>
+#include <string.h>
+#include "lockfreestack.h"
+#include "logger.h"
+#include "type.h"
+
+uint64_t _mz_lockfreestack_top(uint64_t previous, uint32_t ref) {
+  return (((previous >> 32) + 1) << 32) | ref;
+}
+
+//segment k starts at index segment_capacity * (2^k - 1)
+mz_LockFreeStackNode *_mz_lockfreestack_node(mz_LockFreeStack *stack, uint32_t ref) {
+  size_t index = (size_t) ref - 1;
+  size_t k = (size_t) (63 - __builtin_clzll((index >> stack->segment_shift) + 1));
+  mz_LockFreeStackNode *segment = atomic_load_explicit(&stack->segments[k], memory_order_acquire);
+  return &segment[index - ((((size_t) 1 << k) - 1) << stack->segment_shift)];
+}
+
+mz_LockFreeStackNode *_mz_lockfreestack_ensure_segment(mz_LockFreeStack *stack, size_t k) {
+  mz_LockFreeStackNode *segment = atomic_load_explicit(&stack->segments[k], memory_order_acquire);
+  if (!segment) {
+    mz_LockFreeStackNode *allocated = calloc((size_t) 1 << (stack->segment_shift + k), sizeof(mz_LockFreeStackNode));
+    if (!allocated) {
+      ERROR("could not allocate memory for segment %zu", k);
+    } else if (atomic_compare_exchange_strong_explicit(&stack->segments[k], &segment, allocated,
+                                                       memory_order_acq_rel, memory_order_acquire)) {
+      segment = allocated;
+    } else {
+      //another thread installed the segment first
+      free(allocated);
+    }
+  }
+  return segment;
+}
+
+//pushes the chain first..last, which the caller owns, in one compare-exchange
+void _mz_lockfreestack_push_chain(mz_LockFreeStack *stack, _Atomic uint64_t *top, uint32_t first, uint32_t last) {
+  mz_LockFreeStackNode *node = _mz_lockfreestack_node(stack, last);
+  uint64_t previous = atomic_load_explicit(top, memory_order_relaxed);
+  do {
+    atomic_store_explicit(&node->next, (uint32_t) previous, memory_order_relaxed);
+  } while (!atomic_compare_exchange_weak_explicit(top, &previous, _mz_lockfreestack_top(previous, first),
+                                                  memory_order_release, memory_order_relaxed));
+}
+
+uint32_t _mz_lockfreestack_pop_node(mz_LockFreeStack *stack, _Atomic uint64_t *top) {
+  uint64_t previous = atomic_load_explicit(top, memory_order_acquire);
+  while ((uint32_t) previous != 0) {
+    //the node may be popped and reused meanwhile, then next is stale but the tag has moved on
+    uint32_t next = atomic_load_explicit(&_mz_lockfreestack_node(stack, (uint32_t) previous)->next,
+                                         memory_order_relaxed);
+    if (atomic_compare_exchange_weak_explicit(top, &previous, _mz_lockfreestack_top(previous, next),
+                                              memory_order_acquire, memory_order_acquire)) {
+      return (uint32_t) previous;
+    }
+  }
+  return 0;
+}
+
+//recycles a popped node or allocates a new one, returns 0 on failure
+uint32_t _mz_lockfreestack_take_node(mz_LockFreeStack *stack) {
+  uint32_t ref = _mz_lockfreestack_pop_node(stack, &stack->free_nodes);
+  if (ref == 0) {
+    size_t index = atomic_fetch_add_explicit(&stack->allocated, 1, memory_order_relaxed);
+    size_t k = (size_t) (63 - __builtin_clzll((index >> stack->segment_shift) + 1));
+    if (index >= UINT32_MAX - 1 || k >= MZ_LOCKFREESTACK_MAX_SEGMENTS) {
+      ERROR("lockfreestack is out of node references");
+    } else if (_mz_lockfreestack_ensure_segment(stack, k)) {
+      ref = (uint32_t) (index + 1);
+    }
+  }
+  return ref;
+}
+
+mz_LockFreeStack *mz_lockfreestack_new(size_t segment_capacity) {
+  mz_LockFreeStack *stack = NULL;
+  if (segment_capacity < 1) {
+    ERROR("invalid segment_capacity for lockfreestack. segment_capacity must be greater than 1");
+  } else if (posix_memalign((void **) &stack, MZ_CACHE_LINE_SIZE, sizeof(mz_LockFreeStack)) != 0) {
+    ERROR("could not allocate memory for lockfreestack");
+    stack = NULL;
+  } else {
+    memset(stack, 0, sizeof(mz_LockFreeStack));
+    stack->segment_shift = 0;
+    while (((size_t) 1 << stack->segment_shift) < segment_capacity) {
+      stack->segment_shift += 1;
+    }
+    for (size_t k = 0; k < MZ_LOCKFREESTACK_MAX_SEGMENTS; k++) {
+      atomic_init(&stack->segments[k], NULL);
+    }
+    atomic_init(&stack->allocated, 0);
+    atomic_init(&stack->head, 0);
+    atomic_init(&stack->free_nodes, 0);
+  }
+  return stack;
+}
+
+void mz_lockfreestack_free(mz_LockFreeStack *stack) {
+  if (stack) {
+    for (size_t k = 0; k < MZ_LOCKFREESTACK_MAX_SEGMENTS; k++) {
+      free(atomic_load_explicit(&stack->segments[k], memory_order_relaxed));
+    }
+    free(stack);
+  }
+}
+
+bool mz_lockfreestack_push(mz_LockFreeStack *stack, void *value) {
+  bool result = false;
+  uint32_t ref = _mz_lockfreestack_take_node(stack);
+  if (ref == 0) {
+    ERROR("could not allocate node for lockfreestack");
+  } else {
+    _mz_lockfreestack_node(stack, ref)->value = value;
+    _mz_lockfreestack_push_chain(stack, &stack->head, ref, ref);
+    result = true;
+  }
+  return result;
+}
+
+bool mz_lockfreestack_pop(mz_LockFreeStack *stack, void **value) {
+  uint32_t ref = _mz_lockfreestack_pop_node(stack, &stack->head);
+  if (ref == 0) {
+    return false;
+  }
+  *value = _mz_lockfreestack_node(stack, ref)->value;
+  _mz_lockfreestack_push_chain(stack, &stack->free_nodes, ref, ref);
+  return true;
+}
+
+bool mz_lockfreestack_pop_all(mz_LockFreeStack *stack, mz_ArrayList *list) {
+  bool result = false;
+  uint64_t previous = atomic_load_explicit(&stack->head, memory_order_relaxed);
+  do {
+    if ((uint32_t) previous == 0) {
+      return true;
+    }
+  } while (!atomic_compare_exchange_weak_explicit(&stack->head, &previous, _mz_lockfreestack_top(previous, 0),
+                                                  memory_order_acquire, memory_order_relaxed));
+  //the detached chain belongs to this thread now
+  uint32_t first = (uint32_t) previous;
+  uint32_t last = first;
+  size_t count = 1;
+  for (uint32_t next; (next = atomic_load_explicit(&_mz_lockfreestack_node(stack, last)->next,
+                                                   memory_order_relaxed)) != 0; last = next) {
+    count += 1;
+  }
+  if (!mz_arraylist_reserve(list, list->size + count)) {
+    //put the elements back rather than lose them
+    ERROR("could not reserve arraylist capacity");
+    _mz_lockfreestack_push_chain(stack, &stack->head, first, last);
+  } else {
+    for (uint32_t ref = first; ref != 0;
+         ref = atomic_load_explicit(&_mz_lockfreestack_node(stack, ref)->next, memory_order_relaxed)) {
+      mz_arraylist_append(list, _mz_lockfreestack_node(stack, ref)->value);
+    }
+    _mz_lockfreestack_push_chain(stack, &stack->free_nodes, first, last);
+    result = true;
+  }
+  return result;
+}
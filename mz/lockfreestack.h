@@ -0,0 +1,50 @@
+#ifndef __mz_lockfreestack__
+#define __mz_lockfreestack__
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include "type.h"
+#include "arraylist.h"
+
+#define MZ_LOCKFREESTACK_MAX_SEGMENTS 32
+
+//lock-free LIFO for any number of threads, meant for shared free lists.
+//nodes live in segments that double in size and are never freed, and popped nodes are
+//recycled through a second stack. the tops pack a 32-bit node reference (index + 1, 0 for
+//none) with a 32-bit tag bumped on every change, so a node that is popped and pushed back
+//between another thread's load and compare-exchange cannot be mistaken for an unchanged top
+typedef struct mz_LockFreeStackNode {
+  void *value;
+  atomic_uint_least32_t next;
+} mz_LockFreeStackNode;
+
+typedef struct mz_LockFreeStack {
+  size_t segment_shift;
+  _Atomic(mz_LockFreeStackNode *) segments[MZ_LOCKFREESTACK_MAX_SEGMENTS];
+  _Alignas(MZ_CACHE_LINE_SIZE) atomic_size_t allocated;
+  _Alignas(MZ_CACHE_LINE_SIZE) _Atomic uint64_t head;
+  _Alignas(MZ_CACHE_LINE_SIZE) _Atomic uint64_t free_nodes;
+  char padding[MZ_CACHE_LINE_SIZE - sizeof(uint64_t)];
+} mz_LockFreeStack;
+
+//segment_capacity is rounded up to a power of two
+mz_LockFreeStack *mz_lockfreestack_new(size_t segment_capacity);
+
+void mz_lockfreestack_free(mz_LockFreeStack *stack);
+
+//returns false if no node could be allocated
+bool mz_lockfreestack_push(mz_LockFreeStack *stack, void *value);
+
+//returns false if the stack is empty
+bool mz_lockfreestack_pop(mz_LockFreeStack *stack, void **value);
+
+//detaches every element with one compare-exchange and appends them to list, top first
+bool mz_lockfreestack_pop_all(mz_LockFreeStack *stack, mz_ArrayList *list);
+
+//only a snapshot while other threads are pushing or popping
+static inline bool mz_lockfreestack_is_empty(mz_LockFreeStack *stack) {
+  return (uint32_t) atomic_load_explicit(&stack->head, memory_order_relaxed) == 0;
+}
+
+#endif
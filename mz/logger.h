@@ -10,10 +10,23 @@
 #include <string.h>
 
 #define CLEAN_ERRNO() (errno == 0 ? "None" : strerror(errno))
+
+//with MZ_ASYNC_LOG the calling thread only captures the arguments, the writer thread of
+//mz/asynclog.h formats and writes them once it is started
+#ifdef MZ_ASYNC_LOG
+#include "asynclog.h"
+#define _MZ_ASYNC_LOG(L, M, ...) mz_asynclog_log(L, __FILE__, __LINE__, errno, M, ##__VA_ARGS__)
+#define ERROR(M, ...) _MZ_ASYNC_LOG(mz_AsyncLogLevelError, M, ##__VA_ARGS__)
+#else
 #define ERROR(M, ...) fprintf(stderr, "[ERROR] (%s:%d: errno: %s) " M "\n", __FILE__, __LINE__, CLEAN_ERRNO(), ##__VA_ARGS__)
+#endif
 
 #ifndef nodebug
+#ifdef MZ_ASYNC_LOG
+#define DEBUG(M, ...) _MZ_ASYNC_LOG(mz_AsyncLogLevelDebug, M, ##__VA_ARGS__)
+#else
 #define DEBUG(M, ...) fprintf(stderr, "[DEBUG] %s:%d: " M "\n", __FILE__, __LINE__, ##__VA_ARGS__)
+#endif
 #else
 #define DEBUG(M, ...)
 #endif
@@ -22,13 +35,17 @@
 #define loglevel LOGLEVEL_INFO
 #endif
 
-#if loglevel >= LOGLEVEL_WARN
+#if loglevel >= LOGLEVEL_WARN && defined(MZ_ASYNC_LOG)
+#define WARN(M, ...) _MZ_ASYNC_LOG(mz_AsyncLogLevelWarn, M, ##__VA_ARGS__)
+#elif loglevel >= LOGLEVEL_WARN
 #define WARN(M, ...) fprintf(stderr, "[WARN] (%s:%d: errno: %s) " M "\n", __FILE__, __LINE__, CLEAN_ERRNO(), ##__VA_ARGS__)
 #else
 #define WARN(M, ...)
 #endif
 
-#if loglevel == LOGLEVEL_INFO
+#if loglevel == LOGLEVEL_INFO && defined(MZ_ASYNC_LOG)
+#define INFO(M, ...) _MZ_ASYNC_LOG(mz_AsyncLogLevelInfo, M, ##__VA_ARGS__)
+#elif loglevel == LOGLEVEL_INFO
 #define INFO(M, ...) fprintf(stderr, "[INFO] (%s:%d:) " M "\n", __FILE__, __LINE__, ##__VA_ARGS__)
 #else
 #define INFO(M, ...)
@@ -0,0 +1,102 @@
+#include <stdlib.h>
+#include "losertree.h"
+#include "logger.h"
+#include "type.h"
+
+//whether source a beats source b
+bool _mz_losertree_beats(mz_LoserTree *tree, size_t a, size_t b) {
+  if (tree->exhausted[a] || tree->exhausted[b]) {
+    return tree->exhausted[a] == tree->exhausted[b] ? a < b : tree->exhausted[b];
+  }
+  int comparison = (*tree->comparator_fn)(&tree->keys[a], &tree->keys[b]);
+  return comparison < 0 || (comparison == 0 && a < b);
+}
+
+//returns the winner below node. nodes 1..k-1 are inner nodes with children 2n and 2n+1,
+//node k + i stands for source i
+size_t _mz_losertree_play(mz_LoserTree *tree, size_t node) {
+  if (node >= tree->k) {
+    return node - tree->k;
+  }
+  size_t left = _mz_losertree_play(tree, 2 * node);
+  size_t right = _mz_losertree_play(tree, 2 * node + 1);
+  if (_mz_losertree_beats(tree, left, right)) {
+    tree->nodes[node] = right;
+    return left;
+  }
+  tree->nodes[node] = left;
+  return right;
+}
+
+//replays the matches from the winner's leaf to the root
+void _mz_losertree_replay(mz_LoserTree *tree) {
+  size_t winner = tree->nodes[0];
+  for (size_t node = (winner + tree->k) / 2; node > 0; node /= 2) {
+    if (_mz_losertree_beats(tree, tree->nodes[node], winner)) {
+      size_t loser = winner;
+      winner = tree->nodes[node];
+      tree->nodes[node] = loser;
+    }
+  }
+  tree->nodes[0] = winner;
+}
+
+mz_LoserTree *mz_losertree_new(size_t k, int (*mz_losertree_comparator_fn)(const void *, const void *)) {
+  mz_LoserTree *tree = NULL;
+  if (k < 1) {
+    ERROR("invalid k for losertree. k must be at least 1");
+  } else {
+    tree = calloc(1, sizeof(mz_LoserTree));
+    if (!tree) {
+      ERROR("could not allocate memory for losertree");
+    } else {
+      tree->k = k;
+      tree->comparator_fn = mz_losertree_comparator_fn;
+      tree->nodes = calloc(k, sizeof(size_t));
+      tree->keys = calloc(k, sizeof(void *));
+      tree->exhausted = malloc(k * sizeof(bool));
+      if (!tree->nodes || !tree->keys || !tree->exhausted) {
+        ERROR("could not allocate memory for losertree nodes");
+        mz_losertree_free(tree);
+        tree = NULL;
+      } else {
+        for (size_t i = 0; i < k; i++) {
+          tree->exhausted[i] = true;
+        }
+      }
+    }
+  }
+  return tree;
+}
+
+void mz_losertree_free(mz_LoserTree *tree) {
+  if (tree) {
+    free(tree->nodes);
+    free(tree->keys);
+    free(tree->exhausted);
+    free(tree);
+  }
+}
+
+void mz_losertree_set(mz_LoserTree *tree, size_t source, void *key) {
+  if (source >= tree->k) {
+    ERROR("source is out of range - %zu", source);
+  } else {
+    tree->keys[source] = key;
+    tree->exhausted[source] = false;
+  }
+}
+
+void mz_losertree_build(mz_LoserTree *tree) {
+  tree->nodes[0] = tree->k == 1 ? 0 : _mz_losertree_play(tree, 1);
+}
+
+void mz_losertree_replace_winner(mz_LoserTree *tree, void *key) {
+  tree->keys[tree->nodes[0]] = key;
+  _mz_losertree_replay(tree);
+}
+
+void mz_losertree_exhaust_winner(mz_LoserTree *tree) {
+  tree->exhausted[tree->nodes[0]] = true;
+  _mz_losertree_replay(tree);
+}
@@ -0,0 +1,46 @@
+#ifndef __mz_losertree__
+#define __mz_losertree__
+
+#include <stdlib.h>
+#include "type.h"
+
+//tournament tree for k-way merges. every inner node remembers the loser of the match
+//played there and node 0 the overall winner, so replacing the winner's key replays
+//a single leaf-to-root path of log2(k) comparisons. ties go to the lower source and
+//exhausted sources lose every match, which makes merges stable
+typedef struct mz_LoserTree {
+  size_t k;
+  int (*comparator_fn)(const void *, const void *);
+  size_t *nodes;
+  void **keys;
+  bool *exhausted;
+} mz_LoserTree;
+
+//the comparator follows mz_arraylist_sort and receives pointers to the two keys.
+//every source starts exhausted
+mz_LoserTree *mz_losertree_new(size_t k, int (*mz_losertree_comparator_fn)(const void *, const void *));
+
+void mz_losertree_free(mz_LoserTree *tree);
+
+//sets the first key of a source, before mz_losertree_build
+void mz_losertree_set(mz_LoserTree *tree, size_t source, void *key);
+
+//plays every match, O(k)
+void mz_losertree_build(mz_LoserTree *tree);
+
+//replaces the winner's key with the next key of its source
+void mz_losertree_replace_winner(mz_LoserTree *tree, void *key);
+
+//marks the winner's source as having no more keys
+void mz_losertree_exhaust_winner(mz_LoserTree *tree);
+
+//the source holding the smallest key, or MZ_NPOS once every source is exhausted
+static inline size_t mz_losertree_winner(mz_LoserTree *tree) {
+  return tree->exhausted[tree->nodes[0]] ? MZ_NPOS : tree->nodes[0];
+}
+
+static inline void *mz_losertree_winner_key(mz_LoserTree *tree) {
+  return tree->keys[tree->nodes[0]];
+}
+
+#endif
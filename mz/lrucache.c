@@ -0,0 +1,307 @@
+#include <stdlib.h>
+#include <string.h>
+#include "lrucache.h"
+#include "logger.h"
+#include "type.h"
+
+mz_LruCacheEntry *_mz_lrucache_find(mz_LruCache *cache, const void *key) {
+  void *entry = NULL;
+  return mz_hashmap_get(cache->index, key, &entry) ? entry : NULL;
+}
+
+//unlinks the entry and keeps its allocation for the next put
+void _mz_lrucache_drop(mz_LruCache *cache, mz_LruCacheEntry *entry) {
+  mz_hashmap_remove(cache->index, entry->key);
+  mz_linkedlist_unlink(cache->recency, &entry->node);
+  cache->bytes -= entry->bytes;
+  if (cache->spare) {
+    free(entry);
+  } else {
+    cache->spare = entry;
+  }
+}
+
+void _mz_lrucache_evict_last(mz_LruCache *cache) {
+  mz_LruCacheEntry *entry = (mz_LruCacheEntry *) cache->recency->last;
+  void *key = entry->key;
+  void *value = entry->value;
+  _mz_lrucache_drop(cache, entry);
+  cache->evictions++;
+  if (cache->evict_fn) {
+    (*cache->evict_fn)(cache->evict_context, key, value);
+  }
+}
+
+//evicts until extra more entries and bytes fit
+void _mz_lrucache_make_room(mz_LruCache *cache, size_t entries, size_t bytes) {
+  while (cache->recency->count > 0 &&
+         ((cache->capacity && cache->recency->count + entries > cache->capacity) ||
+          (cache->max_bytes && cache->bytes + bytes > cache->max_bytes))) {
+    _mz_lrucache_evict_last(cache);
+  }
+}
+
+mz_LruCache *mz_lrucache_new(size_t capacity, uint64_t (*mz_lrucache_hash_fn)(const void *),
+                             bool (*mz_lrucache_equal_fn)(const void *, const void *)) {
+  mz_LruCache *cache = NULL;
+  if (!mz_lrucache_hash_fn || !mz_lrucache_equal_fn) {
+    ERROR("lrucache needs a hash and an equal function");
+  } else {
+    cache = calloc(1, sizeof(mz_LruCache));
+    if (!cache) {
+      ERROR("could not allocate memory for lrucache");
+    } else {
+      cache->capacity = capacity;
+      //the index never needs to grow past a bounded cache
+      size_t initial_capacity = capacity > 0 && capacity < 1024 ? capacity : 16;
+      cache->index = mz_hashmap_new(initial_capacity, mz_lrucache_hash_fn, mz_lrucache_equal_fn);
+      cache->recency = mz_linkedlist_new();
+      if (!cache->index || !cache->recency) {
+        ERROR("could not allocate memory for lrucache");
+        mz_lrucache_free(cache);
+        cache = NULL;
+      }
+    }
+  }
+  return cache;
+}
+
+void mz_lrucache_free(mz_LruCache *cache) {
+  if (cache) {
+    if (cache->recency) {
+      if (cache->evict_fn) {
+        mz_m_linkedlist_foreach(cache->recency, first, next, node) {
+          mz_LruCacheEntry *entry = (mz_LruCacheEntry *) node;
+          (*cache->evict_fn)(cache->evict_context, entry->key, entry->value);
+        }
+      }
+      mz_linkedlist_free(cache->recency);
+    }
+    if (cache->index) {
+      mz_hashmap_free(cache->index);
+    }
+    free(cache->spare);
+    free(cache);
+  }
+}
+
+bool mz_lrucache_set_byte_limit(mz_LruCache *cache, size_t max_bytes,
+                                size_t (*mz_lrucache_size_fn)(const void *key, const void *value)) {
+  bool result = false;
+  if (!mz_lrucache_size_fn) {
+    ERROR("lrucache byte limit needs a size function");
+  } else {
+    cache->max_bytes = max_bytes;
+    cache->size_fn = mz_lrucache_size_fn;
+    cache->bytes = 0;
+    mz_m_linkedlist_foreach(cache->recency, first, next, node) {
+      mz_LruCacheEntry *entry = (mz_LruCacheEntry *) node;
+      entry->bytes = (*cache->size_fn)(entry->key, entry->value);
+      cache->bytes += entry->bytes;
+    }
+    _mz_lrucache_make_room(cache, 0, 0);
+    result = true;
+  }
+  return result;
+}
+
+void mz_lrucache_set_evict_fn(mz_LruCache *cache, void (*mz_lrucache_evict_fn)(void *context, void *key, void *value),
+                              void *context) {
+  cache->evict_fn = mz_lrucache_evict_fn;
+  cache->evict_context = context;
+}
+
+bool mz_lrucache_get(mz_LruCache *cache, const void *key, void **value) {
+  mz_LruCacheEntry *entry = _mz_lrucache_find(cache, key);
+  if (!entry) {
+    cache->misses++;
+    return false;
+  }
+  cache->hits++;
+  mz_linkedlist_move_to_front(cache->recency, &entry->node);
+  if (value) {
+    *value = entry->value;
+  }
+  return true;
+}
+
+bool mz_lrucache_peek(mz_LruCache *cache, const void *key, void **value) {
+  mz_LruCacheEntry *entry = _mz_lrucache_find(cache, key);
+  if (entry && value) {
+    *value = entry->value;
+  }
+  return entry != NULL;
+}
+
+bool mz_lrucache_put(mz_LruCache *cache, void *key, void *value) {
+  bool result = false;
+  size_t bytes = cache->size_fn ? (*cache->size_fn)(key, value) : 0;
+  mz_LruCacheEntry *entry = _mz_lrucache_find(cache, key);
+  if (cache->max_bytes && bytes > cache->max_bytes) {
+    ERROR("entry of %zu bytes is larger than the lrucache", bytes);
+  } else if (entry) {
+    mz_linkedlist_move_to_front(cache->recency, &entry->node);
+    cache->bytes -= entry->bytes;
+    entry->value = value;
+    entry->bytes = bytes;
+    cache->bytes += bytes;
+    //only the other entries can be evicted, the replaced one is the most recent now
+    while (cache->max_bytes && cache->bytes > cache->max_bytes) {
+      _mz_lrucache_evict_last(cache);
+    }
+    result = true;
+  } else {
+    _mz_lrucache_make_room(cache, 1, bytes);
+    if (cache->spare) {
+      entry = cache->spare;
+      cache->spare = NULL;
+    } else {
+      entry = malloc(sizeof(mz_LruCacheEntry));
+    }
+    if (!entry) {
+      ERROR("could not allocate memory for lrucache entry");
+    } else if (!mz_hashmap_put(cache->index, key, entry)) {
+      ERROR("could not index lrucache entry");
+      cache->spare = entry;
+    } else {
+      entry->node.value = entry;
+      entry->key = key;
+      entry->value = value;
+      entry->bytes = bytes;
+      mz_linkedlist_link_first(cache->recency, &entry->node);
+      cache->bytes += bytes;
+      result = true;
+    }
+  }
+  return result;
+}
+
+bool mz_lrucache_remove(mz_LruCache *cache, const void *key, void **value) {
+  mz_LruCacheEntry *entry = _mz_lrucache_find(cache, key);
+  if (!entry) {
+    return false;
+  }
+  if (value) {
+    *value = entry->value;
+  }
+  _mz_lrucache_drop(cache, entry);
+  return true;
+}
+
+bool mz_lrucache_evict(mz_LruCache *cache) {
+  if (cache->recency->count == 0) {
+    return false;
+  }
+  _mz_lrucache_evict_last(cache);
+  return true;
+}
+
+mz_ShardedLruCache *mz_shardedlrucache_new(size_t shard_count, size_t capacity,
+                                           uint64_t (*mz_lrucache_hash_fn)(const void *),
+                                           bool (*mz_lrucache_equal_fn)(const void *, const void *)) {
+  mz_ShardedLruCache *cache = NULL;
+  if (shard_count < 1) {
+    ERROR("invalid shard_count for shardedlrucache. shard_count must be at least 1");
+  } else if (!mz_lrucache_hash_fn || !mz_lrucache_equal_fn) {
+    ERROR("shardedlrucache needs a hash and an equal function");
+  } else if (!(cache = calloc(1, sizeof(mz_ShardedLruCache)))) {
+    ERROR("could not allocate memory for shardedlrucache");
+  } else {
+    size_t rounded = 1;
+    while (rounded < shard_count) {
+      rounded *= 2;
+      cache->shard_bits++;
+    }
+    cache->shard_count = rounded;
+    cache->hash_fn = mz_lrucache_hash_fn;
+    if (posix_memalign((void **) &cache->shards, MZ_CACHE_LINE_SIZE, rounded * sizeof(mz_LruCacheShard)) != 0) {
+      ERROR("could not allocate memory for shardedlrucache->shards");
+      free(cache);
+      return NULL;
+    }
+    size_t shard_capacity = capacity > 0 ? (capacity + rounded - 1) / rounded : 0;
+    for (size_t i = 0; i < rounded; i++) {
+      pthread_mutex_init(&cache->shards[i].lock, NULL);
+      cache->shards[i].cache = mz_lrucache_new(shard_capacity, mz_lrucache_hash_fn, mz_lrucache_equal_fn);
+      if (!cache->shards[i].cache) {
+        cache->shard_count = i + 1;
+        mz_shardedlrucache_free(cache);
+        return NULL;
+      }
+    }
+  }
+  return cache;
+}
+
+void mz_shardedlrucache_free(mz_ShardedLruCache *cache) {
+  if (cache) {
+    for (size_t i = 0; i < cache->shard_count; i++) {
+      mz_lrucache_free(cache->shards[i].cache);
+      pthread_mutex_destroy(&cache->shards[i].lock);
+    }
+    free(cache->shards);
+    free(cache);
+  }
+}
+
+mz_LruCacheShard *_mz_shardedlrucache_shard(mz_ShardedLruCache *cache, const void *key) {
+  //fibonacci hashing takes the high bits, the shard maps themselves use the low ones
+  uint64_t hash = (*cache->hash_fn)(key) * 0x9e3779b97f4a7c15ULL;
+  return &cache->shards[cache->shard_bits > 0 ? hash >> (64 - cache->shard_bits) : 0];
+}
+
+bool mz_shardedlrucache_set_byte_limit(mz_ShardedLruCache *cache, size_t max_bytes,
+                                       size_t (*mz_lrucache_size_fn)(const void *key, const void *value)) {
+  bool result = true;
+  size_t shard_bytes = max_bytes > 0 ? (max_bytes + cache->shard_count - 1) / cache->shard_count : 0;
+  for (size_t i = 0; i < cache->shard_count; i++) {
+    pthread_mutex_lock(&cache->shards[i].lock);
+    result = mz_lrucache_set_byte_limit(cache->shards[i].cache, shard_bytes, mz_lrucache_size_fn) && result;
+    pthread_mutex_unlock(&cache->shards[i].lock);
+  }
+  return result;
+}
+
+void mz_shardedlrucache_set_evict_fn(mz_ShardedLruCache *cache,
+                                     void (*mz_lrucache_evict_fn)(void *context, void *key, void *value),
+                                     void *context) {
+  for (size_t i = 0; i < cache->shard_count; i++) {
+    pthread_mutex_lock(&cache->shards[i].lock);
+    mz_lrucache_set_evict_fn(cache->shards[i].cache, mz_lrucache_evict_fn, context);
+    pthread_mutex_unlock(&cache->shards[i].lock);
+  }
+}
+
+bool mz_shardedlrucache_get(mz_ShardedLruCache *cache, const void *key, void **value) {
+  mz_LruCacheShard *shard = _mz_shardedlrucache_shard(cache, key);
+  pthread_mutex_lock(&shard->lock);
+  bool result = mz_lrucache_get(shard->cache, key, value);
+  pthread_mutex_unlock(&shard->lock);
+  return result;
+}
+
+bool mz_shardedlrucache_put(mz_ShardedLruCache *cache, void *key, void *value) {
+  mz_LruCacheShard *shard = _mz_shardedlrucache_shard(cache, key);
+  pthread_mutex_lock(&shard->lock);
+  bool result = mz_lrucache_put(shard->cache, key, value);
+  pthread_mutex_unlock(&shard->lock);
+  return result;
+}
+
+bool mz_shardedlrucache_remove(mz_ShardedLruCache *cache, const void *key, void **value) {
+  mz_LruCacheShard *shard = _mz_shardedlrucache_shard(cache, key);
+  pthread_mutex_lock(&shard->lock);
+  bool result = mz_lrucache_remove(shard->cache, key, value);
+  pthread_mutex_unlock(&shard->lock);
+  return result;
+}
+
+size_t mz_shardedlrucache_size(mz_ShardedLruCache *cache) {
+  size_t size = 0;
+  for (size_t i = 0; i < cache->shard_count; i++) {
+    pthread_mutex_lock(&cache->shards[i].lock);
+    size += mz_lrucache_size(cache->shards[i].cache);
+    pthread_mutex_unlock(&cache->shards[i].lock);
+  }
+  return size;
+}
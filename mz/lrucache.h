@@ -0,0 +1,119 @@
+#ifndef __mz_lrucache__
+#define __mz_lrucache__
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "type.h"
+#include "linkedlist.h"
+#include "hashmap.h"
+
+//the list node is the first member, so an entry is a node of the recency list and
+//freeing the node frees the entry
+typedef struct mz_LruCacheEntry {
+  mz_LinkedListNode node;
+  void *key;
+  void *value;
+  size_t bytes;
+} mz_LruCacheEntry;
+
+//least recently used cache. the hash map finds the entry of a key and the recency list keeps
+//entries most recently used first, so get, put and eviction are O(1). a hit relinks the entry
+//at the front without allocating, and the entry of an evicted key is reused by the next put
+typedef struct mz_LruCache {
+  //0 means no limit
+  size_t capacity;
+  size_t max_bytes;
+  size_t bytes;
+  size_t (*size_fn)(const void *key, const void *value);
+  void (*evict_fn)(void *context, void *key, void *value);
+  void *evict_context;
+  mz_HashMap *index;
+  mz_LinkedList *recency;
+  mz_LruCacheEntry *spare;
+  size_t hits;
+  size_t misses;
+  size_t evictions;
+} mz_LruCache;
+
+typedef struct mz_LruCacheShard {
+  _Alignas(MZ_CACHE_LINE_SIZE) pthread_mutex_t lock;
+  mz_LruCache *cache;
+} mz_LruCacheShard;
+
+//independent caches behind a mutex each, a key always goes to the same shard so
+//threads working on different keys rarely wait for each other
+typedef struct mz_ShardedLruCache {
+  size_t shard_count;
+  unsigned shard_bits;
+  uint64_t (*hash_fn)(const void *key);
+  mz_LruCacheShard *shards;
+} mz_ShardedLruCache;
+
+//capacity is the maximum number of entries, 0 for no limit
+mz_LruCache *mz_lrucache_new(size_t capacity, uint64_t (*mz_lrucache_hash_fn)(const void *),
+                             bool (*mz_lrucache_equal_fn)(const void *, const void *));
+
+//hands every entry still cached to the evict callback
+void mz_lrucache_free(mz_LruCache *cache);
+
+//also bounds the sum of size_fn over all entries, evicting until the cache fits
+bool mz_lrucache_set_byte_limit(mz_LruCache *cache, size_t max_bytes,
+                                size_t (*mz_lrucache_size_fn)(const void *key, const void *value));
+
+//called with every entry evicted to make room
+void mz_lrucache_set_evict_fn(mz_LruCache *cache, void (*mz_lrucache_evict_fn)(void *context, void *key, void *value),
+                              void *context);
+
+//marks the entry as most recently used, returns false if the key is missing
+bool mz_lrucache_get(mz_LruCache *cache, const void *key, void **value);
+
+//like get but leaves the recency order and the statistics alone
+bool mz_lrucache_peek(mz_LruCache *cache, const void *key, void **value);
+
+//inserts the entry as most recently used, evicting least recently used ones until it fits.
+//for a key already cached the stored key is kept and only the value is replaced, without
+//calling the evict callback. returns false if the entry is larger than the byte limit
+bool mz_lrucache_put(mz_LruCache *cache, void *key, void *value);
+
+//removes the entry without calling the evict callback, value may be NULL
+bool mz_lrucache_remove(mz_LruCache *cache, const void *key, void **value);
+
+//evicts the least recently used entry, returns false if the cache is empty
+bool mz_lrucache_evict(mz_LruCache *cache);
+
+static inline size_t mz_lrucache_size(mz_LruCache *cache) {
+  return cache->recency->count;
+}
+
+static inline bool mz_lrucache_contains(mz_LruCache *cache, const void *key) {
+  return mz_hashmap_index_of(cache->index, key) != MZ_NPOS;
+}
+
+//shard_count is rounded up to a power of two, the limits are split evenly between shards
+mz_ShardedLruCache *mz_shardedlrucache_new(size_t shard_count, size_t capacity,
+                                           uint64_t (*mz_lrucache_hash_fn)(const void *),
+                                           bool (*mz_lrucache_equal_fn)(const void *, const void *));
+
+void mz_shardedlrucache_free(mz_ShardedLruCache *cache);
+
+bool mz_shardedlrucache_set_byte_limit(mz_ShardedLruCache *cache, size_t max_bytes,
+                                       size_t (*mz_lrucache_size_fn)(const void *key, const void *value));
+
+//the callback runs with the lock of the shard held
+void mz_shardedlrucache_set_evict_fn(mz_ShardedLruCache *cache,
+                                     void (*mz_lrucache_evict_fn)(void *context, void *key, void *value),
+                                     void *context);
+
+//the value is returned after the lock is released, so an evict callback that frees values
+//needs some other way to keep them alive, such as reference counts
+bool mz_shardedlrucache_get(mz_ShardedLruCache *cache, const void *key, void **value);
+
+bool mz_shardedlrucache_put(mz_ShardedLruCache *cache, void *key, void *value);
+
+bool mz_shardedlrucache_remove(mz_ShardedLruCache *cache, const void *key, void **value);
+
+//only a snapshot while other threads use the cache
+size_t mz_shardedlrucache_size(mz_ShardedLruCache *cache);
+
+#endif
@@ -0,0 +1,97 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "mpmcqueue.h"
+#include "logger.h"
+#include "type.h"
+
+mz_MpmcQueue *mz_mpmcqueue_new(size_t capacity) {
+  mz_MpmcQueue *queue = NULL;
+  if (capacity < 2) {
+    ERROR("invalid capacity for mpmcqueue. capacity must be at least 2");
+  } else if (posix_memalign((void **) &queue, MZ_CACHE_LINE_SIZE, sizeof(mz_MpmcQueue)) != 0) {
+    ERROR("could not allocate memory for mpmcqueue");
+    queue = NULL;
+  } else {
+    size_t rounded = 2;
+    while (rounded < capacity) {
+      rounded *= 2;
+    }
+    memset(queue, 0, sizeof(mz_MpmcQueue));
+    queue->capacity = rounded;
+    queue->mask = rounded - 1;
+    if (posix_memalign((void **) &queue->cells, MZ_CACHE_LINE_SIZE, rounded * sizeof(mz_MpmcQueueCell)) != 0) {
+      ERROR("could not allocate memory for mpmcqueue->cells");
+      free(queue);
+      queue = NULL;
+    } else {
+      for (size_t i = 0; i < rounded; i++) {
+        atomic_init(&queue->cells[i].sequence, i);
+        queue->cells[i].value = NULL;
+      }
+      atomic_init(&queue->tail, 0);
+      atomic_init(&queue->head, 0);
+    }
+  }
+  return queue;
+}
+
+void mz_mpmcqueue_free(mz_MpmcQueue *queue) {
+  if (queue) {
+    free(queue->cells);
+    free(queue);
+  }
+}
+
+bool mz_mpmcqueue_push(mz_MpmcQueue *queue, void *value) {
+  size_t position = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+  for (;;) {
+    mz_MpmcQueueCell *cell = &queue->cells[position & queue->mask];
+    size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+    intptr_t difference = (intptr_t) sequence - (intptr_t) position;
+    if (difference == 0) {
+      //the cell is free for this lap, try to claim it
+      if (atomic_compare_exchange_weak_explicit(&queue->tail, &position, position + 1,
+                                                memory_order_relaxed, memory_order_relaxed)) {
+        cell->value = value;
+        atomic_store_explicit(&cell->sequence, position + 1, memory_order_release);
+        return true;
+      }
+    } else if (difference < 0) {
+      //the cell still holds a value from the previous lap
+      return false;
+    } else {
+      position = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    }
+  }
+}
+
+bool mz_mpmcqueue_shift(mz_MpmcQueue *queue, void **value) {
+  size_t position = atomic_load_explicit(&queue->head, memory_order_relaxed);
+  for (;;) {
+    mz_MpmcQueueCell *cell = &queue->cells[position & queue->mask];
+    size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+    intptr_t difference = (intptr_t) sequence - (intptr_t) (position + 1);
+    if (difference == 0) {
+      //the cell has been published, try to claim it
+      if (atomic_compare_exchange_weak_explicit(&queue->head, &position, position + 1,
+                                                memory_order_relaxed, memory_order_relaxed)) {
+        *value = cell->value;
+        //hand the cell to the producer of the next lap
+        atomic_store_explicit(&cell->sequence, position + queue->mask + 1, memory_order_release);
+        return true;
+      }
+    } else if (difference < 0) {
+      //nothing has been pushed into this cell yet
+      return false;
+    } else {
+      position = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    }
+  }
+}
+
+size_t mz_mpmcqueue_size(mz_MpmcQueue *queue) {
+  size_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+  size_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+  return tail > head ? tail - head : 0;
+}
@@ -0,0 +1,43 @@
+#ifndef __mz_mpmcqueue__
+#define __mz_mpmcqueue__
+
+#include <stdlib.h>
+#include <stdatomic.h>
+#include "type.h"
+
+//bounded lock-free queue for any number of producers and consumers.
+//every cell carries a sequence number telling producers and consumers whose turn it is,
+//so a push or shift only contends on one counter and one cell
+typedef struct mz_MpmcQueueCell {
+  atomic_size_t sequence;
+  void *value;
+} mz_MpmcQueueCell;
+
+typedef struct mz_MpmcQueue {
+  size_t capacity;
+  size_t mask;
+  mz_MpmcQueueCell *cells;
+  _Alignas(MZ_CACHE_LINE_SIZE) atomic_size_t tail;
+  _Alignas(MZ_CACHE_LINE_SIZE) atomic_size_t head;
+  char padding[MZ_CACHE_LINE_SIZE - sizeof(atomic_size_t)];
+} mz_MpmcQueue;
+
+//capacity is rounded up to a power of two
+mz_MpmcQueue *mz_mpmcqueue_new(size_t capacity);
+
+void mz_mpmcqueue_free(mz_MpmcQueue *queue);
+
+//returns false if the queue is full
+bool mz_mpmcqueue_push(mz_MpmcQueue *queue, void *value);
+
+//returns false if the queue is empty
+bool mz_mpmcqueue_shift(mz_MpmcQueue *queue, void **value);
+
+//only a snapshot while other threads are pushing or shifting
+size_t mz_mpmcqueue_size(mz_MpmcQueue *queue);
+
+static inline size_t mz_mpmcqueue_capacity(mz_MpmcQueue *queue) {
+  return queue->capacity;
+}
+
+#endif
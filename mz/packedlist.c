@@ -0,0 +1,296 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "packedlist.h"
+#include "logger.h"
+#include "type.h"
+
+//moves the elements of a mapped list to the heap so that it can grow
+bool _mz_packedlist_detach(mz_PackedList *list, size_t capacity) {
+  bool result = false;
+  char *data = malloc(capacity * list->element_size);
+  if (!data) {
+    ERROR("could not allocate memory for packedlist->data");
+  } else {
+    memcpy(data, list->data, list->size * list->element_size);
+    munmap(list->mapping, list->mapping_size);
+    list->mapping = NULL;
+    list->mapping_size = 0;
+    list->data = data;
+    list->capacity = capacity;
+    result = true;
+  }
+  return result;
+}
+
+bool _mz_packedlist_is_writable(mz_PackedList *list) {
+  if (list->read_only) {
+    ERROR("packedlist is mapped read only");
+    return false;
+  }
+  return true;
+}
+
+mz_PackedList *mz_packedlist_new(size_t initial_capacity, size_t element_size) {
+  mz_PackedList *list = NULL;
+  if (initial_capacity < 1) {
+    ERROR("invalid initial_capacity for packedlist. initial_capacity must be greater than 1");
+  } else if (element_size < 1) {
+    ERROR("invalid element_size for packedlist. element_size must be greater than 1");
+  } else {
+    list = calloc(1, sizeof(mz_PackedList));
+    if (!list) {
+      ERROR("could not allocate memory for packedlist");
+    } else {
+      list->initial_capacity = initial_capacity;
+      list->element_size = element_size;
+      list->capacity = initial_capacity;
+      list->data = malloc(initial_capacity * element_size);
+      if (!list->data) {
+        ERROR("could not allocate memory for packedlist->data");
+        free(list);
+        list = NULL;
+      }
+    }
+  }
+  return list;
+}
+
+void mz_packedlist_free(mz_PackedList *list) {
+  if (list) {
+    if (list->mapping) {
+      munmap(list->mapping, list->mapping_size);
+    } else {
+      free(list->data);
+    }
+    free(list);
+  }
+}
+
+bool mz_packedlist_reserve(mz_PackedList *list, size_t capacity) {
+  bool result = true;
+  if (capacity <= list->capacity) {
+    //nothing to do
+  } else if (!_mz_packedlist_is_writable(list)) {
+    result = false;
+  } else {
+    size_t new_capacity = list->capacity > 0 ? list->capacity : list->initial_capacity;
+    while (new_capacity < capacity) {
+      new_capacity *= 2;
+    }
+    if (list->mapping) {
+      result = _mz_packedlist_detach(list, new_capacity);
+    } else {
+      char *data = realloc(list->data, new_capacity * list->element_size);
+      if (!data) {
+        ERROR("could not reallocate memory for packedlist->data");
+        result = false;
+      } else {
+        list->data = data;
+        list->capacity = new_capacity;
+      }
+    }
+  }
+  return result;
+}
+
+bool mz_packedlist_append(mz_PackedList *list, const void *element) {
+  bool result = false;
+  if (!mz_packedlist_reserve(list, list->size + 1)) {
+    ERROR("could not reserve packedlist capacity");
+  } else {
+    memcpy(list->data + list->size * list->element_size, element, list->element_size);
+    list->size += 1;
+    result = true;
+  }
+  return result;
+}
+
+bool mz_packedlist_append_range(mz_PackedList *list, const void *elements, size_t len) {
+  bool result = false;
+  if (!mz_packedlist_reserve(list, list->size + len)) {
+    ERROR("could not reserve packedlist capacity");
+  } else {
+    memcpy(list->data + list->size * list->element_size, elements, len * list->element_size);
+    list->size += len;
+    result = true;
+  }
+  return result;
+}
+
+bool mz_packedlist_set(mz_PackedList *list, size_t index, const void *element) {
+  bool result = false;
+  if (index >= list->size) {
+    ERROR("index is out of range - %zu", index);
+  } else if (_mz_packedlist_is_writable(list)) {
+    memcpy(list->data + index * list->element_size, element, list->element_size);
+    result = true;
+  }
+  return result;
+}
+
+void *mz_packedlist_get(mz_PackedList *list, size_t index) {
+  if (index >= list->size) {
+    ERROR("index is out of range - %zu", index);
+    return NULL;
+  } else {
+    return list->data + index * list->element_size;
+  }
+}
+
+bool mz_packedlist_sort(mz_PackedList *list, int (*mz_packedlist_comparator_fn)(const void *, const void *)) {
+  bool result = false;
+  if (!list) {
+    ERROR("list is null");
+  } else if (_mz_packedlist_is_writable(list)) {
+    qsort(list->data, list->size, list->element_size, (*mz_packedlist_comparator_fn));
+    result = true;
+  }
+  return result;
+}
+
+size_t mz_packedlist_binary_search(mz_PackedList *list, const void *element,
+                                   int (*mz_packedlist_comparator_fn)(const void *, const void *)) {
+  size_t result = MZ_NPOS;
+  if (!list) {
+    ERROR("list is null");
+  } else {
+    //search the half-open range [start, end)
+    size_t start = 0;
+    size_t end = list->size;
+    while (start < end) {
+      size_t mid = start + (end - start) / 2;
+      int comparison = (*mz_packedlist_comparator_fn)(element, list->data + mid * list->element_size);
+      if (comparison < 0) {
+        end = mid;
+      } else if (comparison > 0) {
+        start = mid + 1;
+      } else {
+        result = mid;
+        break;
+      }
+    }
+  }
+  return result;
+}
+
+uint64_t mz_packedlist_checksum(mz_PackedList *list) {
+  //FNV-1a, folded a 64-bit word at a time
+  const uint64_t prime = 0x100000001b3ULL;
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  size_t len = list->size * list->element_size;
+  size_t words = len / sizeof(uint64_t);
+  for (size_t i = 0; i < words; i++) {
+    uint64_t word;
+    memcpy(&word, list->data + i * sizeof(uint64_t), sizeof(uint64_t));
+    hash = (hash ^ word) * prime;
+  }
+  for (size_t i = words * sizeof(uint64_t); i < len; i++) {
+    hash = (hash ^ (unsigned char) list->data[i]) * prime;
+  }
+  return hash;
+}
+
+bool mz_packedlist_save(mz_PackedList *list, const char *path) {
+  bool result = false;
+  //write next to the destination and rename, so processes mapping the old file are unaffected
+  size_t path_len = strlen(path);
+  char *tmp_path = malloc(path_len + 5);
+  if (!tmp_path) {
+    ERROR("could not allocate memory for path");
+    return false;
+  }
+  memcpy(tmp_path, path, path_len);
+  memcpy(tmp_path + path_len, ".tmp", 5);
+
+  char header_block[MZ_PACKEDLIST_DATA_OFFSET] = {0};
+  mz_PackedListHeader header = {
+      .magic = MZ_PACKEDLIST_MAGIC,
+      .version = MZ_PACKEDLIST_VERSION,
+      .element_size = list->element_size,
+      .count = list->size,
+      .checksum = mz_packedlist_checksum(list)
+  };
+  memcpy(header_block, &header, sizeof(header));
+
+  FILE *file = fopen(tmp_path, "wb");
+  if (!file) {
+    ERROR("could not open %s", tmp_path);
+  } else {
+    bool written = fwrite(header_block, sizeof(header_block), 1, file) == 1 &&
+                   fwrite(list->data, list->element_size, list->size, file) == list->size &&
+                   fflush(file) == 0 &&
+                   fsync(fileno(file)) == 0;
+    if (fclose(file) != 0 || !written) {
+      ERROR("could not write %s", tmp_path);
+      unlink(tmp_path);
+    } else if (rename(tmp_path, path) != 0) {
+      ERROR("could not rename %s to %s", tmp_path, path);
+      unlink(tmp_path);
+    } else {
+      result = true;
+    }
+  }
+  free(tmp_path);
+  return result;
+}
+
+mz_PackedList *mz_packedlist_map(const char *path, mz_PackedListMapMode mode, bool verify) {
+  mz_PackedList *list = NULL;
+  int fd = open(path, O_RDONLY);
+  struct stat st;
+  if (fd == -1) {
+    ERROR("could not open %s", path);
+    return NULL;
+  }
+  if (fstat(fd, &st) == -1) {
+    ERROR("could not stat %s", path);
+  } else if ((size_t) st.st_size < MZ_PACKEDLIST_DATA_OFFSET) {
+    ERROR("%s is too small to be a packedlist", path);
+  } else {
+    size_t mapping_size = (size_t) st.st_size;
+    int prot = mode == mz_PackedListMapModeReadOnly ? PROT_READ : PROT_READ | PROT_WRITE;
+    int flags = mode == mz_PackedListMapModeReadOnly ? MAP_SHARED : MAP_PRIVATE;
+    void *mapping = mmap(NULL, mapping_size, prot, flags, fd, 0);
+    if (mapping == MAP_FAILED) {
+      ERROR("could not map %s", path);
+    } else {
+      mz_PackedListHeader header;
+      memcpy(&header, mapping, sizeof(header));
+      if (header.magic != MZ_PACKEDLIST_MAGIC || header.version != MZ_PACKEDLIST_VERSION) {
+        ERROR("%s is not a packedlist file", path);
+      } else if (header.element_size < 1 ||
+                 header.count > (mapping_size - MZ_PACKEDLIST_DATA_OFFSET) / header.element_size) {
+        ERROR("%s is truncated", path);
+      } else {
+        list = calloc(1, sizeof(mz_PackedList));
+        if (!list) {
+          ERROR("could not allocate memory for packedlist");
+        } else {
+          list->element_size = header.element_size;
+          list->size = header.count;
+          list->capacity = header.count;
+          list->initial_capacity = header.count > 0 ? header.count : 1;
+          list->data = (char *) mapping + MZ_PACKEDLIST_DATA_OFFSET;
+          list->mapping = mapping;
+          list->mapping_size = mapping_size;
+          list->read_only = mode == mz_PackedListMapModeReadOnly;
+          if (verify && mz_packedlist_checksum(list) != header.checksum) {
+            ERROR("checksum mismatch for %s", path);
+            free(list);
+            list = NULL;
+          }
+        }
+      }
+      if (!list) {
+        munmap(mapping, mapping_size);
+      }
+    }
+  }
+  close(fd);
+  return list;
+}
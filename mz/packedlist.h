@@ -0,0 +1,88 @@
+#ifndef __mz_packedlist__
+#define __mz_packedlist__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "type.h"
+
+//file layout written by mz_packedlist_save: a fixed header followed by the
+//elements, stored in host byte order starting at MZ_PACKEDLIST_DATA_OFFSET
+#define MZ_PACKEDLIST_MAGIC 0x4c505a4d
+#define MZ_PACKEDLIST_VERSION 1
+#define MZ_PACKEDLIST_DATA_OFFSET 64
+
+typedef struct mz_PackedListHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t element_size;
+  uint64_t count;
+  uint64_t checksum;
+} mz_PackedListHeader;
+
+typedef enum mz_PackedListMapMode {
+  mz_PackedListMapModeReadOnly,
+  mz_PackedListMapModeCopyOnWrite
+} mz_PackedListMapMode;
+
+//an arraylist that stores element_size bytes per element inline instead of pointers.
+//data lives either on the heap or, for lists opened with mz_packedlist_map, in a file mapping
+typedef struct mz_PackedList {
+  size_t initial_capacity;
+  size_t element_size;
+  size_t size;
+  size_t capacity;
+  char *data;
+  void *mapping;
+  size_t mapping_size;
+  bool read_only;
+} mz_PackedList;
+
+mz_PackedList *mz_packedlist_new(size_t initial_capacity, size_t element_size);
+
+void mz_packedlist_free(mz_PackedList *list);
+
+bool mz_packedlist_reserve(mz_PackedList *list, size_t capacity);
+
+bool mz_packedlist_append(mz_PackedList *list, const void *element);
+
+bool mz_packedlist_append_range(mz_PackedList *list, const void *elements, size_t len);
+
+bool mz_packedlist_set(mz_PackedList *list, size_t index, const void *element);
+
+void *mz_packedlist_get(mz_PackedList *list, size_t index);
+
+bool mz_packedlist_sort(mz_PackedList *list, int (*mz_packedlist_comparator_fn)(const void *, const void *));
+
+size_t mz_packedlist_binary_search(mz_PackedList *list, const void *element,
+                                   int (*mz_packedlist_comparator_fn)(const void *, const void *));
+
+uint64_t mz_packedlist_checksum(mz_PackedList *list);
+
+bool mz_packedlist_save(mz_PackedList *list, const char *path);
+
+//maps a file written by mz_packedlist_save without reading it. verify checks the
+//checksum, which touches every page of the file
+mz_PackedList *mz_packedlist_map(const char *path, mz_PackedListMapMode mode, bool verify);
+
+static inline size_t mz_packedlist_size(mz_PackedList *list) {
+  return list->size;
+}
+
+static inline bool mz_packedlist_is_empty(mz_PackedList *list) {
+  return list->size == 0;
+}
+
+static inline bool mz_packedlist_is_mapped(mz_PackedList *list) {
+  return list->mapping != NULL;
+}
+
+static inline void *mz_packedlist_data(mz_PackedList *list) {
+  return list->data;
+}
+
+#define mzm_packedlist_foreach(L, T, E, I) T * E = NULL;\
+                                           size_t I = 0;\
+                                           for (; I < L->size && ((E = (T *) (L->data + I * L->element_size)) || 1); ++I)
+
+#endif
@@ -0,0 +1,217 @@
+#include <stdlib.h>
+#include "priorityqueue.h"
+#include "logger.h"
+#include "type.h"
+
+bool _mz_priorityqueue_less(mz_PriorityQueue *queue, mz_PriorityQueueNode *a, mz_PriorityQueueNode *b) {
+  return (*queue->comparator_fn)(&a->value, &b->value) < 0;
+}
+
+void _mz_priorityqueue_place(mz_PriorityQueue *queue, mz_PriorityQueueNode *node, size_t position) {
+  queue->heap->array[position] = node;
+  node->position = position;
+}
+
+//moves the node at position towards the root while it is smaller than its parent
+void _mz_priorityqueue_sift_up(mz_PriorityQueue *queue, size_t position) {
+  mz_PriorityQueueNode *node = queue->heap->array[position];
+  while (position > 0) {
+    size_t parent = (position - 1) / queue->arity;
+    mz_PriorityQueueNode *parent_node = queue->heap->array[parent];
+    if (!_mz_priorityqueue_less(queue, node, parent_node)) {
+      break;
+    }
+    _mz_priorityqueue_place(queue, parent_node, position);
+    position = parent;
+  }
+  _mz_priorityqueue_place(queue, node, position);
+}
+
+//moves the node at position towards the leaves while a child is smaller
+void _mz_priorityqueue_sift_down(mz_PriorityQueue *queue, size_t position) {
+  size_t size = queue->heap->size;
+  mz_PriorityQueueNode *node = queue->heap->array[position];
+  for (;;) {
+    size_t first_child = position * queue->arity + 1;
+    if (first_child >= size) {
+      break;
+    }
+    size_t last_child = first_child + queue->arity < size ? first_child + queue->arity : size;
+    size_t smallest = first_child;
+    for (size_t child = first_child + 1; child < last_child; child++) {
+      if (_mz_priorityqueue_less(queue, queue->heap->array[child], queue->heap->array[smallest])) {
+        smallest = child;
+      }
+    }
+    if (!_mz_priorityqueue_less(queue, queue->heap->array[smallest], node)) {
+      break;
+    }
+    _mz_priorityqueue_place(queue, queue->heap->array[smallest], position);
+    position = smallest;
+  }
+  _mz_priorityqueue_place(queue, node, position);
+}
+
+mz_PriorityQueueNode *_mz_priorityqueue_take_node(mz_PriorityQueue *queue, void *value) {
+  mz_PriorityQueueNode *node = NULL;
+  if (queue->spare->size > 0) {
+    node = queue->spare->array[--queue->spare->size];
+  } else {
+    node = malloc(sizeof(mz_PriorityQueueNode));
+    if (!node) {
+      ERROR("could not allocate memory for priorityqueue node");
+      return NULL;
+    }
+  }
+  node->value = value;
+  return node;
+}
+
+void _mz_priorityqueue_release_node(mz_PriorityQueue *queue, mz_PriorityQueueNode *node) {
+  //spare was reserved for every node, so this cannot fail
+  node->position = MZ_NPOS;
+  mz_arraylist_append(queue->spare, node);
+}
+
+bool _mz_priorityqueue_is_queued(mz_PriorityQueue *queue, mz_PriorityQueueNode *node) {
+  if (!node || node->position >= queue->heap->size || queue->heap->array[node->position] != node) {
+    ERROR("node is not in the priorityqueue");
+    return false;
+  }
+  return true;
+}
+
+//removes the node at position and fills the hole with the last node
+void _mz_priorityqueue_remove_at(mz_PriorityQueue *queue, size_t position) {
+  mz_PriorityQueueNode *last = queue->heap->array[--queue->heap->size];
+  if (position < queue->heap->size) {
+    mz_PriorityQueueNode *removed = queue->heap->array[position];
+    _mz_priorityqueue_place(queue, last, position);
+    if (_mz_priorityqueue_less(queue, last, removed)) {
+      _mz_priorityqueue_sift_up(queue, position);
+    } else {
+      _mz_priorityqueue_sift_down(queue, position);
+    }
+  }
+}
+
+mz_PriorityQueue *mz_priorityqueue_new(size_t arity, int (*mz_priorityqueue_comparator_fn)(const void *, const void *)) {
+  mz_PriorityQueue *queue = NULL;
+  if (arity < 2) {
+    ERROR("invalid arity for priorityqueue. arity must be at least 2");
+  } else if (!mz_priorityqueue_comparator_fn) {
+    ERROR("comparator is null");
+  } else {
+    queue = calloc(1, sizeof(mz_PriorityQueue));
+    if (!queue) {
+      ERROR("could not allocate memory for priorityqueue");
+    } else {
+      queue->arity = arity;
+      queue->comparator_fn = mz_priorityqueue_comparator_fn;
+      queue->heap = mz_arraylist_new(MZ_ARRAYLIST_INLINE_CAPACITY, sizeof(mz_PriorityQueueNode *));
+      queue->spare = mz_arraylist_new(MZ_ARRAYLIST_INLINE_CAPACITY, sizeof(mz_PriorityQueueNode *));
+      if (!queue->heap || !queue->spare) {
+        ERROR("could not allocate priorityqueue storage");
+        mz_arraylist_free(queue->heap);
+        mz_arraylist_free(queue->spare);
+        free(queue);
+        queue = NULL;
+      }
+    }
+  }
+  return queue;
+}
+
+void mz_priorityqueue_free(mz_PriorityQueue *queue) {
+  if (queue) {
+    for (size_t i = 0; i < queue->heap->size; i++) {
+      free(queue->heap->array[i]);
+    }
+    for (size_t i = 0; i < queue->spare->size; i++) {
+      free(queue->spare->array[i]);
+    }
+    mz_arraylist_free(queue->heap);
+    mz_arraylist_free(queue->spare);
+    free(queue);
+  }
+}
+
+bool _mz_priorityqueue_reserve(mz_PriorityQueue *queue, size_t len) {
+  //spare must be able to take back every node without allocating
+  size_t nodes = queue->heap->size + queue->spare->size + len;
+  if (!mz_arraylist_reserve(queue->heap, queue->heap->size + len) || !mz_arraylist_reserve(queue->spare, nodes)) {
+    ERROR("could not reserve priorityqueue capacity");
+    return false;
+  }
+  return true;
+}
+
+mz_PriorityQueueNode *mz_priorityqueue_push(mz_PriorityQueue *queue, void *value) {
+  mz_PriorityQueueNode *node = NULL;
+  if (_mz_priorityqueue_reserve(queue, 1) && (node = _mz_priorityqueue_take_node(queue, value))) {
+    queue->heap->array[queue->heap->size++] = node;
+    _mz_priorityqueue_sift_up(queue, queue->heap->size - 1);
+  }
+  return node;
+}
+
+bool mz_priorityqueue_heapify(mz_PriorityQueue *queue, void **values, size_t len, mz_PriorityQueueNode **handles) {
+  bool result = _mz_priorityqueue_reserve(queue, len);
+  for (size_t i = 0; result && i < len; i++) {
+    mz_PriorityQueueNode *node = _mz_priorityqueue_take_node(queue, values[i]);
+    if (!node) {
+      //the values added so far still end up in a valid heap
+      result = false;
+    } else {
+      _mz_priorityqueue_place(queue, node, queue->heap->size++);
+      if (handles) {
+        handles[i] = node;
+      }
+    }
+  }
+  //sift down every node with children, from the last one to the root
+  size_t size = queue->heap->size;
+  for (size_t position = size > 1 ? (size - 2) / queue->arity + 1 : 0; position > 0; position--) {
+    _mz_priorityqueue_sift_down(queue, position - 1);
+  }
+  return result;
+}
+
+bool mz_priorityqueue_peek(mz_PriorityQueue *queue, void **value) {
+  if (queue->heap->size == 0) {
+    return false;
+  }
+  *value = ((mz_PriorityQueueNode *) queue->heap->array[0])->value;
+  return true;
+}
+
+bool mz_priorityqueue_pop(mz_PriorityQueue *queue, void **value) {
+  if (queue->heap->size == 0) {
+    return false;
+  }
+  mz_PriorityQueueNode *top = queue->heap->array[0];
+  *value = top->value;
+  _mz_priorityqueue_remove_at(queue, 0);
+  _mz_priorityqueue_release_node(queue, top);
+  return true;
+}
+
+bool mz_priorityqueue_update(mz_PriorityQueue *queue, mz_PriorityQueueNode *node, void *value) {
+  if (!_mz_priorityqueue_is_queued(queue, node)) {
+    return false;
+  }
+  node->value = value;
+  //only one of the two moves the node
+  _mz_priorityqueue_sift_up(queue, node->position);
+  _mz_priorityqueue_sift_down(queue, node->position);
+  return true;
+}
+
+bool mz_priorityqueue_remove(mz_PriorityQueue *queue, mz_PriorityQueueNode *node) {
+  if (!_mz_priorityqueue_is_queued(queue, node)) {
+    return false;
+  }
+  _mz_priorityqueue_remove_at(queue, node->position);
+  _mz_priorityqueue_release_node(queue, node);
+  return true;
+}
@@ -0,0 +1,54 @@
+#ifndef __mz_priorityqueue__
+#define __mz_priorityqueue__
+
+#include <stdlib.h>
+#include "type.h"
+#include "arraylist.h"
+
+//d-ary min-heap in an arraylist of nodes. a node tracks its own position in the heap, so
+//the pointer returned by push doubles as a handle for update and remove. the comparator
+//follows mz_arraylist_sort and receives pointers to the two values
+typedef struct mz_PriorityQueueNode {
+  void *value;
+  size_t position;
+} mz_PriorityQueueNode;
+
+typedef struct mz_PriorityQueue {
+  size_t arity;
+  int (*comparator_fn)(const void *, const void *);
+  mz_ArrayList *heap;
+  //nodes of popped values, reused by later pushes
+  mz_ArrayList *spare;
+} mz_PriorityQueue;
+
+//arity 2 is a binary heap, 4 or 8 make sift-down touch fewer cache lines
+mz_PriorityQueue *mz_priorityqueue_new(size_t arity, int (*mz_priorityqueue_comparator_fn)(const void *, const void *));
+
+void mz_priorityqueue_free(mz_PriorityQueue *queue);
+
+//returns the handle of the value, valid until it is popped or removed, or NULL on failure
+mz_PriorityQueueNode *mz_priorityqueue_push(mz_PriorityQueue *queue, void *value);
+
+//adds len values and restores the heap once in O(n + size). handles may be NULL,
+//otherwise it receives a handle per value
+bool mz_priorityqueue_heapify(mz_PriorityQueue *queue, void **values, size_t len, mz_PriorityQueueNode **handles);
+
+//returns false if the queue is empty
+bool mz_priorityqueue_peek(mz_PriorityQueue *queue, void **value);
+
+bool mz_priorityqueue_pop(mz_PriorityQueue *queue, void **value);
+
+//changes the value of a queued node and moves it up or down, e.g. for decrease-key
+bool mz_priorityqueue_update(mz_PriorityQueue *queue, mz_PriorityQueueNode *node, void *value);
+
+bool mz_priorityqueue_remove(mz_PriorityQueue *queue, mz_PriorityQueueNode *node);
+
+static inline size_t mz_priorityqueue_size(mz_PriorityQueue *queue) {
+  return queue->heap->size;
+}
+
+static inline bool mz_priorityqueue_is_empty(mz_PriorityQueue *queue) {
+  return queue->heap->size == 0;
+}
+
+#endif
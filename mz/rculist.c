@@ -0,0 +1,132 @@
+#include <stdlib.h>
+#include <string.h>
+#include "rculist.h"
+#include "logger.h"
+#include "type.h"
+
+typedef struct _mz_RcuListRetired {
+  mz_ArrayList *version;
+  uint64_t epoch;
+} _mz_RcuListRetired;
+
+//callers hold writer_lock
+size_t _mz_rculist_reclaim(mz_RcuList *list) {
+  //the oldest epoch a reader is still inside of
+  uint64_t oldest = UINT64_MAX;
+  for (size_t i = 0; i < MZ_RCULIST_MAX_READERS; i++) {
+    uint64_t epoch = atomic_load_explicit(&list->readers[i].epoch, memory_order_acquire);
+    if (epoch != 0 && epoch < oldest) {
+      oldest = epoch;
+    }
+  }
+  size_t kept = 0;
+  mzm_packedlist_foreach(list->retired, _mz_RcuListRetired, retired, i) {
+    if (retired->epoch < oldest) {
+      mz_arraylist_free(retired->version);
+    } else {
+      memmove(mz_packedlist_get(list->retired, kept++), retired, sizeof(_mz_RcuListRetired));
+    }
+  }
+  list->retired->size = kept;
+  return kept;
+}
+
+mz_RcuList *mz_rculist_new(size_t initial_capacity) {
+  mz_RcuList *list = NULL;
+  if (posix_memalign((void **) &list, MZ_CACHE_LINE_SIZE, sizeof(mz_RcuList)) != 0) {
+    ERROR("could not allocate memory for rculist");
+    return NULL;
+  }
+  memset(list, 0, sizeof(mz_RcuList));
+  mz_ArrayList *current = mz_arraylist_new(initial_capacity, sizeof(void *));
+  list->retired = mz_packedlist_new(MZ_ARRAYLIST_INLINE_CAPACITY, sizeof(_mz_RcuListRetired));
+  if (!current || !list->retired || pthread_mutex_init(&list->writer_lock, NULL) != 0) {
+    ERROR("could not initialize rculist");
+    mz_arraylist_free(current);
+    mz_packedlist_free(list->retired);
+    free(list);
+    return NULL;
+  }
+  atomic_init(&list->current, current);
+  //epoch 0 marks an idle reader
+  atomic_init(&list->epoch, 1);
+  for (size_t i = 0; i < MZ_RCULIST_MAX_READERS; i++) {
+    atomic_init(&list->readers[i].epoch, 0);
+    atomic_flag_clear(&list->readers[i].in_use);
+  }
+  return list;
+}
+
+void mz_rculist_free(mz_RcuList *list) {
+  if (list) {
+    mzm_packedlist_foreach(list->retired, _mz_RcuListRetired, retired, i) {
+      mz_arraylist_free(retired->version);
+    }
+    mz_packedlist_free(list->retired);
+    mz_arraylist_free(atomic_load(&list->current));
+    pthread_mutex_destroy(&list->writer_lock);
+    free(list);
+  }
+}
+
+mz_RcuListReader *mz_rculist_reader_register(mz_RcuList *list) {
+  for (size_t i = 0; i < MZ_RCULIST_MAX_READERS; i++) {
+    if (!atomic_flag_test_and_set(&list->readers[i].in_use)) {
+      return &list->readers[i];
+    }
+  }
+  ERROR("all %d rculist reader slots are in use", MZ_RCULIST_MAX_READERS);
+  return NULL;
+}
+
+void mz_rculist_reader_unregister(mz_RcuList *list, mz_RcuListReader *reader) {
+  if (reader) {
+    atomic_store(&reader->epoch, 0);
+    atomic_flag_clear(&reader->in_use);
+  }
+}
+
+mz_ArrayList *mz_rculist_update_begin(mz_RcuList *list) {
+  mz_ArrayList *update = NULL;
+  pthread_mutex_lock(&list->writer_lock);
+  mz_ArrayList *current = atomic_load_explicit(&list->current, memory_order_relaxed);
+  update = mz_arraylist_new(current->initial_capacity, current->element_size);
+  if (!update || !mz_arraylist_append_range(update, current->array, current->size)) {
+    ERROR("could not copy rculist version");
+    mz_arraylist_free(update);
+    update = NULL;
+    pthread_mutex_unlock(&list->writer_lock);
+  }
+  return update;
+}
+
+bool mz_rculist_update_commit(mz_RcuList *list, mz_ArrayList *update) {
+  bool result = false;
+  mz_ArrayList *replaced = atomic_exchange_explicit(&list->current, update, memory_order_acq_rel);
+  //readers that entered before this point may hold the replaced version
+  _mz_RcuListRetired retired = {replaced, atomic_fetch_add(&list->epoch, 1)};
+  //order the publication before the reader scan, pairs with the fence in read_lock
+  atomic_thread_fence(memory_order_seq_cst);
+  if (!mz_packedlist_append(list->retired, &retired)) {
+    //without a record the version cannot be freed safely, so it is leaked
+    ERROR("could not retire rculist version");
+  } else {
+    result = true;
+  }
+  _mz_rculist_reclaim(list);
+  pthread_mutex_unlock(&list->writer_lock);
+  return result;
+}
+
+void mz_rculist_update_abort(mz_RcuList *list, mz_ArrayList *update) {
+  mz_arraylist_free(update);
+  pthread_mutex_unlock(&list->writer_lock);
+}
+
+size_t mz_rculist_reclaim(mz_RcuList *list) {
+  pthread_mutex_lock(&list->writer_lock);
+  atomic_thread_fence(memory_order_seq_cst);
+  size_t result = _mz_rculist_reclaim(list);
+  pthread_mutex_unlock(&list->writer_lock);
+  return result;
+}
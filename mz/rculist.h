@@ -0,0 +1,66 @@
+#ifndef __mz_rculist__
+#define __mz_rculist__
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "type.h"
+#include "arraylist.h"
+#include "packedlist.h"
+
+#define MZ_RCULIST_MAX_READERS 64
+
+//a reader thread's slot. epoch is 0 outside of a read section
+typedef struct mz_RcuListReader {
+  _Alignas(MZ_CACHE_LINE_SIZE) atomic_uint_fast64_t epoch;
+  atomic_flag in_use;
+} mz_RcuListReader;
+
+//read-mostly arraylist. readers get a consistent snapshot with plain loads and stores,
+//writers copy the current version, change the copy and publish it atomically.
+//a replaced version is retired with the epoch it was replaced in and freed once no
+//reader is still inside that epoch
+typedef struct mz_RcuList {
+  _Atomic(mz_ArrayList *) current;
+  atomic_uint_fast64_t epoch;
+  pthread_mutex_t writer_lock;
+  mz_PackedList *retired;
+  mz_RcuListReader readers[MZ_RCULIST_MAX_READERS];
+} mz_RcuList;
+
+mz_RcuList *mz_rculist_new(size_t initial_capacity);
+
+//frees every version, no reader may be inside a read section
+void mz_rculist_free(mz_RcuList *list);
+
+//called once per reader thread, returns NULL if all slots are taken
+mz_RcuListReader *mz_rculist_reader_register(mz_RcuList *list);
+
+void mz_rculist_reader_unregister(mz_RcuList *list, mz_RcuListReader *reader);
+
+//the snapshot stays valid and unchanged until mz_rculist_read_unlock
+static inline const mz_ArrayList *mz_rculist_read_lock(mz_RcuList *list, mz_RcuListReader *reader) {
+  atomic_store_explicit(&reader->epoch, atomic_load_explicit(&list->epoch, memory_order_relaxed),
+                        memory_order_relaxed);
+  //order the epoch store before the version load, pairs with the fence in commit
+  atomic_thread_fence(memory_order_seq_cst);
+  return atomic_load_explicit(&list->current, memory_order_acquire);
+}
+
+static inline void mz_rculist_read_unlock(mz_RcuListReader *reader) {
+  atomic_store_explicit(&reader->epoch, 0, memory_order_release);
+}
+
+//locks out other writers and returns a private copy of the current version to change
+mz_ArrayList *mz_rculist_update_begin(mz_RcuList *list);
+
+//publishes the copy, retires the replaced version and unlocks
+bool mz_rculist_update_commit(mz_RcuList *list, mz_ArrayList *update);
+
+void mz_rculist_update_abort(mz_RcuList *list, mz_ArrayList *update);
+
+//frees the retired versions no reader can still see, returns how many are left
+size_t mz_rculist_reclaim(mz_RcuList *list);
+
+#endif
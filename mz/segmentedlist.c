@@ -0,0 +1,130 @@
+#include <stdlib.h>
+#include <string.h>
+#include "segmentedlist.h"
+#include "logger.h"
+#include "type.h"
+
+//segment k starts at index segment_capacity * (2^k - 1)
+size_t _mz_segmentedlist_segment_of(mz_SegmentedList *list, size_t index) {
+  size_t j = (index >> list->segment_shift) + 1;
+  return (size_t) (63 - __builtin_clzll(j));
+}
+
+size_t _mz_segmentedlist_segment_start(mz_SegmentedList *list, size_t k) {
+  return (((size_t) 1 << k) - 1) << list->segment_shift;
+}
+
+mz_SegmentedListSegment *_mz_segmentedlist_ensure_segment(mz_SegmentedList *list, size_t k) {
+  mz_SegmentedListSegment *segment = atomic_load_explicit(&list->segments[k], memory_order_acquire);
+  if (!segment) {
+    //the element array and the ready flags share one allocation
+    size_t capacity = (size_t) 1 << (list->segment_shift + k);
+    mz_SegmentedListSegment *allocated = calloc(1, sizeof(mz_SegmentedListSegment) +
+                                                   capacity * (sizeof(void *) + sizeof(atomic_uchar)));
+    if (allocated) {
+      allocated->ready = (atomic_uchar *) (allocated->array + capacity);
+    }
+    if (!allocated) {
+      ERROR("could not allocate memory for segment %zu", k);
+    } else if (atomic_compare_exchange_strong_explicit(&list->segments[k], &segment, allocated,
+                                                       memory_order_acq_rel, memory_order_acquire)) {
+      segment = allocated;
+    } else {
+      //another appender installed the segment first
+      free(allocated);
+    }
+  }
+  return segment;
+}
+
+mz_SegmentedList *mz_segmentedlist_new(size_t segment_capacity) {
+  mz_SegmentedList *list = NULL;
+  if (segment_capacity < 1) {
+    ERROR("invalid segment_capacity for segmentedlist. segment_capacity must be greater than 1");
+  } else if (posix_memalign((void **) &list, MZ_CACHE_LINE_SIZE, sizeof(mz_SegmentedList)) != 0) {
+    ERROR("could not allocate memory for segmentedlist");
+    list = NULL;
+  } else {
+    memset(list, 0, sizeof(mz_SegmentedList));
+    list->segment_shift = 0;
+    while (((size_t) 1 << list->segment_shift) < segment_capacity) {
+      list->segment_shift += 1;
+    }
+    for (size_t k = 0; k < MZ_SEGMENTEDLIST_MAX_SEGMENTS; k++) {
+      atomic_init(&list->segments[k], NULL);
+    }
+    atomic_init(&list->reserved, 0);
+    atomic_init(&list->published, 0);
+  }
+  return list;
+}
+
+void mz_segmentedlist_free(mz_SegmentedList *list) {
+  if (list) {
+    for (size_t k = 0; k < MZ_SEGMENTEDLIST_MAX_SEGMENTS; k++) {
+      free(atomic_load_explicit(&list->segments[k], memory_order_relaxed));
+    }
+    free(list);
+  }
+}
+
+bool _mz_segmentedlist_is_ready(mz_SegmentedList *list, size_t index) {
+  size_t k = _mz_segmentedlist_segment_of(list, index);
+  mz_SegmentedListSegment *segment = k < MZ_SEGMENTEDLIST_MAX_SEGMENTS ?
+                                     atomic_load_explicit(&list->segments[k], memory_order_acquire) : NULL;
+  //seq_cst pairs with the flag store in append: of two appenders racing to advance,
+  //at least one sees the other's flag
+  return segment && atomic_load(&segment->ready[index - _mz_segmentedlist_segment_start(list, k)]);
+}
+
+size_t mz_segmentedlist_append(mz_SegmentedList *list, void *element) {
+  size_t index = atomic_fetch_add_explicit(&list->reserved, 1, memory_order_relaxed);
+  size_t k = _mz_segmentedlist_segment_of(list, index);
+  mz_SegmentedListSegment *segment = k < MZ_SEGMENTEDLIST_MAX_SEGMENTS ?
+                                     _mz_segmentedlist_ensure_segment(list, k) : NULL;
+  if (!segment) {
+    //the slot can never become ready, and publication stops in front of it
+    ERROR("could not store element %zu", index);
+    return MZ_NPOS;
+  }
+  size_t offset = index - _mz_segmentedlist_segment_start(list, k);
+  segment->array[offset] = element;
+  atomic_store(&segment->ready[offset], 1);
+  //advance published over every ready slot, whoever appended it. if an earlier slot
+  //is not ready yet, its appender carries published past ours once it is done
+  size_t published = atomic_load_explicit(&list->published, memory_order_acquire);
+  while (_mz_segmentedlist_is_ready(list, published)) {
+    if (atomic_compare_exchange_weak_explicit(&list->published, &published, published + 1,
+                                              memory_order_acq_rel, memory_order_acquire)) {
+      published += 1;
+    }
+  }
+  return index;
+}
+
+void *mz_segmentedlist_get(mz_SegmentedList *list, size_t index) {
+  if (index >= mz_segmentedlist_size(list)) {
+    ERROR("index is out of range - %zu", index);
+    return NULL;
+  }
+  size_t k = _mz_segmentedlist_segment_of(list, index);
+  mz_SegmentedListSegment *segment = atomic_load_explicit(&list->segments[k], memory_order_relaxed);
+  return segment->array[index - _mz_segmentedlist_segment_start(list, k)];
+}
+
+mz_ArraySlice mz_segmentedlist_segment(mz_SegmentedList *list, size_t k) {
+  mz_ArraySlice result = {NULL, 0};
+  if (k >= MZ_SEGMENTEDLIST_MAX_SEGMENTS) {
+    ERROR("segment is out of range - %zu", k);
+  } else {
+    size_t size = mz_segmentedlist_size(list);
+    size_t start = _mz_segmentedlist_segment_start(list, k);
+    mz_SegmentedListSegment *segment = atomic_load_explicit(&list->segments[k], memory_order_acquire);
+    if (segment && start < size) {
+      size_t capacity = (size_t) 1 << (list->segment_shift + k);
+      result.array = segment->array;
+      result.size = size - start < capacity ? size - start : capacity;
+    }
+  }
+  return result;
+}
@@ -0,0 +1,48 @@
+#ifndef __mz_segmentedlist__
+#define __mz_segmentedlist__
+
+#include <stdlib.h>
+#include <stdatomic.h>
+#include "type.h"
+#include "arraylist.h"
+
+#define MZ_SEGMENTEDLIST_MAX_SEGMENTS 48
+
+//append-only list for concurrent writers. storage is a series of segments that double
+//in size and are never moved, so element addresses are stable and get stays O(1).
+//segment k holds segment_capacity << k elements, each with a ready flag.
+//appends reserve an index with one fetch-add, write the element, set its flag and then
+//advance published over every ready element, so no appender waits for another one and
+//readers always see a gap-free prefix [0, mz_segmentedlist_size)
+typedef struct mz_SegmentedListSegment {
+  atomic_uchar *ready;
+  void *array[];
+} mz_SegmentedListSegment;
+
+typedef struct mz_SegmentedList {
+  size_t segment_shift;
+  _Atomic(mz_SegmentedListSegment *) segments[MZ_SEGMENTEDLIST_MAX_SEGMENTS];
+  _Alignas(MZ_CACHE_LINE_SIZE) atomic_size_t reserved;
+  _Alignas(MZ_CACHE_LINE_SIZE) atomic_size_t published;
+  char padding[MZ_CACHE_LINE_SIZE - sizeof(atomic_size_t)];
+} mz_SegmentedList;
+
+//segment_capacity is rounded up to a power of two
+mz_SegmentedList *mz_segmentedlist_new(size_t segment_capacity);
+
+void mz_segmentedlist_free(mz_SegmentedList *list);
+
+//returns the index of the element, or MZ_NPOS if its segment could not be allocated
+size_t mz_segmentedlist_append(mz_SegmentedList *list, void *element);
+
+void *mz_segmentedlist_get(mz_SegmentedList *list, size_t index);
+
+//the published elements of segment k as a slice, empty past the last published element.
+//scanning segment by segment avoids the index arithmetic of get
+mz_ArraySlice mz_segmentedlist_segment(mz_SegmentedList *list, size_t k);
+
+static inline size_t mz_segmentedlist_size(mz_SegmentedList *list) {
+  return atomic_load_explicit(&list->published, memory_order_acquire);
+}
+
+#endif
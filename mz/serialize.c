@@ -0,0 +1,429 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include "serialize.h"
+#include "logger.h"
+#include "type.h"
+
+//elements reserved before they arrive, in stream buffers, so a corrupt count can not
+//allocate more than the stream holds up front
+#define _MZ_SERIALIZE_RESERVE_BUFFERS 4
+
+bool mz_streamwriter_init(mz_StreamWriter *writer, bool (*write_fn)(void *context, const void *data, size_t len),
+                          void *context, size_t buffer_size) {
+  bool result = false;
+  if (buffer_size < 1) {
+    ERROR("invalid buffer_size for streamwriter. buffer_size must be greater than 1");
+  } else {
+    writer->write_fn = write_fn;
+    writer->context = context;
+    writer->buffer_size = buffer_size;
+    writer->used = 0;
+    writer->failed = false;
+    writer->buffer = malloc(buffer_size);
+    if (!writer->buffer) {
+      ERROR("could not allocate memory for streamwriter->buffer");
+    } else {
+      result = true;
+    }
+  }
+  return result;
+}
+
+void mz_streamwriter_destroy(mz_StreamWriter *writer) {
+  if (writer) {
+    free(writer->buffer);
+    writer->buffer = NULL;
+  }
+}
+
+bool mz_streamwriter_flush(mz_StreamWriter *writer) {
+  if (!writer->failed && writer->used > 0) {
+    if (!(*writer->write_fn)(writer->context, writer->buffer, writer->used)) {
+      ERROR("could not write stream");
+      writer->failed = true;
+    }
+    writer->used = 0;
+  }
+  return !writer->failed;
+}
+
+bool mz_streamwriter_write(mz_StreamWriter *writer, const void *data, size_t len) {
+  if (writer->failed) {
+    return false;
+  }
+  if (writer->used + len <= writer->buffer_size) {
+    memcpy(writer->buffer + writer->used, data, len);
+    writer->used += len;
+  } else if (mz_streamwriter_flush(writer)) {
+    if (len >= writer->buffer_size) {
+      //too large to be worth buffering
+      if (!(*writer->write_fn)(writer->context, data, len)) {
+        ERROR("could not write stream");
+        writer->failed = true;
+      }
+    } else {
+      memcpy(writer->buffer, data, len);
+      writer->used = len;
+    }
+  }
+  return !writer->failed;
+}
+
+bool mz_streamwriter_write_u64(mz_StreamWriter *writer, uint64_t value) {
+  return mz_streamwriter_write(writer, &value, sizeof(value));
+}
+
+bool mz_streamreader_init(mz_StreamReader *reader, size_t (*read_fn)(void *context, void *data, size_t len),
+                          void *context, size_t buffer_size) {
+  bool result = false;
+  if (buffer_size < 1) {
+    ERROR("invalid buffer_size for streamreader. buffer_size must be greater than 1");
+  } else {
+    reader->read_fn = read_fn;
+    reader->context = context;
+    reader->buffer_size = buffer_size;
+    reader->position = 0;
+    reader->available = 0;
+    reader->failed = false;
+    reader->buffer = malloc(buffer_size);
+    if (!reader->buffer) {
+      ERROR("could not allocate memory for streamreader->buffer");
+    } else {
+      result = true;
+    }
+  }
+  return result;
+}
+
+void mz_streamreader_destroy(mz_StreamReader *reader) {
+  if (reader) {
+    free(reader->buffer);
+    reader->buffer = NULL;
+  }
+}
+
+bool mz_streamreader_read(mz_StreamReader *reader, void *data, size_t len) {
+  char *destination = data;
+  size_t buffered = reader->available - reader->position;
+  size_t count = buffered < len ? buffered : len;
+  memcpy(destination, reader->buffer + reader->position, count);
+  reader->position += count;
+  destination += count;
+  len -= count;
+  while (len > 0 && !reader->failed) {
+    size_t n;
+    if (len >= reader->buffer_size) {
+      //read large requests straight into the destination
+      n = (*reader->read_fn)(reader->context, destination, len);
+      destination += n;
+      len -= n;
+    } else {
+      n = (*reader->read_fn)(reader->context, reader->buffer, reader->buffer_size);
+      reader->position = 0;
+      reader->available = n;
+      count = n < len ? n : len;
+      memcpy(destination, reader->buffer, count);
+      reader->position = count;
+      destination += count;
+      len -= count;
+    }
+    if (n == 0) {
+      ERROR("unexpected end of stream");
+      reader->failed = true;
+    }
+  }
+  return !reader->failed;
+}
+
+bool mz_streamreader_read_u64(mz_StreamReader *reader, uint64_t *value) {
+  return mz_streamreader_read(reader, value, sizeof(*value));
+}
+
+const void *mz_streamreader_peek(mz_StreamReader *reader, size_t len) {
+  if (reader->failed || len > reader->buffer_size) {
+    return NULL;
+  }
+  if (reader->available - reader->position < len) {
+    //move the unread bytes to the front and refill behind them
+    reader->available -= reader->position;
+    memmove(reader->buffer, reader->buffer + reader->position, reader->available);
+    reader->position = 0;
+    while (reader->available < len) {
+      size_t n = (*reader->read_fn)(reader->context, reader->buffer + reader->available,
+                                    reader->buffer_size - reader->available);
+      if (n == 0) {
+        ERROR("unexpected end of stream");
+        reader->failed = true;
+        return NULL;
+      }
+      reader->available += n;
+    }
+  }
+  return reader->buffer + reader->position;
+}
+
+bool mz_streamreader_skip(mz_StreamReader *reader, size_t len) {
+  if (mz_streamreader_peek(reader, len) != NULL) {
+    reader->position += len;
+  } else if (!reader->failed) {
+    //larger than the buffer, fall back to reading through it
+    char chunk[256];
+    while (len > 0 && !reader->failed) {
+      size_t count = len < sizeof(chunk) ? len : sizeof(chunk);
+      mz_streamreader_read(reader, chunk, count);
+      len -= count;
+    }
+  }
+  return !reader->failed;
+}
+
+bool mz_stream_fd_write(void *context, const void *data, size_t len) {
+  int fd = *(int *) context;
+  const char *bytes = data;
+  while (len > 0) {
+    ssize_t n = write(fd, bytes, len);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      ERROR("could not write to fd %d", fd);
+      return false;
+    }
+    bytes += n;
+    len -= (size_t) n;
+  }
+  return true;
+}
+
+size_t mz_stream_fd_read(void *context, void *data, size_t len) {
+  int fd = *(int *) context;
+  ssize_t n;
+  do {
+    n = read(fd, data, len);
+  } while (n < 0 && errno == EINTR);
+  if (n < 0) {
+    ERROR("could not read from fd %d", fd);
+    n = 0;
+  }
+  return (size_t) n;
+}
+
+bool _mz_serialize_write_header(mz_StreamWriter *writer, uint32_t magic, uint64_t count) {
+  uint32_t header[2] = {magic, MZ_SERIALIZE_VERSION};
+  return mz_streamwriter_write(writer, header, sizeof(header)) &&
+         mz_streamwriter_write_u64(writer, count);
+}
+
+bool _mz_serialize_read_header(mz_StreamReader *reader, uint32_t magic, uint64_t *count) {
+  bool result = false;
+  uint32_t header[2];
+  if (!mz_streamreader_read(reader, header, sizeof(header)) || !mz_streamreader_read_u64(reader, count)) {
+    ERROR("could not read header");
+  } else if (header[0] != magic) {
+    ERROR("unexpected magic number - %x", header[0]);
+  } else if (header[1] != MZ_SERIALIZE_VERSION) {
+    ERROR("unsupported version - %u", header[1]);
+  } else {
+    result = true;
+  }
+  return result;
+}
+
+bool mz_serialize_write_element(mz_StreamWriter *writer, const void *element,
+                                const void *(*mz_serialize_encode_fn)(const void *element, size_t *len)) {
+  if (!mz_serialize_encode_fn) {
+    return mz_streamwriter_write_u64(writer, (uint64_t) (uintptr_t) element);
+  }
+  size_t len = 0;
+  const void *data = (*mz_serialize_encode_fn)(element, &len);
+  return mz_streamwriter_write_u64(writer, len) && mz_streamwriter_write(writer, data, len);
+}
+
+bool mz_serialize_read_element(mz_StreamReader *reader, void **element,
+                               void *(*mz_serialize_decode_fn)(const void *data, size_t len)) {
+  uint64_t value;
+  if (!mz_streamreader_read_u64(reader, &value)) {
+    return false;
+  }
+  if (!mz_serialize_decode_fn) {
+    *element = (void *) (uintptr_t) value;
+    return true;
+  }
+  size_t len = (size_t) value;
+  const void *data = mz_streamreader_peek(reader, len);
+  if (data) {
+    //decode straight out of the read buffer
+    *element = (*mz_serialize_decode_fn)(data, len);
+    reader->position += len;
+  } else if (!reader->failed) {
+    void *scratch = malloc(len);
+    if (!scratch) {
+      ERROR("could not allocate memory for element of %zu bytes", len);
+      return false;
+    }
+    if (mz_streamreader_read(reader, scratch, len)) {
+      *element = (*mz_serialize_decode_fn)(scratch, len);
+    }
+    free(scratch);
+  }
+  return !reader->failed;
+}
+
+bool mz_arraylist_serialize(mz_ArrayList *list, mz_StreamWriter *writer,
+                            const void *(*mz_serialize_encode_fn)(const void *element, size_t *len)) {
+  bool result = false;
+  if (!list) {
+    ERROR("list is null");
+  } else if (_mz_serialize_write_header(writer, MZ_SERIALIZE_ARRAYLIST_MAGIC, list->size)) {
+    for (size_t i = 0; i < list->size && !writer->failed; i++) {
+      mz_serialize_write_element(writer, list->array[i], mz_serialize_encode_fn);
+    }
+    result = !writer->failed;
+  }
+  return result;
+}
+
+//releases a list that failed to deserialize along with the elements decoded into it
+void _mz_serialize_free_arraylist(mz_ArrayList *list, void (*mz_serialize_free_fn)(void *element)) {
+  if (list && mz_serialize_free_fn) {
+    for (size_t i = 0; i < list->size; i++) {
+      (*mz_serialize_free_fn)(list->array[i]);
+    }
+  }
+  mz_arraylist_free(list);
+}
+
+mz_ArrayList *mz_arraylist_deserialize(mz_StreamReader *reader,
+                                       void *(*mz_serialize_decode_fn)(const void *data, size_t len),
+                                       void (*mz_serialize_free_fn)(void *element)) {
+  mz_ArrayList *list = NULL;
+  uint64_t count;
+  if (_mz_serialize_read_header(reader, MZ_SERIALIZE_ARRAYLIST_MAGIC, &count)) {
+    size_t reserve_limit = _MZ_SERIALIZE_RESERVE_BUFFERS * reader->buffer_size;
+    if (count > SIZE_MAX / sizeof(void *)) {
+      ERROR("invalid arraylist element count - %llu", (unsigned long long) count);
+      return NULL;
+    }
+    list = mz_arraylist_new(MZ_ARRAYLIST_INLINE_CAPACITY, sizeof(void *));
+    if (!list || !mz_arraylist_reserve(list, count < reserve_limit ? count : reserve_limit)) {
+      ERROR("could not allocate arraylist for %llu elements", (unsigned long long) count);
+      mz_arraylist_free(list);
+      return NULL;
+    }
+    for (uint64_t i = 0; i < count; i++) {
+      void *element = NULL;
+      if (!mz_serialize_read_element(reader, &element, mz_serialize_decode_fn)) {
+        ERROR("could not read element %llu", (unsigned long long) i);
+        _mz_serialize_free_arraylist(list, mz_serialize_free_fn);
+        return NULL;
+      }
+      //grows past the reserved capacity only as elements actually arrive
+      if (!mz_arraylist_append(list, element)) {
+        if (mz_serialize_free_fn) {
+          (*mz_serialize_free_fn)(element);
+        }
+        _mz_serialize_free_arraylist(list, mz_serialize_free_fn);
+        return NULL;
+      }
+    }
+  }
+  return list;
+}
+
+bool mz_linkedlist_serialize(mz_LinkedList *list, mz_StreamWriter *writer,
+                             const void *(*mz_serialize_encode_fn)(const void *element, size_t *len)) {
+  bool result = false;
+  if (!list) {
+    ERROR("list is null");
+  } else if (_mz_serialize_write_header(writer, MZ_SERIALIZE_LINKEDLIST_MAGIC, list->count)) {
+    mz_LinkedListNode *node;
+    for (node = list->first; node != NULL && !writer->failed; node = node->next) {
+      mz_serialize_write_element(writer, node->value, mz_serialize_encode_fn);
+    }
+    result = !writer->failed;
+  }
+  return result;
+}
+
+//releases a list that failed to deserialize along with the elements decoded into it
+void _mz_serialize_free_linkedlist(mz_LinkedList *list, void (*mz_serialize_free_fn)(void *element)) {
+  if (mz_serialize_free_fn) {
+    for (mz_LinkedListNode *node = list->first; node != NULL; node = node->next) {
+      (*mz_serialize_free_fn)(node->value);
+    }
+  }
+  mz_linkedlist_free(list);
+}
+
+mz_LinkedList *mz_linkedlist_deserialize(mz_StreamReader *reader,
+                                         void *(*mz_serialize_decode_fn)(const void *data, size_t len),
+                                         void (*mz_serialize_free_fn)(void *element)) {
+  mz_LinkedList *list = NULL;
+  uint64_t count;
+  if (_mz_serialize_read_header(reader, MZ_SERIALIZE_LINKEDLIST_MAGIC, &count)) {
+    list = mz_linkedlist_new();
+    for (uint64_t i = 0; list && i < count; i++) {
+      void *element = NULL;
+      if (!mz_serialize_read_element(reader, &element, mz_serialize_decode_fn)) {
+        ERROR("could not read element %llu", (unsigned long long) i);
+        _mz_serialize_free_linkedlist(list, mz_serialize_free_fn);
+        return NULL;
+      }
+      //the list is known to exist, so only the node allocation can fail
+      if (!mz_linkedlist_push_unchecked(list, element)) {
+        ERROR("could not allocate node for element %llu", (unsigned long long) i);
+        if (mz_serialize_free_fn) {
+          (*mz_serialize_free_fn)(element);
+        }
+        _mz_serialize_free_linkedlist(list, mz_serialize_free_fn);
+        return NULL;
+      }
+    }
+  }
+  return list;
+}
+
+bool mz_packedlist_serialize(mz_PackedList *list, mz_StreamWriter *writer) {
+  bool result = false;
+  if (!list) {
+    ERROR("list is null");
+  } else {
+    result = _mz_serialize_write_header(writer, MZ_SERIALIZE_PACKEDLIST_MAGIC, list->size) &&
+             mz_streamwriter_write_u64(writer, list->element_size) &&
+             mz_streamwriter_write(writer, list->data, list->size * list->element_size);
+  }
+  return result;
+}
+
+mz_PackedList *mz_packedlist_deserialize(mz_StreamReader *reader) {
+  mz_PackedList *list = NULL;
+  uint64_t count;
+  uint64_t element_size;
+  if (_mz_serialize_read_header(reader, MZ_SERIALIZE_PACKEDLIST_MAGIC, &count) &&
+      mz_streamreader_read_u64(reader, &element_size)) {
+    if (element_size == 0 || element_size > SIZE_MAX || count > SIZE_MAX / element_size) {
+      ERROR("invalid packedlist header - %llu elements of %llu bytes", (unsigned long long) count,
+            (unsigned long long) element_size);
+      return NULL;
+    }
+    //elements are read a few buffers at a time, so the list only grows as bytes arrive
+    size_t chunk = _MZ_SERIALIZE_RESERVE_BUFFERS * reader->buffer_size / element_size;
+    chunk = chunk > 0 ? chunk : 1;
+    list = mz_packedlist_new(count > 0 && count < chunk ? count : chunk, element_size);
+    while (list && list->size < count) {
+      size_t len = count - list->size < chunk ? count - list->size : chunk;
+      if (!mz_packedlist_reserve(list, list->size + len) ||
+          !mz_streamreader_read(reader, list->data + list->size * element_size, len * element_size)) {
+        ERROR("could not read packedlist elements");
+        mz_packedlist_free(list);
+        list = NULL;
+      } else {
+        list->size += len;
+      }
+    }
+  }
+  return list;
+}
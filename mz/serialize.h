@@ -0,0 +1,104 @@
+#ifndef __mz_serialize__
+#define __mz_serialize__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "type.h"
+#include "arraylist.h"
+#include "linkedlist.h"
+#include "packedlist.h"
+
+//binary format: a header of magic, version and element count followed by the elements.
+//with an encode callback every element is written as a u64 length and its bytes,
+//without one the pointer value itself is written as a u64. integers use host byte order
+#define MZ_SERIALIZE_ARRAYLIST_MAGIC 0x4c415a4d
+#define MZ_SERIALIZE_LINKEDLIST_MAGIC 0x4c4c5a4d
+#define MZ_SERIALIZE_PACKEDLIST_MAGIC 0x53505a4d
+#define MZ_SERIALIZE_VERSION 1
+
+#define MZ_STREAM_DEFAULT_BUFFER_SIZE (64 * 1024)
+
+//buffers small writes and hands them to write_fn in large batches.
+//write_fn returns false on failure, after which every write fails
+typedef struct mz_StreamWriter {
+  bool (*write_fn)(void *context, const void *data, size_t len);
+  void *context;
+  char *buffer;
+  size_t buffer_size;
+  size_t used;
+  bool failed;
+} mz_StreamWriter;
+
+//read_fn returns the number of bytes read, 0 at the end of the stream or on failure
+typedef struct mz_StreamReader {
+  size_t (*read_fn)(void *context, void *data, size_t len);
+  void *context;
+  char *buffer;
+  size_t buffer_size;
+  size_t position;
+  size_t available;
+  bool failed;
+} mz_StreamReader;
+
+bool mz_streamwriter_init(mz_StreamWriter *writer, bool (*write_fn)(void *context, const void *data, size_t len),
+                          void *context, size_t buffer_size);
+
+void mz_streamwriter_destroy(mz_StreamWriter *writer);
+
+bool mz_streamwriter_write(mz_StreamWriter *writer, const void *data, size_t len);
+
+bool mz_streamwriter_write_u64(mz_StreamWriter *writer, uint64_t value);
+
+bool mz_streamwriter_flush(mz_StreamWriter *writer);
+
+bool mz_streamreader_init(mz_StreamReader *reader, size_t (*read_fn)(void *context, void *data, size_t len),
+                          void *context, size_t buffer_size);
+
+void mz_streamreader_destroy(mz_StreamReader *reader);
+
+bool mz_streamreader_read(mz_StreamReader *reader, void *data, size_t len);
+
+bool mz_streamreader_read_u64(mz_StreamReader *reader, uint64_t *value);
+
+//returns len buffered bytes without copying them, or NULL if len does not fit in the buffer
+const void *mz_streamreader_peek(mz_StreamReader *reader, size_t len);
+
+bool mz_streamreader_skip(mz_StreamReader *reader, size_t len);
+
+//callbacks for file descriptors, context points to an int
+bool mz_stream_fd_write(void *context, const void *data, size_t len);
+
+size_t mz_stream_fd_read(void *context, void *data, size_t len);
+
+//a single element in the format of the list serializers, for callers streaming elements
+//without a list header. without a decode callback the pointer value itself is read back
+bool mz_serialize_write_element(mz_StreamWriter *writer, const void *element,
+                                const void *(*mz_serialize_encode_fn)(const void *element, size_t *len));
+
+bool mz_serialize_read_element(mz_StreamReader *reader, void **element,
+                               void *(*mz_serialize_decode_fn)(const void *data, size_t len));
+
+//encode returns the bytes of an element and their length, the bytes only need to stay valid
+//until the next call. decode builds a new element from bytes that are only valid during the call.
+//when deserializing fails, free_fn releases the elements decoded so far. it may be NULL, and
+//should be without a decode callback, since the elements are then raw pointer values
+bool mz_arraylist_serialize(mz_ArrayList *list, mz_StreamWriter *writer,
+                            const void *(*mz_serialize_encode_fn)(const void *element, size_t *len));
+
+mz_ArrayList *mz_arraylist_deserialize(mz_StreamReader *reader,
+                                       void *(*mz_serialize_decode_fn)(const void *data, size_t len),
+                                       void (*mz_serialize_free_fn)(void *element));
+
+bool mz_linkedlist_serialize(mz_LinkedList *list, mz_StreamWriter *writer,
+                             const void *(*mz_serialize_encode_fn)(const void *element, size_t *len));
+
+mz_LinkedList *mz_linkedlist_deserialize(mz_StreamReader *reader,
+                                         void *(*mz_serialize_decode_fn)(const void *data, size_t len),
+                                         void (*mz_serialize_free_fn)(void *element));
+
+bool mz_packedlist_serialize(mz_PackedList *list, mz_StreamWriter *writer);
+
+mz_PackedList *mz_packedlist_deserialize(mz_StreamReader *reader);
+
+#endif
@@ -0,0 +1,313 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "simd.h"
+#include "logger.h"
+#include "type.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define _MZ_SIMD_X86
+#endif
+
+//R = A compare B, for scalars as well as vectors
+#define _MZ_SIMD_COMPARE(R, A, B, COMPARE) \
+  switch (COMPARE) { \
+    case mz_SimdCompareEqual: R = (A) == (B); break; \
+    case mz_SimdCompareNotEqual: R = (A) != (B); break; \
+    case mz_SimdCompareLess: R = (A) < (B); break; \
+    case mz_SimdCompareLessEqual: R = (A) <= (B); break; \
+    case mz_SimdCompareGreater: R = (A) > (B); break; \
+    default: R = (A) >= (B); break; \
+  }
+
+//R = whether any lane of the mask M is set
+#define _MZ_SIMD_ANY(R, M, BYTES) { \
+    uint64_t words[(BYTES) / 8]; \
+    uint64_t bits = 0; \
+    memcpy(words, &(M), (BYTES)); \
+    for (size_t w = 0; w < (BYTES) / 8; w++) { \
+      bits |= words[w]; \
+    } \
+    R = bits != 0; \
+  }
+
+//the lane counters of count are drained before they can overflow
+#define _MZ_SIMD_COUNT_FLUSH (1 << 20)
+
+#define _MZ_SIMD_SCALAR_EXTREMUM(FN, OP, NAME, T) \
+  bool _mz_simd_##FN##_##NAME##_scalar(const T *data, size_t len, T *result) { \
+    if (len == 0) { \
+      return false; \
+    } \
+    T best = data[0]; \
+    for (size_t i = 1; i < len; i++) { \
+      if (data[i] OP best) { \
+        best = data[i]; \
+      } \
+    } \
+    *result = best; \
+    return true; \
+  }
+
+//T is the element type, S the type sums are accumulated in and O the type they are returned as
+#define _MZ_SIMD_SCALAR_KERNELS(NAME, T, S, O) \
+  size_t _mz_simd_find_##NAME##_scalar(const T *data, size_t len, T value) { \
+    for (size_t i = 0; i < len; i++) { \
+      if (data[i] == value) { \
+        return i; \
+      } \
+    } \
+    return MZ_NPOS; \
+  } \
+  size_t _mz_simd_count_##NAME##_scalar(const T *data, size_t len, mz_SimdCompare compare, T value) { \
+    size_t count = 0; \
+    for (size_t i = 0; i < len; i++) { \
+      int hit; \
+      _MZ_SIMD_COMPARE(hit, data[i], value, compare); \
+      count += hit; \
+    } \
+    return count; \
+  } \
+  _MZ_SIMD_SCALAR_EXTREMUM(min, <, NAME, T) \
+  _MZ_SIMD_SCALAR_EXTREMUM(max, >, NAME, T) \
+  O _mz_simd_sum_##NAME##_scalar(const T *data, size_t len) { \
+    S sum = 0; \
+    for (size_t i = 0; i < len; i++) { \
+      sum += (S) data[i]; \
+    } \
+    return (O) sum; \
+  } \
+  size_t _mz_simd_compact_##NAME##_scalar(const T *data, size_t len, mz_SimdCompare compare, T value, T *out) { \
+    size_t count = 0; \
+    for (size_t i = 0; i < len; i++) { \
+      int hit; \
+      T element = data[i]; \
+      _MZ_SIMD_COMPARE(hit, element, value, compare); \
+      if (hit) { \
+        out[count++] = element; \
+      } \
+    } \
+    return count; \
+  }
+
+_MZ_SIMD_SCALAR_KERNELS(int32, int32_t, uint64_t, int64_t)
+_MZ_SIMD_SCALAR_KERNELS(int64, int64_t, uint64_t, int64_t)
+_MZ_SIMD_SCALAR_KERNELS(float, float, double, double)
+_MZ_SIMD_SCALAR_KERNELS(double, double, double, double)
+
+#ifdef _MZ_SIMD_X86
+
+//min and max keep a best vector and blend in the lanes of every chunk that beat it
+#define _MZ_SIMD_VECTOR_EXTREMUM(FN, OP, LEVEL, BYTES, NAME, T) \
+  bool _mz_simd_##FN##_##NAME##_##LEVEL(const T *data, size_t len, T *result) { \
+    const size_t lanes = (BYTES) / sizeof(T); \
+    if (len < lanes) { \
+      return _mz_simd_##FN##_##NAME##_scalar(data, len, result); \
+    } \
+    _mz_simd_##NAME##_##LEVEL##_vector best; \
+    memcpy(&best, data, (BYTES)); \
+    size_t i = lanes; \
+    for (; i + lanes <= len; i += lanes) { \
+      _mz_simd_##NAME##_##LEVEL##_vector chunk; \
+      memcpy(&chunk, data + i, (BYTES)); \
+      _mz_simd_##NAME##_##LEVEL##_mask better = chunk OP best; \
+      best = (_mz_simd_##NAME##_##LEVEL##_vector) \
+             (((_mz_simd_##NAME##_##LEVEL##_mask) chunk & better) | \
+              ((_mz_simd_##NAME##_##LEVEL##_mask) best & ~better)); \
+    } \
+    T value = best[0]; \
+    for (size_t j = 1; j < lanes; j++) { \
+      if (best[j] OP value) { \
+        value = best[j]; \
+      } \
+    } \
+    T tail; \
+    if (_mz_simd_##FN##_##NAME##_scalar(data + i, len - i, &tail) && tail OP value) { \
+      value = tail; \
+    } \
+    *result = value; \
+    return true; \
+  }
+
+//every kernel runs over whole vectors and leaves the remainder to its scalar version.
+//M is the signed integer type of T's size that vector comparisons produce
+#define _MZ_SIMD_VECTOR_KERNELS(LEVEL, BYTES, NAME, T, M, S, O) \
+  typedef T _mz_simd_##NAME##_##LEVEL##_vector __attribute__((vector_size(BYTES))); \
+  typedef M _mz_simd_##NAME##_##LEVEL##_mask __attribute__((vector_size(BYTES))); \
+  typedef S _mz_simd_##NAME##_##LEVEL##_sum __attribute__((vector_size(BYTES))); \
+  typedef T _mz_simd_##NAME##_##LEVEL##_narrow __attribute__((vector_size((BYTES) / (sizeof(S) / sizeof(T))))); \
+  size_t _mz_simd_find_##NAME##_##LEVEL(const T *data, size_t len, T value) { \
+    const size_t lanes = (BYTES) / sizeof(T); \
+    _mz_simd_##NAME##_##LEVEL##_vector needle = (_mz_simd_##NAME##_##LEVEL##_vector) {0} + value; \
+    size_t i = 0; \
+    for (; i + lanes <= len; i += lanes) { \
+      _mz_simd_##NAME##_##LEVEL##_vector chunk; \
+      memcpy(&chunk, data + i, (BYTES)); \
+      _mz_simd_##NAME##_##LEVEL##_mask hits = chunk == needle; \
+      bool any; \
+      _MZ_SIMD_ANY(any, hits, BYTES); \
+      if (any) { \
+        for (size_t j = 0; j < lanes; j++) { \
+          if (hits[j]) { \
+            return i + j; \
+          } \
+        } \
+      } \
+    } \
+    size_t tail = _mz_simd_find_##NAME##_scalar(data + i, len - i, value); \
+    return tail == MZ_NPOS ? MZ_NPOS : i + tail; \
+  } \
+  size_t _mz_simd_count_##NAME##_##LEVEL(const T *data, size_t len, mz_SimdCompare compare, T value) { \
+    const size_t lanes = (BYTES) / sizeof(T); \
+    _mz_simd_##NAME##_##LEVEL##_vector bound = (_mz_simd_##NAME##_##LEVEL##_vector) {0} + value; \
+    _mz_simd_##NAME##_##LEVEL##_mask total = {0}; \
+    size_t count = 0; \
+    size_t pending = 0; \
+    size_t i = 0; \
+    for (; i + lanes <= len; i += lanes) { \
+      _mz_simd_##NAME##_##LEVEL##_vector chunk; \
+      _mz_simd_##NAME##_##LEVEL##_mask hits; \
+      memcpy(&chunk, data + i, (BYTES)); \
+      _MZ_SIMD_COMPARE(hits, chunk, bound, compare); \
+      /* set lanes are -1 */ \
+      total -= hits; \
+      if (++pending == _MZ_SIMD_COUNT_FLUSH) { \
+        for (size_t j = 0; j < lanes; j++) { \
+          count += (size_t) total[j]; \
+        } \
+        total = (_mz_simd_##NAME##_##LEVEL##_mask) {0}; \
+        pending = 0; \
+      } \
+    } \
+    for (size_t j = 0; j < lanes; j++) { \
+      count += (size_t) total[j]; \
+    } \
+    return count + _mz_simd_count_##NAME##_scalar(data + i, len - i, compare, value); \
+  } \
+  _MZ_SIMD_VECTOR_EXTREMUM(min, <, LEVEL, BYTES, NAME, T) \
+  _MZ_SIMD_VECTOR_EXTREMUM(max, >, LEVEL, BYTES, NAME, T) \
+  O _mz_simd_sum_##NAME##_##LEVEL(const T *data, size_t len) { \
+    /* elements are widened to S, so a step covers as many elements as S fits in a vector */ \
+    const size_t lanes = (BYTES) / sizeof(S); \
+    _mz_simd_##NAME##_##LEVEL##_sum total = {0}; \
+    size_t i = 0; \
+    for (; i + lanes <= len; i += lanes) { \
+      _mz_simd_##NAME##_##LEVEL##_narrow chunk; \
+      memcpy(&chunk, data + i, sizeof(chunk)); \
+      total += __builtin_convertvector(chunk, _mz_simd_##NAME##_##LEVEL##_sum); \
+    } \
+    S sum = 0; \
+    for (size_t j = 0; j < lanes; j++) { \
+      sum += total[j]; \
+    } \
+    return (O) (sum + (S) _mz_simd_sum_##NAME##_scalar(data + i, len - i)); \
+  } \
+  size_t _mz_simd_compact_##NAME##_##LEVEL(const T *data, size_t len, mz_SimdCompare compare, T value, T *out) { \
+    const size_t lanes = (BYTES) / sizeof(T); \
+    _mz_simd_##NAME##_##LEVEL##_vector bound = (_mz_simd_##NAME##_##LEVEL##_vector) {0} + value; \
+    size_t count = 0; \
+    size_t i = 0; \
+    for (; i + lanes <= len; i += lanes) { \
+      _mz_simd_##NAME##_##LEVEL##_vector chunk; \
+      _mz_simd_##NAME##_##LEVEL##_mask hits; \
+      memcpy(&chunk, data + i, (BYTES)); \
+      _MZ_SIMD_COMPARE(hits, chunk, bound, compare); \
+      bool any; \
+      _MZ_SIMD_ANY(any, hits, BYTES); \
+      if (any) { \
+        /* the chunk is already loaded, so out may overlap it */ \
+        for (size_t j = 0; j < lanes; j++) { \
+          if (hits[j]) { \
+            out[count++] = chunk[j]; \
+          } \
+        } \
+      } \
+    } \
+    return count + _mz_simd_compact_##NAME##_scalar(data + i, len - i, compare, value, out + count); \
+  }
+
+#define _MZ_SIMD_VECTOR_LEVEL(LEVEL, BYTES) \
+  _MZ_SIMD_VECTOR_KERNELS(LEVEL, BYTES, int32, int32_t, int32_t, uint64_t, int64_t) \
+  _MZ_SIMD_VECTOR_KERNELS(LEVEL, BYTES, int64, int64_t, int64_t, uint64_t, int64_t) \
+  _MZ_SIMD_VECTOR_KERNELS(LEVEL, BYTES, float, float, int32_t, double, double) \
+  _MZ_SIMD_VECTOR_KERNELS(LEVEL, BYTES, double, double, int64_t, double, double)
+
+#pragma GCC push_options
+#pragma GCC target("sse2")
+_MZ_SIMD_VECTOR_LEVEL(sse2, 16)
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+_MZ_SIMD_VECTOR_LEVEL(avx2, 32)
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+_MZ_SIMD_VECTOR_LEVEL(avx512, 64)
+#pragma GCC pop_options
+
+#define _MZ_SIMD_DISPATCH(FN, NAME, ARGS) \
+  switch (mz_simd_level()) { \
+    case mz_SimdLevelAvx512: return _mz_simd_##FN##_##NAME##_avx512 ARGS; \
+    case mz_SimdLevelAvx2: return _mz_simd_##FN##_##NAME##_avx2 ARGS; \
+    case mz_SimdLevelSse2: return _mz_simd_##FN##_##NAME##_sse2 ARGS; \
+    default: return _mz_simd_##FN##_##NAME##_scalar ARGS; \
+  }
+
+#else
+
+#define _MZ_SIMD_DISPATCH(FN, NAME, ARGS) return _mz_simd_##FN##_##NAME##_scalar ARGS;
+
+#endif
+
+#define _MZ_SIMD_PUBLIC(NAME, T, O) \
+  size_t mz_simd_find_##NAME(const T *data, size_t len, T value) { \
+    _MZ_SIMD_DISPATCH(find, NAME, (data, len, value)) \
+  } \
+  size_t mz_simd_count_##NAME(const T *data, size_t len, mz_SimdCompare compare, T value) { \
+    _MZ_SIMD_DISPATCH(count, NAME, (data, len, compare, value)) \
+  } \
+  bool mz_simd_min_##NAME(const T *data, size_t len, T *result) { \
+    _MZ_SIMD_DISPATCH(min, NAME, (data, len, result)) \
+  } \
+  bool mz_simd_max_##NAME(const T *data, size_t len, T *result) { \
+    _MZ_SIMD_DISPATCH(max, NAME, (data, len, result)) \
+  } \
+  O mz_simd_sum_##NAME(const T *data, size_t len) { \
+    _MZ_SIMD_DISPATCH(sum, NAME, (data, len)) \
+  } \
+  size_t mz_simd_compact_##NAME(const T *data, size_t len, mz_SimdCompare compare, T value, T *out) { \
+    _MZ_SIMD_DISPATCH(compact, NAME, (data, len, compare, value, out)) \
+  }
+
+_MZ_SIMD_PUBLIC(int32, int32_t, int64_t)
+_MZ_SIMD_PUBLIC(int64, int64_t, int64_t)
+_MZ_SIMD_PUBLIC(float, float, double)
+_MZ_SIMD_PUBLIC(double, double, double)
+
+atomic_int _mz_simd_forced_level = mz_SimdLevelAuto;
+
+mz_SimdLevel _mz_simd_detect_level() {
+#ifdef _MZ_SIMD_X86
+  //also checks that the os saves the wider registers
+  if (__builtin_cpu_supports("avx512f")) {
+    return mz_SimdLevelAvx512;
+  } else if (__builtin_cpu_supports("avx2")) {
+    return mz_SimdLevelAvx2;
+  } else if (__builtin_cpu_supports("sse2")) {
+    return mz_SimdLevelSse2;
+  }
+#endif
+  return mz_SimdLevelScalar;
+}
+
+mz_SimdLevel mz_simd_level() {
+  mz_SimdLevel detected = _mz_simd_detect_level();
+  mz_SimdLevel forced = atomic_load_explicit(&_mz_simd_forced_level, memory_order_relaxed);
+  return forced != mz_SimdLevelAuto && forced < detected ? forced : detected;
+}
+
+void mz_simd_force_level(mz_SimdLevel level) {
+  atomic_store_explicit(&_mz_simd_forced_level, level, memory_order_relaxed);
+}
@@ -0,0 +1,73 @@
+#ifndef __mz_simd__
+#define __mz_simd__
+
+#include <stdlib.h>
+#include <stdint.h>
+#include "type.h"
+
+//vectorized scans over inline numeric arrays, e.g. mz_packedlist_data of a packedlist of
+//int32_t. every kernel is compiled for SSE2, AVX2 and AVX-512 and the widest one the cpu
+//supports is picked at run time, with a scalar fallback on other architectures.
+//float sums are accumulated per lane, so rounding can differ from a sequential sum,
+//and min/max are unspecified when the data holds NaN
+typedef enum mz_SimdLevel {
+  mz_SimdLevelAuto,
+  mz_SimdLevelScalar,
+  mz_SimdLevelSse2,
+  mz_SimdLevelAvx2,
+  mz_SimdLevelAvx512
+} mz_SimdLevel;
+
+typedef enum mz_SimdCompare {
+  mz_SimdCompareEqual,
+  mz_SimdCompareNotEqual,
+  mz_SimdCompareLess,
+  mz_SimdCompareLessEqual,
+  mz_SimdCompareGreater,
+  mz_SimdCompareGreaterEqual
+} mz_SimdCompare;
+
+//the level kernels run at
+mz_SimdLevel mz_simd_level();
+
+//caps the level, e.g. to compare kernels in tests and benchmarks. mz_SimdLevelAuto
+//restores detection. levels the cpu does not support are ignored
+void mz_simd_force_level(mz_SimdLevel level);
+
+//index of the first element equal to value, or MZ_NPOS
+size_t mz_simd_find_int32(const int32_t *data, size_t len, int32_t value);
+size_t mz_simd_find_int64(const int64_t *data, size_t len, int64_t value);
+size_t mz_simd_find_float(const float *data, size_t len, float value);
+size_t mz_simd_find_double(const double *data, size_t len, double value);
+
+//number of elements e for which `e compare value` holds
+size_t mz_simd_count_int32(const int32_t *data, size_t len, mz_SimdCompare compare, int32_t value);
+size_t mz_simd_count_int64(const int64_t *data, size_t len, mz_SimdCompare compare, int64_t value);
+size_t mz_simd_count_float(const float *data, size_t len, mz_SimdCompare compare, float value);
+size_t mz_simd_count_double(const double *data, size_t len, mz_SimdCompare compare, double value);
+
+//min and max return false for an empty array
+bool mz_simd_min_int32(const int32_t *data, size_t len, int32_t *result);
+bool mz_simd_min_int64(const int64_t *data, size_t len, int64_t *result);
+bool mz_simd_min_float(const float *data, size_t len, float *result);
+bool mz_simd_min_double(const double *data, size_t len, double *result);
+
+bool mz_simd_max_int32(const int32_t *data, size_t len, int32_t *result);
+bool mz_simd_max_int64(const int64_t *data, size_t len, int64_t *result);
+bool mz_simd_max_float(const float *data, size_t len, float *result);
+bool mz_simd_max_double(const double *data, size_t len, double *result);
+
+//integers are summed into 64 bits and wrap around, floats are summed as doubles
+int64_t mz_simd_sum_int32(const int32_t *data, size_t len);
+int64_t mz_simd_sum_int64(const int64_t *data, size_t len);
+double mz_simd_sum_float(const float *data, size_t len);
+double mz_simd_sum_double(const double *data, size_t len);
+
+//copies the elements e for which `e compare value` holds to out, in order, and returns
+//how many were copied. out needs room for len elements and may be data itself
+size_t mz_simd_compact_int32(const int32_t *data, size_t len, mz_SimdCompare compare, int32_t value, int32_t *out);
+size_t mz_simd_compact_int64(const int64_t *data, size_t len, mz_SimdCompare compare, int64_t value, int64_t *out);
+size_t mz_simd_compact_float(const float *data, size_t len, mz_SimdCompare compare, float value, float *out);
+size_t mz_simd_compact_double(const double *data, size_t len, mz_SimdCompare compare, double value, double *out);
+
+#endif
@@ -0,0 +1,183 @@
+#include <stdlib.h>
+#include <string.h>
+#include "skiplist.h"
+#include "logger.h"
+#include "type.h"
+
+#define _MZ_SKIPLIST_SLAB_SIZE 4096
+
+size_t _mz_skiplist_node_size(size_t height) {
+  return sizeof(mz_SkipListNode) + height * sizeof(mz_SkipListNode *);
+}
+
+//xorshift64, two random bits per level give the 1/4 promotion probability
+size_t _mz_skiplist_random_height(mz_SkipList *list) {
+  uint64_t x = list->random_state;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  list->random_state = x;
+  size_t height = 1;
+  while (height < MZ_SKIPLIST_MAX_HEIGHT && (x & 3) == 0) {
+    height++;
+    x >>= 2;
+  }
+  return height;
+}
+
+mz_SkipListNode *_mz_skiplist_node_new(mz_SkipList *list, size_t height) {
+  mz_SkipListNode *node = list->free_nodes[height - 1];
+  if (!node) {
+    size_t node_size = _mz_skiplist_node_size(height);
+    size_t count = _MZ_SKIPLIST_SLAB_SIZE / node_size > 4 ? _MZ_SKIPLIST_SLAB_SIZE / node_size : 4;
+    char *slab = malloc(count * node_size);
+    if (!slab) {
+      ERROR("could not allocate memory for skiplist nodes");
+      return NULL;
+    }
+    if (!mz_arraylist_append(list->slabs, slab)) {
+      ERROR("could not track skiplist slab");
+      free(slab);
+      return NULL;
+    }
+    //free nodes are chained through next[0]
+    for (size_t i = 0; i < count; i++) {
+      mz_SkipListNode *free_node = (mz_SkipListNode *) (slab + i * node_size);
+      free_node->height = height;
+      free_node->next[0] = i + 1 < count ? (mz_SkipListNode *) (slab + (i + 1) * node_size) : NULL;
+    }
+    node = (mz_SkipListNode *) slab;
+  }
+  list->free_nodes[height - 1] = node->next[0];
+  return node;
+}
+
+void _mz_skiplist_node_free(mz_SkipList *list, mz_SkipListNode *node) {
+  node->next[0] = list->free_nodes[node->height - 1];
+  list->free_nodes[node->height - 1] = node;
+}
+
+//fills update with the last node on every level whose value is less than key,
+//or not greater than key if after_equal is set
+void _mz_skiplist_search(mz_SkipList *list, const void *key, bool after_equal, mz_SkipListNode **update) {
+  mz_SkipListNode *node = list->head;
+  for (size_t level = list->height; level-- > 0;) {
+    mz_SkipListNode *next = node->next[level];
+    while (next) {
+      int comparison = (*list->comparator_fn)(&next->value, &key);
+      if (comparison > 0 || (comparison == 0 && !after_equal)) {
+        break;
+      }
+      node = next;
+      next = node->next[level];
+    }
+    update[level] = node;
+  }
+}
+
+mz_SkipList *mz_skiplist_new(int (*mz_skiplist_comparator_fn)(const void *, const void *)) {
+  mz_SkipList *list = NULL;
+  if (!mz_skiplist_comparator_fn) {
+    ERROR("skiplist needs a comparator");
+  } else if (!(list = calloc(1, sizeof(mz_SkipList)))) {
+    ERROR("could not allocate memory for skiplist");
+  } else {
+    list->comparator_fn = mz_skiplist_comparator_fn;
+    list->height = 1;
+    list->random_state = 0x9e3779b97f4a7c15ULL;
+    list->head = calloc(1, _mz_skiplist_node_size(MZ_SKIPLIST_MAX_HEIGHT));
+    list->slabs = mz_arraylist_new(16, sizeof(void *));
+    if (!list->head || !list->slabs) {
+      ERROR("could not allocate memory for skiplist");
+      free(list->head);
+      if (list->slabs) {
+        mz_arraylist_free(list->slabs);
+      }
+      free(list);
+      list = NULL;
+    } else {
+      list->head->height = MZ_SKIPLIST_MAX_HEIGHT;
+    }
+  }
+  return list;
+}
+
+void mz_skiplist_free(mz_SkipList *list) {
+  if (list) {
+    for (size_t i = 0; i < list->slabs->size; i++) {
+      free(list->slabs->array[i]);
+    }
+    mz_arraylist_free(list->slabs);
+    free(list->head);
+    free(list);
+  }
+}
+
+bool mz_skiplist_insert(mz_SkipList *list, void *value) {
+  mz_SkipListNode *update[MZ_SKIPLIST_MAX_HEIGHT];
+  size_t height = _mz_skiplist_random_height(list);
+  mz_SkipListNode *node = _mz_skiplist_node_new(list, height);
+  if (!node) {
+    return false;
+  }
+  _mz_skiplist_search(list, value, true, update);
+  for (size_t level = list->height; level < height; level++) {
+    update[level] = list->head;
+  }
+  if (height > list->height) {
+    list->height = height;
+  }
+  node->value = value;
+  for (size_t level = 0; level < height; level++) {
+    node->next[level] = update[level]->next[level];
+    update[level]->next[level] = node;
+  }
+  list->size++;
+  return true;
+}
+
+bool mz_skiplist_remove(mz_SkipList *list, const void *key, void **value) {
+  mz_SkipListNode *update[MZ_SKIPLIST_MAX_HEIGHT];
+  _mz_skiplist_search(list, key, false, update);
+  mz_SkipListNode *node = update[0]->next[0];
+  if (!node || (*list->comparator_fn)(&node->value, &key) != 0) {
+    return false;
+  }
+  //update holds the last node before the first one equal to key on every level,
+  //so wherever node appears it follows update
+  for (size_t level = 0; level < node->height; level++) {
+    update[level]->next[level] = node->next[level];
+  }
+  while (list->height > 1 && !list->head->next[list->height - 1]) {
+    list->height--;
+  }
+  if (value) {
+    *value = node->value;
+  }
+  _mz_skiplist_node_free(list, node);
+  list->size--;
+  return true;
+}
+
+mz_SkipListNode *mz_skiplist_lower_bound(mz_SkipList *list, const void *key) {
+  mz_SkipListNode *update[MZ_SKIPLIST_MAX_HEIGHT];
+  _mz_skiplist_search(list, key, false, update);
+  return update[0]->next[0];
+}
+
+mz_SkipListNode *mz_skiplist_find(mz_SkipList *list, const void *key) {
+  mz_SkipListNode *node = mz_skiplist_lower_bound(list, key);
+  return node && (*list->comparator_fn)(&node->value, &key) == 0 ? node : NULL;
+}
+
+void mz_skiplist_clear(mz_SkipList *list) {
+  mz_SkipListNode *node = list->head->next[0];
+  while (node) {
+    mz_SkipListNode *next = node->next[0];
+    _mz_skiplist_node_free(list, node);
+    node = next;
+  }
+  memset(list->head->next, 0, MZ_SKIPLIST_MAX_HEIGHT * sizeof(mz_SkipListNode *));
+  list->height = 1;
+  list->size = 0;
+}
@@ -0,0 +1,67 @@
+#ifndef __mz_skiplist__
+#define __mz_skiplist__
+
+#include <stdlib.h>
+#include <stdint.h>
+#include "type.h"
+#include "arraylist.h"
+
+#define MZ_SKIPLIST_MAX_HEIGHT 32
+
+//next[0] links every node in order, the higher levels skip ahead
+typedef struct mz_SkipListNode {
+  void *value;
+  size_t height;
+  struct mz_SkipListNode *next[];
+} mz_SkipListNode;
+
+//ordered list with O(log n) expected insert, remove and find. a node is promoted to the next
+//level with probability 1/4. nodes are carved from slabs holding nodes of a single height, and
+//removed nodes go back to the free list of their height, so nodes are rarely allocated one by one
+typedef struct mz_SkipList {
+  size_t size;
+  size_t height;
+  uint64_t random_state;
+  int (*comparator_fn)(const void *, const void *);
+  mz_SkipListNode *head;
+  mz_SkipListNode *free_nodes[MZ_SKIPLIST_MAX_HEIGHT];
+  mz_ArrayList *slabs;
+} mz_SkipList;
+
+//the comparator receives pointers to the values, as with qsort
+mz_SkipList *mz_skiplist_new(int (*mz_skiplist_comparator_fn)(const void *, const void *));
+
+void mz_skiplist_free(mz_SkipList *list);
+
+//equal values keep their insertion order
+bool mz_skiplist_insert(mz_SkipList *list, void *value);
+
+//removes the first value equal to key, value may be NULL
+bool mz_skiplist_remove(mz_SkipList *list, const void *key, void **value);
+
+//the first node equal to key, or NULL
+mz_SkipListNode *mz_skiplist_find(mz_SkipList *list, const void *key);
+
+//the first node not less than key, or NULL. walk a range from there with mz_skiplist_next
+mz_SkipListNode *mz_skiplist_lower_bound(mz_SkipList *list, const void *key);
+
+void mz_skiplist_clear(mz_SkipList *list);
+
+static inline size_t mz_skiplist_size(mz_SkipList *list) {
+  return list->size;
+}
+
+static inline mz_SkipListNode *mz_skiplist_first(mz_SkipList *list) {
+  return list->head->next[0];
+}
+
+static inline mz_SkipListNode *mz_skiplist_next(mz_SkipListNode *node) {
+  return node->next[0];
+}
+
+#define mzm_skiplist_foreach(L, V) void * V = NULL;\
+                                   mz_SkipListNode *_mzm_skiplist_node_##V = (L)->head->next[0];\
+                                   for (; _mzm_skiplist_node_##V != NULL && ((V = _mzm_skiplist_node_##V->value) || 1);\
+                                        _mzm_skiplist_node_##V = _mzm_skiplist_node_##V->next[0])
+
+#endif
@@ -0,0 +1,142 @@
+#include <stdlib.h>
+#include <string.h>
+#include "sortedlist.h"
+#include "logger.h"
+#include "type.h"
+
+//the first index whose element is greater than key, or not less than key unless upper is set
+size_t _mz_sortedlist_bound(mz_ArrayList *list, const void *key, bool upper,
+                            int (*mz_sortedlist_comparator_fn)(const void *, const void *)) {
+  size_t start = 0;
+  size_t end = list->size;
+  while (start < end) {
+    size_t mid = start + (end - start) / 2;
+    int comparison = (*mz_sortedlist_comparator_fn)(&list->array[mid], &key);
+    if (comparison < 0 || (upper && comparison == 0)) {
+      start = mid + 1;
+    } else {
+      end = mid;
+    }
+  }
+  return start;
+}
+
+size_t _mz_sortedlist_delta_limit(mz_SortedList *list) {
+  size_t limit = MZ_SORTEDLIST_MIN_DELTA;
+  while (limit * limit < list->base->size) {
+    limit *= 2;
+  }
+  return limit;
+}
+
+mz_SortedList *mz_sortedlist_new(size_t initial_capacity,
+                                 int (*mz_sortedlist_comparator_fn)(const void *, const void *)) {
+  mz_SortedList *list = NULL;
+  if (initial_capacity < 1) {
+    ERROR("invalid initial_capacity for sortedlist. initial_capacity must be greater than 1");
+  } else if (!mz_sortedlist_comparator_fn) {
+    ERROR("sortedlist needs a comparator");
+  } else if (!(list = calloc(1, sizeof(mz_SortedList)))) {
+    ERROR("could not allocate memory for sortedlist");
+  } else {
+    list->comparator_fn = mz_sortedlist_comparator_fn;
+    list->base = mz_arraylist_new(initial_capacity, sizeof(void *));
+    list->delta = mz_arraylist_new(MZ_SORTEDLIST_MIN_DELTA, sizeof(void *));
+    if (!list->base || !list->delta) {
+      ERROR("could not allocate memory for sortedlist");
+      mz_sortedlist_free(list);
+      list = NULL;
+    }
+  }
+  return list;
+}
+
+void mz_sortedlist_free(mz_SortedList *list) {
+  if (list) {
+    if (list->base) {
+      mz_arraylist_free(list->base);
+    }
+    if (list->delta) {
+      mz_arraylist_free(list->delta);
+    }
+    free(list);
+  }
+}
+
+bool mz_sortedlist_flush(mz_SortedList *list) {
+  bool result = false;
+  mz_ArrayList *base = list->base;
+  mz_ArrayList *delta = list->delta;
+  if (delta->size == 0) {
+    result = true;
+  } else if (!mz_arraylist_reserve(base, base->size + delta->size)) {
+    ERROR("could not reserve sortedlist capacity");
+  } else {
+    //merge from the back into the reserved room, so nothing is overwritten before it moved.
+    //on ties the delta value goes last, since it was inserted later
+    void **array = base->array;
+    size_t i = base->size;
+    size_t j = delta->size;
+    size_t k = base->size + delta->size;
+    while (j > 0) {
+      if (i > 0 && (*list->comparator_fn)(&delta->array[j - 1], &array[i - 1]) < 0) {
+        array[--k] = array[--i];
+      } else {
+        array[--k] = delta->array[--j];
+      }
+    }
+    base->size += delta->size;
+    delta->size = 0;
+    result = true;
+  }
+  return result;
+}
+
+bool mz_sortedlist_insert(mz_SortedList *list, void *value) {
+  bool result = false;
+  size_t index = _mz_sortedlist_bound(list->delta, value, true, list->comparator_fn);
+  //insert_at does not take the index one past the end
+  bool inserted = index == list->delta->size ? mz_arraylist_append(list->delta, value)
+                                             : mz_arraylist_insert_at(list->delta, index, value);
+  if (!inserted) {
+    ERROR("could not insert into sortedlist delta");
+  } else if (list->delta->size >= _mz_sortedlist_delta_limit(list)) {
+    result = mz_sortedlist_flush(list);
+  } else {
+    result = true;
+  }
+  return result;
+}
+
+bool mz_sortedlist_find(mz_SortedList *list, const void *key, void **value) {
+  mz_ArrayList *parts[] = {list->base, list->delta};
+  for (size_t p = 0; p < 2; p++) {
+    size_t index = _mz_sortedlist_bound(parts[p], key, false, list->comparator_fn);
+    if (index < parts[p]->size && (*list->comparator_fn)(&parts[p]->array[index], &key) == 0) {
+      if (value) {
+        *value = parts[p]->array[index];
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+bool mz_sortedlist_remove(mz_SortedList *list, const void *key, void **value) {
+  //equal values in the main array were inserted before those in the delta
+  mz_ArrayList *parts[] = {list->base, list->delta};
+  for (size_t p = 0; p < 2; p++) {
+    size_t index = _mz_sortedlist_bound(parts[p], key, false, list->comparator_fn);
+    if (index < parts[p]->size && (*list->comparator_fn)(&parts[p]->array[index], &key) == 0) {
+      if (value) {
+        *value = parts[p]->array[index];
+      }
+      return mz_arraylist_remove_at(parts[p], index);
+    }
+  }
+  return false;
+}
+
+mz_ArrayList *mz_sortedlist_values(mz_SortedList *list) {
+  return mz_sortedlist_flush(list) ? list->base : NULL;
+}
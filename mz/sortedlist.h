@@ -0,0 +1,48 @@
+#ifndef __mz_sortedlist__
+#define __mz_sortedlist__
+
+#include <stdlib.h>
+#include "type.h"
+#include "arraylist.h"
+
+//the delta is merged into the main array once it holds this many values, or the square root
+//of the main array's size if that is larger
+#define MZ_SORTEDLIST_MIN_DELTA 64
+
+//list kept in order under a stream of inserts. inserts go into a small sorted delta and are
+//merged into the main array in one backward pass once the delta is full, so every value of the
+//main array moves once per merge instead of once per insert. a delta of sqrt(n) values keeps
+//the amortized cost of an insert at O(sqrt(n)) moves of pointers instead of O(n)
+typedef struct mz_SortedList {
+  int (*comparator_fn)(const void *, const void *);
+  mz_ArrayList *base;
+  mz_ArrayList *delta;
+} mz_SortedList;
+
+//the comparator follows mz_arraylist_sort
+mz_SortedList *mz_sortedlist_new(size_t initial_capacity,
+                                 int (*mz_sortedlist_comparator_fn)(const void *, const void *));
+
+void mz_sortedlist_free(mz_SortedList *list);
+
+//equal values keep their insertion order
+bool mz_sortedlist_insert(mz_SortedList *list, void *value);
+
+//looks in both parts, value may be NULL
+bool mz_sortedlist_find(mz_SortedList *list, const void *key, void **value);
+
+//removes the first value equal to key, value may be NULL
+bool mz_sortedlist_remove(mz_SortedList *list, const void *key, void **value);
+
+//merges the delta into the main array
+bool mz_sortedlist_flush(mz_SortedList *list);
+
+//flushes and returns every value in order. the list stays owned by the sortedlist and is
+//only valid until the next insert or remove
+mz_ArrayList *mz_sortedlist_values(mz_SortedList *list);
+
+static inline size_t mz_sortedlist_size(mz_SortedList *list) {
+  return list->base->size + list->delta->size;
+}
+
+#endif
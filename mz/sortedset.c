@@ -0,0 +1,276 @@
+#include <stdlib.h>
+#include "sortedset.h"
+#include "losertree.h"
+#include "logger.h"
+#include "type.h"
+
+//first index at or after from whose element is not less than key, or, with upper, greater
+//than key. probes from + 1, 3, 7, ... and binary searches the last step, so finding a
+//position d elements ahead costs O(log d) comparisons
+size_t _mz_sortedset_gallop(void **array, size_t from, size_t size, void *key, bool upper,
+                            int (*mz_arraylist_comparator_fn)(const void *, const void *)) {
+  size_t low = from;
+  size_t step = 1;
+  size_t high = from;
+  //grow [low, high) until array[high] is past key
+  while (high < size) {
+    int comparison = (*mz_arraylist_comparator_fn)(&array[high], &key);
+    if (comparison > 0 || (!upper && comparison == 0)) {
+      break;
+    }
+    low = high + 1;
+    high = size - high > step ? high + step : size;
+    step *= 2;
+  }
+  while (low < high) {
+    size_t mid = low + (high - low) / 2;
+    int comparison = (*mz_arraylist_comparator_fn)(&array[mid], &key);
+    if (comparison > 0 || (!upper && comparison == 0)) {
+      high = mid;
+    } else {
+      low = mid + 1;
+    }
+  }
+  return low;
+}
+
+bool _mz_sortedset_is_lopsided(mz_ArrayList *a, mz_ArrayList *b) {
+  size_t small = a->size < b->size ? a->size : b->size;
+  size_t large = a->size < b->size ? b->size : a->size;
+  return large / MZ_SORTEDSET_GALLOP_RATIO > small;
+}
+
+mz_ArrayList *_mz_sortedset_new_result(mz_ArrayList *a, mz_ArrayList *b, size_t capacity) {
+  mz_ArrayList *result = NULL;
+  if (!a || !b) {
+    ERROR("list is null");
+  } else if (!(result = mz_arraylist_new(capacity > 0 ? capacity : 1, sizeof(void *)))) {
+    ERROR("could not allocate result list");
+  }
+  return result;
+}
+
+mz_ArrayList *mz_arraylist_union(mz_ArrayList *a, mz_ArrayList *b,
+                                 int (*mz_arraylist_comparator_fn)(const void *, const void *)) {
+  mz_ArrayList *result = _mz_sortedset_new_result(a, b, a && b ? a->size + b->size : 0);
+  if (!result) {
+    return NULL;
+  }
+  size_t i = 0;
+  size_t j = 0;
+  if (_mz_sortedset_is_lopsided(a, b) && a->size > b->size) {
+    //copy the run of a in front of every element of b in one go
+    for (; j < b->size; j++) {
+      size_t end = _mz_sortedset_gallop(a->array, i, a->size, b->array[j], false, (*mz_arraylist_comparator_fn));
+      mz_arraylist_append_range(result, a->array + i, end - i);
+      i = end;
+      if (i < a->size && (*mz_arraylist_comparator_fn)(&a->array[i], &b->array[j]) == 0) {
+        mz_arraylist_append(result, a->array[i++]);
+      } else {
+        mz_arraylist_append(result, b->array[j]);
+      }
+    }
+  } else if (_mz_sortedset_is_lopsided(a, b)) {
+    for (; i < a->size; i++) {
+      size_t end = _mz_sortedset_gallop(b->array, j, b->size, a->array[i], false, (*mz_arraylist_comparator_fn));
+      mz_arraylist_append_range(result, b->array + j, end - j);
+      j = end;
+      if (j < b->size && (*mz_arraylist_comparator_fn)(&a->array[i], &b->array[j]) == 0) {
+        j++;
+      }
+      mz_arraylist_append(result, a->array[i]);
+    }
+  } else {
+    while (i < a->size && j < b->size) {
+      int comparison = (*mz_arraylist_comparator_fn)(&a->array[i], &b->array[j]);
+      if (comparison < 0) {
+        mz_arraylist_append(result, a->array[i++]);
+      } else if (comparison > 0) {
+        mz_arraylist_append(result, b->array[j++]);
+      } else {
+        mz_arraylist_append(result, a->array[i++]);
+        j++;
+      }
+    }
+  }
+  mz_arraylist_append_range(result, a->array + i, a->size - i);
+  mz_arraylist_append_range(result, b->array + j, b->size - j);
+  return result;
+}
+
+mz_ArrayList *mz_arraylist_intersect(mz_ArrayList *a, mz_ArrayList *b,
+                                     int (*mz_arraylist_comparator_fn)(const void *, const void *)) {
+  mz_ArrayList *result = _mz_sortedset_new_result(a, b, a && b ? (a->size < b->size ? a->size : b->size) : 0);
+  if (!result) {
+    return NULL;
+  }
+  size_t i = 0;
+  size_t j = 0;
+  if (_mz_sortedset_is_lopsided(a, b) && a->size > b->size) {
+    for (; j < b->size && i < a->size; j++) {
+      i = _mz_sortedset_gallop(a->array, i, a->size, b->array[j], false, (*mz_arraylist_comparator_fn));
+      if (i < a->size && (*mz_arraylist_comparator_fn)(&a->array[i], &b->array[j]) == 0) {
+        mz_arraylist_append(result, a->array[i++]);
+      }
+    }
+  } else if (_mz_sortedset_is_lopsided(a, b)) {
+    for (; i < a->size && j < b->size; i++) {
+      j = _mz_sortedset_gallop(b->array, j, b->size, a->array[i], false, (*mz_arraylist_comparator_fn));
+      if (j < b->size && (*mz_arraylist_comparator_fn)(&a->array[i], &b->array[j]) == 0) {
+        mz_arraylist_append(result, a->array[i]);
+        j++;
+      }
+    }
+  } else {
+    while (i < a->size && j < b->size) {
+      int comparison = (*mz_arraylist_comparator_fn)(&a->array[i], &b->array[j]);
+      if (comparison < 0) {
+        i++;
+      } else if (comparison > 0) {
+        j++;
+      } else {
+        mz_arraylist_append(result, a->array[i++]);
+        j++;
+      }
+    }
+  }
+  return result;
+}
+
+mz_ArrayList *mz_arraylist_difference(mz_ArrayList *a, mz_ArrayList *b,
+                                      int (*mz_arraylist_comparator_fn)(const void *, const void *)) {
+  mz_ArrayList *result = _mz_sortedset_new_result(a, b, a ? a->size : 0);
+  if (!result) {
+    return NULL;
+  }
+  size_t i = 0;
+  size_t j = 0;
+  if (_mz_sortedset_is_lopsided(a, b) && a->size > b->size) {
+    //keep the run of a in front of every element of b, drop a match
+    for (; j < b->size && i < a->size; j++) {
+      size_t end = _mz_sortedset_gallop(a->array, i, a->size, b->array[j], false, (*mz_arraylist_comparator_fn));
+      mz_arraylist_append_range(result, a->array + i, end - i);
+      i = end;
+      if (i < a->size && (*mz_arraylist_comparator_fn)(&a->array[i], &b->array[j]) == 0) {
+        i++;
+      }
+    }
+  } else if (_mz_sortedset_is_lopsided(a, b)) {
+    for (; i < a->size && j < b->size; i++) {
+      j = _mz_sortedset_gallop(b->array, j, b->size, a->array[i], false, (*mz_arraylist_comparator_fn));
+      if (j < b->size && (*mz_arraylist_comparator_fn)(&a->array[i], &b->array[j]) == 0) {
+        j++;
+      } else {
+        mz_arraylist_append(result, a->array[i]);
+      }
+    }
+  } else {
+    while (i < a->size && j < b->size) {
+      int comparison = (*mz_arraylist_comparator_fn)(&a->array[i], &b->array[j]);
+      if (comparison < 0) {
+        mz_arraylist_append(result, a->array[i++]);
+      } else if (comparison > 0) {
+        j++;
+      } else {
+        i++;
+        j++;
+      }
+    }
+  }
+  mz_arraylist_append_range(result, a->array + i, a->size - i);
+  return result;
+}
+
+mz_ArrayList *mz_arraylist_merge(mz_ArrayList *a, mz_ArrayList *b,
+                                 int (*mz_arraylist_comparator_fn)(const void *, const void *)) {
+  mz_ArrayList *result = _mz_sortedset_new_result(a, b, a && b ? a->size + b->size : 0);
+  if (!result) {
+    return NULL;
+  }
+  size_t i = 0;
+  size_t j = 0;
+  if (_mz_sortedset_is_lopsided(a, b) && a->size > b->size) {
+    //elements of a equal to b[j] go first
+    for (; j < b->size; j++) {
+      size_t end = _mz_sortedset_gallop(a->array, i, a->size, b->array[j], true, (*mz_arraylist_comparator_fn));
+      mz_arraylist_append_range(result, a->array + i, end - i);
+      i = end;
+      mz_arraylist_append(result, b->array[j]);
+    }
+  } else if (_mz_sortedset_is_lopsided(a, b)) {
+    for (; i < a->size; i++) {
+      size_t end = _mz_sortedset_gallop(b->array, j, b->size, a->array[i], false, (*mz_arraylist_comparator_fn));
+      mz_arraylist_append_range(result, b->array + j, end - j);
+      j = end;
+      mz_arraylist_append(result, a->array[i]);
+    }
+  } else {
+    while (i < a->size && j < b->size) {
+      if ((*mz_arraylist_comparator_fn)(&b->array[j], &a->array[i]) < 0) {
+        mz_arraylist_append(result, b->array[j++]);
+      } else {
+        mz_arraylist_append(result, a->array[i++]);
+      }
+    }
+  }
+  mz_arraylist_append_range(result, a->array + i, a->size - i);
+  mz_arraylist_append_range(result, b->array + j, b->size - j);
+  return result;
+}
+
+mz_ArrayList *mz_arraylist_merge_many(mz_ArrayList **lists, size_t count,
+                                      int (*mz_arraylist_comparator_fn)(const void *, const void *)) {
+  if (count == 0) {
+    ERROR("no lists to merge");
+    return NULL;
+  }
+  size_t total = 0;
+  for (size_t i = 0; i < count; i++) {
+    total += lists[i]->size;
+  }
+  mz_ArrayList *result = mz_arraylist_new(total > 0 ? total : 1, sizeof(void *));
+  mz_LoserTree *tree = mz_losertree_new(count, (*mz_arraylist_comparator_fn));
+  size_t *positions = calloc(count, sizeof(size_t));
+  if (!result || !tree || !positions) {
+    ERROR("could not allocate memory for merge");
+    mz_arraylist_free(result);
+    result = NULL;
+  } else {
+    for (size_t i = 0; i < count; i++) {
+      if (lists[i]->size > 0) {
+        mz_losertree_set(tree, i, lists[i]->array[0]);
+      }
+    }
+    mz_losertree_build(tree);
+    //the result was sized for every element, so appends cannot fail
+    for (size_t source; (source = mz_losertree_winner(tree)) != MZ_NPOS;) {
+      result->array[result->size++] = mz_losertree_winner_key(tree);
+      if (++positions[source] < lists[source]->size) {
+        mz_losertree_replace_winner(tree, lists[source]->array[positions[source]]);
+      } else {
+        mz_losertree_exhaust_winner(tree);
+      }
+    }
+  }
+  free(positions);
+  mz_losertree_free(tree);
+  return result;
+}
+
+bool mz_arraylist_unique(mz_ArrayList *list, int (*mz_arraylist_comparator_fn)(const void *, const void *)) {
+  bool result = false;
+  if (!list) {
+    ERROR("list is null");
+  } else if (list->size == 0) {
+    result = true;
+  } else {
+    size_t kept = 1;
+    for (size_t i = 1; i < list->size; i++) {
+      if ((*mz_arraylist_comparator_fn)(&list->array[kept - 1], &list->array[i]) != 0) {
+        list->array[kept++] = list->array[i];
+      }
+    }
+    result = kept == list->size || mz_arraylist_truncate(list, kept);
+  }
+  return result;
+}
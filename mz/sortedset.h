@@ -0,0 +1,36 @@
+#ifndef __mz_sortedset__
+#define __mz_sortedset__
+
+#include <stdlib.h>
+#include "type.h"
+#include "arraylist.h"
+
+//once one list is this many times longer than the other, the shorter one is walked and
+//positions in the longer one are found by galloping (exponential search) instead of a linear scan
+#define MZ_SORTEDSET_GALLOP_RATIO 16
+
+//set algebra over lists sorted by the comparator, which follows mz_arraylist_sort.
+//duplicates are matched one to one, so with sets in and sets out. equal elements are
+//taken from a. every operation returns a new list
+mz_ArrayList *mz_arraylist_union(mz_ArrayList *a, mz_ArrayList *b,
+                                 int (*mz_arraylist_comparator_fn)(const void *, const void *));
+
+mz_ArrayList *mz_arraylist_intersect(mz_ArrayList *a, mz_ArrayList *b,
+                                     int (*mz_arraylist_comparator_fn)(const void *, const void *));
+
+//the elements of a that are not in b
+mz_ArrayList *mz_arraylist_difference(mz_ArrayList *a, mz_ArrayList *b,
+                                      int (*mz_arraylist_comparator_fn)(const void *, const void *));
+
+//every element of a and b in order, elements of a before equal elements of b
+mz_ArrayList *mz_arraylist_merge(mz_ArrayList *a, mz_ArrayList *b,
+                                 int (*mz_arraylist_comparator_fn)(const void *, const void *));
+
+//stable k-way merge through a loser tree
+mz_ArrayList *mz_arraylist_merge_many(mz_ArrayList **lists, size_t count,
+                                      int (*mz_arraylist_comparator_fn)(const void *, const void *));
+
+//removes all but the first of every run of equal elements, in place
+bool mz_arraylist_unique(mz_ArrayList *list, int (*mz_arraylist_comparator_fn)(const void *, const void *));
+
+#endif
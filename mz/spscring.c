@@ -0,0 +1,76 @@
+#include <stdlib.h>
+#include <string.h>
+#include "spscring.h"
+#include "logger.h"
+#include "type.h"
+
+mz_SpscRing *mz_spscring_new(size_t capacity) {
+  mz_SpscRing *ring = NULL;
+  if (capacity < 2) {
+    ERROR("invalid capacity for spscring. capacity must be at least 2");
+  } else if (posix_memalign((void **) &ring, MZ_CACHE_LINE_SIZE, sizeof(mz_SpscRing)) != 0) {
+    ERROR("could not allocate memory for spscring");
+    ring = NULL;
+  } else {
+    size_t rounded = 2;
+    while (rounded < capacity) {
+      rounded *= 2;
+    }
+    memset(ring, 0, sizeof(mz_SpscRing));
+    ring->capacity = rounded;
+    ring->mask = rounded - 1;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    ring->array = calloc(rounded, sizeof(void *));
+    if (!ring->array) {
+      ERROR("could not allocate memory for spscring->array");
+      free(ring);
+      ring = NULL;
+    }
+  }
+  return ring;
+}
+
+void mz_spscring_free(mz_SpscRing *ring) {
+  if (ring) {
+    free(ring->array);
+    free(ring);
+  }
+}
+
+size_t mz_spscring_push_bulk(mz_SpscRing *ring, void **elements, size_t len) {
+  size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+  size_t free_slots = ring->capacity - (tail - ring->cached_head);
+  if (free_slots < len) {
+    ring->cached_head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    free_slots = ring->capacity - (tail - ring->cached_head);
+  }
+  size_t count = len < free_slots ? len : free_slots;
+  if (count > 0) {
+    //copy in at most two runs: up to the end of the array, then from its start
+    size_t start = tail & ring->mask;
+    size_t first = ring->capacity - start < count ? ring->capacity - start : count;
+    memcpy(ring->array + start, elements, first * sizeof(void *));
+    memcpy(ring->array, elements + first, (count - first) * sizeof(void *));
+    atomic_store_explicit(&ring->tail, tail + count, memory_order_release);
+  }
+  return count;
+}
+
+size_t mz_spscring_pop_bulk(mz_SpscRing *ring, void **elements, size_t len) {
+  size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+  size_t available = ring->cached_tail - head;
+  if (available < len) {
+    ring->cached_tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    available = ring->cached_tail - head;
+  }
+  size_t count = len < available ? len : available;
+  if (count > 0) {
+    size_t start = head & ring->mask;
+    size_t first = ring->capacity - start < count ? ring->capacity - start : count;
+    memcpy(elements, ring->array + start, first * sizeof(void *));
+    memcpy(elements + first, ring->array, (count - first) * sizeof(void *));
+    atomic_store_explicit(&ring->head, head + count, memory_order_release);
+  }
+  return count;
+}
@@ -0,0 +1,71 @@
+#ifndef __mz_spscring__
+#define __mz_spscring__
+
+#include <stdlib.h>
+#include <stdatomic.h>
+#include "type.h"
+
+//bounded ring for exactly one producer thread and one consumer thread.
+//each side owns one index and keeps a cached copy of the other side's index,
+//so the shared line is only read again when the ring looks full or empty
+typedef struct mz_SpscRing {
+  size_t capacity;
+  size_t mask;
+  void **array;
+  _Alignas(MZ_CACHE_LINE_SIZE) atomic_size_t head;
+  size_t cached_tail;
+  _Alignas(MZ_CACHE_LINE_SIZE) atomic_size_t tail;
+  size_t cached_head;
+  char padding[MZ_CACHE_LINE_SIZE - sizeof(atomic_size_t) - sizeof(size_t)];
+} mz_SpscRing;
+
+//capacity is rounded up to a power of two
+mz_SpscRing *mz_spscring_new(size_t capacity);
+
+void mz_spscring_free(mz_SpscRing *ring);
+
+//producer only: pushes up to len elements and returns how many were pushed
+size_t mz_spscring_push_bulk(mz_SpscRing *ring, void **elements, size_t len);
+
+//consumer only: pops up to len elements into elements and returns how many were popped
+size_t mz_spscring_pop_bulk(mz_SpscRing *ring, void **elements, size_t len);
+
+//producer only: returns false if the ring is full
+static inline bool mz_spscring_push(mz_SpscRing *ring, void *value) {
+  size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+  if (tail - ring->cached_head == ring->capacity) {
+    ring->cached_head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    if (tail - ring->cached_head == ring->capacity) {
+      return false;
+    }
+  }
+  ring->array[tail & ring->mask] = value;
+  atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+  return true;
+}
+
+//consumer only: returns false if the ring is empty
+static inline bool mz_spscring_pop(mz_SpscRing *ring, void **value) {
+  size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+  if (head == ring->cached_tail) {
+    ring->cached_tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head == ring->cached_tail) {
+      return false;
+    }
+  }
+  *value = ring->array[head & ring->mask];
+  atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+  return true;
+}
+
+static inline size_t mz_spscring_capacity(mz_SpscRing *ring) {
+  return ring->capacity;
+}
+
+//only a snapshot while the other side is running
+static inline size_t mz_spscring_size(mz_SpscRing *ring) {
+  return atomic_load_explicit(&ring->tail, memory_order_acquire) -
+         atomic_load_explicit(&ring->head, memory_order_acquire);
+}
+
+#endif
@@ -0,0 +1,77 @@
+#include <stdlib.h>
+#include "topk.h"
+#include "logger.h"
+#include "type.h"
+
+mz_TopK *mz_topk_new(size_t k, int (*mz_topk_comparator_fn)(const void *, const void *)) {
+  mz_TopK *topk = NULL;
+  if (k < 1) {
+    ERROR("invalid k for topk. k must be at least 1");
+  } else {
+    topk = calloc(1, sizeof(mz_TopK));
+    if (!topk) {
+      ERROR("could not allocate memory for topk");
+    } else {
+      topk->k = k;
+      topk->heap = mz_priorityqueue_new(2, (*mz_topk_comparator_fn));
+      if (!topk->heap) {
+        ERROR("could not allocate topk->heap");
+        free(topk);
+        topk = NULL;
+      }
+    }
+  }
+  return topk;
+}
+
+void mz_topk_free(mz_TopK *topk) {
+  if (topk) {
+    mz_priorityqueue_free(topk->heap);
+    free(topk);
+  }
+}
+
+bool mz_topk_add(mz_TopK *topk, void *value) {
+  mz_PriorityQueue *heap = topk->heap;
+  if (heap->heap->size < topk->k) {
+    return mz_priorityqueue_push(heap, value) != NULL;
+  }
+  mz_PriorityQueueNode *smallest = heap->heap->array[0];
+  if ((*heap->comparator_fn)(&value, &smallest->value) > 0) {
+    //replace the smallest kept value in place, one sift-down instead of a pop and a push
+    mz_priorityqueue_update(heap, smallest, value);
+  }
+  return true;
+}
+
+bool mz_topk_add_range(mz_TopK *topk, void **values, size_t len) {
+  bool result = true;
+  for (size_t i = 0; result && i < len; i++) {
+    result = mz_topk_add(topk, values[i]);
+  }
+  return result;
+}
+
+bool mz_topk_threshold(mz_TopK *topk, void **value) {
+  return mz_priorityqueue_peek(topk->heap, value);
+}
+
+mz_ArrayList *mz_topk_result(mz_TopK *topk) {
+  size_t size = mz_topk_size(topk);
+  mz_ArrayList *result = mz_arraylist_new(size > 0 ? size : 1, sizeof(void *));
+  if (!result) {
+    ERROR("could not allocate result list");
+  } else {
+    for (size_t i = 0; i < size; i++) {
+      mz_arraylist_append(result, ((mz_PriorityQueueNode *) topk->heap->heap->array[i])->value);
+    }
+    //ascending, then reversed to put the greatest first
+    mz_arraylist_sort(result, mz_ArrayListSortOptionQuick, topk->heap->comparator_fn);
+    for (size_t i = 0; i < size / 2; i++) {
+      void *element = result->array[i];
+      result->array[i] = result->array[size - 1 - i];
+      result->array[size - 1 - i] = element;
+    }
+  }
+  return result;
+}
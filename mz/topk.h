@@ -0,0 +1,35 @@
+#ifndef __mz_topk__
+#define __mz_topk__
+
+#include <stdlib.h>
+#include "type.h"
+#include "arraylist.h"
+#include "priorityqueue.h"
+
+//streaming accumulator of the k greatest values seen so far. a min-heap of at most k
+//values keeps the smallest of them on top, so most values are rejected by one comparison
+typedef struct mz_TopK {
+  size_t k;
+  mz_PriorityQueue *heap;
+} mz_TopK;
+
+mz_TopK *mz_topk_new(size_t k, int (*mz_topk_comparator_fn)(const void *, const void *));
+
+void mz_topk_free(mz_TopK *topk);
+
+//returns false only if the value had to be kept and could not be
+bool mz_topk_add(mz_TopK *topk, void *value);
+
+bool mz_topk_add_range(mz_TopK *topk, void **values, size_t len);
+
+//the smallest value kept, i.e. the one a new value has to beat once k values are kept
+bool mz_topk_threshold(mz_TopK *topk, void **value);
+
+//the kept values, greatest first
+mz_ArrayList *mz_topk_result(mz_TopK *topk);
+
+static inline size_t mz_topk_size(mz_TopK *topk) {
+  return mz_priorityqueue_size(topk->heap);
+}
+
+#endif
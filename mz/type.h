@@ -13,5 +13,34 @@
 #define False 0
 #define false 0
 
+//used to keep data written by different threads on separate cache lines
+#ifndef MZ_CACHE_LINE_SIZE
+#define MZ_CACHE_LINE_SIZE 64
+#endif
+
+//what the default api does when a caller breaks a precondition, like an index out of range.
+//checked reports it through ERROR and fails, assert only checks it in builds without NDEBUG,
+//unchecked trusts the caller. the whole build has to use the same policy
+#define MZ_CHECK_POLICY_CHECKED 0
+#define MZ_CHECK_POLICY_ASSERT 1
+#define MZ_CHECK_POLICY_UNCHECKED 2
+
+#ifndef MZ_CHECK_POLICY
+#define MZ_CHECK_POLICY MZ_CHECK_POLICY_CHECKED
+#endif
+
+//the condition of a precondition check, always true unless the policy is checked
+#if MZ_CHECK_POLICY == MZ_CHECK_POLICY_CHECKED
+#define _MZ_CHECK(C) (C)
+#elif MZ_CHECK_POLICY == MZ_CHECK_POLICY_ASSERT
+#include <assert.h>
+#define _MZ_CHECK(C) (assert(C), 1)
+#else
+#define _MZ_CHECK(C) 1
+#endif
+
+//returned by searches (index_of, binary_search, ...) when no element matches
+#define MZ_NPOS ((size_t) -1)
+
 #endif
 
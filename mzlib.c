@@ -5,6 +5,26 @@
 #include "mz/logger.h"
 #include "test/linkedlist.c"
 #include "test/arraylist.c"
+#include "test/packedlist.c"
+#include "test/serialize.c"
+#include "test/mpmcqueue.c"
+#include "test/spscring.c"
+#include "test/segmentedlist.c"
+#include "test/rculist.c"
+#include "test/lockfreestack.c"
+#include "test/simd.c"
+#include "test/bitmap.c"
+#include "test/priorityqueue.c"
+#include "test/topk.c"
+#include "test/sortedset.c"
+#include "test/hashmap.c"
+#include "test/lrucache.c"
+#include "test/skiplist.c"
+#include "test/sortedlist.c"
+#include "test/externalsort.c"
+#include "test/compressedlist.c"
+#include "test/columnlist.c"
+#include "test/asynclog.c"
 
 char *(*testSuite)(void);
 
@@ -25,7 +45,27 @@ int main(int argc, char *argv[]) {
 
   int r1 = test_runner("linkedlist", &mz_linkedlist_tests);
   int r2 = test_runner("arraylist", &mz_arraylist_tests);
+  int r3 = test_runner("packedlist", &mz_packedlist_tests);
+  int r4 = test_runner("serialize", &mz_serialize_tests);
+  int r5 = test_runner("mpmcqueue", &mz_mpmcqueue_tests);
+  int r6 = test_runner("spscring", &mz_spscring_tests);
+  int r7 = test_runner("segmentedlist", &mz_segmentedlist_tests);
+  int r8 = test_runner("rculist", &mz_rculist_tests);
+  int r9 = test_runner("lockfreestack", &mz_lockfreestack_tests);
+  int r10 = test_runner("simd", &mz_simd_tests);
+  int r11 = test_runner("bitmap", &mz_bitmap_tests);
+  int r12 = test_runner("priorityqueue", &mz_priorityqueue_tests);
+  int r13 = test_runner("topk", &mz_topk_tests);
+  int r14 = test_runner("sortedset", &mz_sortedset_tests);
+  int r15 = test_runner("hashmap", &mz_hashmap_tests);
+  int r16 = test_runner("lrucache", &mz_lrucache_tests);
+  int r17 = test_runner("skiplist", &mz_skiplist_tests);
+  int r18 = test_runner("sortedlist", &mz_sortedlist_tests);
+  int r19 = test_runner("externalsort", &mz_externalsort_tests);
+  int r20 = test_runner("compressedlist", &mz_compressedlist_tests);
+  int r21 = test_runner("columnlist", &mz_columnlist_tests);
+  int r22 = test_runner("asynclog", &mz_asynclog_tests);
   printf("TESTS RUN = %d\n", tests_run);
 
-  return r1 == r2 == 1;
+  return r1 || r2 || r3 || r4 || r5 || r6 || r7 || r8 || r9 || r10 || r11 || r12 || r13 || r14 || r15 || r16 || r17 || r18 || r19 || r20 || r21 || r22;
 }
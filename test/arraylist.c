@@ -20,6 +20,77 @@ static char *it_creates_and_initializes_an_arraylist() {
   return 0;
 }
 
+static char *it_initializes_a_stack_allocated_arraylist() {
+  const long ELEMENT_SIZE = sizeof(void *);
+  const size_t INITIAL_CAPACITY = 2;
+  mz_ArrayList list;
+  bool result = mz_arraylist_init(&list, INITIAL_CAPACITY, ELEMENT_SIZE);
+  char *first = "first";
+  mz_arraylist_append(&list, first);
+  mu_assert("error - result != true", result == true);
+  mu_assert("error - capacity != INITIAL_CAPACITY", list.capacity == INITIAL_CAPACITY);
+  mu_assert("error - size != 1", list.size == 1);
+  mu_assert("error - list is not inline", mz_arraylist_is_inline(&list));
+  mu_assert("error - element at index 0 != expected", mz_arraylist_get(&list, 0) == first);
+  mz_arraylist_destroy(&list);
+  return 0;
+}
+
+static char *it_spills_inline_array_to_heap_and_back() {
+  const long ELEMENT_SIZE = sizeof(void *);
+  const size_t INITIAL_CAPACITY = 2;
+  mz_ArrayList *list = mz_arraylist_new(INITIAL_CAPACITY, ELEMENT_SIZE);
+  for (int i = 0; i < MZ_ARRAYLIST_INLINE_CAPACITY; i++) {
+    mz_arraylist_append(list, (void *) (intptr_t) i);
+  }
+  mu_assert("error - list is not inline", mz_arraylist_is_inline(list));
+  mz_arraylist_append(list, (void *) (intptr_t) MZ_ARRAYLIST_INLINE_CAPACITY);
+  mu_assert("error - list is inline", !mz_arraylist_is_inline(list));
+  mu_assert("error - capacity <= MZ_ARRAYLIST_INLINE_CAPACITY", list->capacity > MZ_ARRAYLIST_INLINE_CAPACITY);
+  for (int i = 0; i <= MZ_ARRAYLIST_INLINE_CAPACITY; i++) {
+    mu_assert("error - element != expected", mz_arraylist_get(list, i) == (void *) (intptr_t) i);
+  }
+  mz_arraylist_remove_range(list, 1, MZ_ARRAYLIST_INLINE_CAPACITY);
+  mu_assert("error - list is not inline after shrinking", mz_arraylist_is_inline(list));
+  mu_assert("error - size != 2", list->size == 2);
+  mu_assert("error - element at index 0 != 0", mz_arraylist_get(list, 0) == (void *) (intptr_t) 0);
+  mu_assert("error - element at index 1 != last", mz_arraylist_get(list, 1) == (void *) (intptr_t) MZ_ARRAYLIST_INLINE_CAPACITY);
+  mz_arraylist_free(list);
+  return 0;
+}
+
+static char *it_keeps_reserved_capacity_when_appending() {
+  mz_ArrayList *list = mz_arraylist_new(2, sizeof(void *));
+  mu_assert("error - reserve failed", mz_arraylist_reserve(list, 100));
+  size_t capacity = list->capacity;
+  void **array = list->array;
+  for (int i = 0; i < 100; i++) {
+    mz_arraylist_append(list, (void *) (intptr_t) i);
+  }
+  mu_assert("error - capacity changed", list->capacity == capacity);
+  mu_assert("error - array was reallocated", list->array == array);
+  mz_arraylist_free(list);
+  return 0;
+}
+
+static char *it_moves_an_inline_arraylist() {
+  const long ELEMENT_SIZE = sizeof(void *);
+  const size_t INITIAL_CAPACITY = 2;
+  mz_ArrayList source;
+  mz_ArrayList destination;
+  mz_arraylist_init(&source, INITIAL_CAPACITY, ELEMENT_SIZE);
+  char *first = "first";
+  mz_arraylist_append(&source, first);
+  mz_arraylist_move(&destination, &source);
+  mu_assert("error - destination is not inline", mz_arraylist_is_inline(&destination));
+  mu_assert("error - destination size != 1", destination.size == 1);
+  mu_assert("error - source size != 0", source.size == 0);
+  mu_assert("error - element at index 0 != expected", mz_arraylist_get(&destination, 0) == first);
+  mz_arraylist_destroy(&source);
+  mz_arraylist_destroy(&destination);
+  return 0;
+}
+
 static char *it_appends_item_to_arraylist() {
   const long ELEMENT_SIZE = sizeof(void *);
   const size_t INITIAL_CAPACITY = 2;
@@ -116,7 +187,7 @@ static char *it_inserts_item_at_index_minus_one_of_empty_array() {
   const size_t INITIAL_CAPACITY = 2;
   mz_ArrayList *list = mz_arraylist_new(INITIAL_CAPACITY, ELEMENT_SIZE);
   char *first = "first";
-  mz_arraylist_insert_at(list, -1, first);
+  mz_arraylist_insert_at_relative(list, -1, first);
   mu_assert("error - capacity != 2", list->capacity == 2);
   mu_assert("error - size != 1", list->size == 1);
   mu_assert("error - element_size != element_size", list->element_size == ELEMENT_SIZE);
@@ -136,7 +207,7 @@ static char *it_inserts_item_with_negative_index_for_non_empty_array() {
   mz_arraylist_append(list, second);
   mz_arraylist_append(list, third);
   char *item_to_insert = "item to insert";
-  mz_arraylist_insert_at(list, -2, item_to_insert);
+  mz_arraylist_insert_at_relative(list, -2, item_to_insert);
   mu_assert("error - capacity != 4", list->capacity == 2 * INITIAL_CAPACITY);
   mu_assert("error - size != 4", list->size == 4);
   mu_assert("error - element_size != element_size", list->element_size == ELEMENT_SIZE);
@@ -177,7 +248,7 @@ static char *it_fails_to_insert_at_negative_index_out_of_range() {
   mz_arraylist_append(list, first);
   mz_arraylist_append(list, second);
   char *item_to_insert = "item to insert";
-  bool result = mz_arraylist_insert_at(list, -3, item_to_insert);
+  bool result = mz_arraylist_insert_at_relative(list, -3, item_to_insert);
   mu_assert("error - result != false", result == false);
   mu_assert("error - capacity != 2", list->capacity == INITIAL_CAPACITY);
   mu_assert("error - size != 2", list->size == 2);
@@ -245,7 +316,7 @@ static char *it_removes_last_item_with_negative_index_of_non_empty_list() {
   mz_arraylist_append(list, first);
   mz_arraylist_append(list, second);
   mz_arraylist_append(list, third);
-  bool result = mz_arraylist_remove_at(list, -1);
+  bool result = mz_arraylist_remove_at_relative(list, -1);
   mu_assert("error - result != true", result == true);
   mu_assert("error - capacity != 4", list->capacity == 2 * INITIAL_CAPACITY);
   mu_assert("error - size != 2", list->size == 2);
@@ -290,7 +361,7 @@ static char *it_fails_to_remove_item_at_negative_index_out_of_range_for_non_empt
   mz_arraylist_append(list, first);
   mz_arraylist_append(list, second);
   mz_arraylist_append(list, third);
-  bool result = mz_arraylist_remove_at(list, -4);
+  bool result = mz_arraylist_remove_at_relative(list, -4);
   mu_assert("error - result != false", result == false);
   mu_assert("error - capacity != 4", list->capacity == 2 * INITIAL_CAPACITY);
   mu_assert("error - size != 3", list->size == 3);
@@ -342,7 +413,7 @@ static char *it_removes_a_subarray_with_negative_numbered_range_in_array() {
   for (int i = 0; i < 10; i++) {
     mz_arraylist_append(list, (void *) (intptr_t) i);
   }
-  bool result = mz_arraylist_remove_range(list, -6, -2);
+  bool result = mz_arraylist_remove_range_relative(list, -6, -2);
   char *actual = calloc(11, sizeof(char));
   char *expected = "0123890000\0";
   for (int i = 0; i < 10; i++) {
@@ -387,7 +458,7 @@ static char *it_set_an_item_with_negative_index() {
   char *item_to_set = "set item";
   mz_arraylist_append(list, first);
   mz_arraylist_append(list, second);
-  bool result = mz_arraylist_set(list, -1, item_to_set);
+  bool result = mz_arraylist_set_relative(list, -1, item_to_set);
   mu_assert("error - result != true", result == true);
   mu_assert("error - capacity != 2", list->capacity == INITIAL_CAPACITY);
   mu_assert("error - size != 2", list->size == 2);
@@ -407,7 +478,7 @@ static char *it_gets_an_item_with_negative_index() {
   char *expected = second;
   mz_arraylist_append(list, first);
   mz_arraylist_append(list, second);
-  char *actual = mz_arraylist_get(list, -1);
+  char *actual = mz_arraylist_get_relative(list, -1);
   mu_assert("error - actual != expected", actual == expected);
   mu_assert("error - capacity != 2", list->capacity == INITIAL_CAPACITY);
   mu_assert("error - size != 2", list->size == 2);
@@ -418,6 +489,22 @@ static char *it_gets_an_item_with_negative_index() {
   return 0;
 }
 
+static char *it_fails_to_get_an_item_with_index_out_of_range() {
+  const long ELEMENT_SIZE = sizeof(void *);
+  const size_t INITIAL_CAPACITY = 2;
+  mz_ArrayList *list = mz_arraylist_new(INITIAL_CAPACITY, ELEMENT_SIZE);
+  char *first = "first";
+  char *second = "second";
+  mz_arraylist_append(list, first);
+  mz_arraylist_append(list, second);
+  mu_assert("error - get(2) != NULL", mz_arraylist_get(list, 2) == NULL);
+  mu_assert("error - get(MZ_NPOS) != NULL", mz_arraylist_get(list, MZ_NPOS) == NULL);
+  mu_assert("error - get_relative(-3) != NULL", mz_arraylist_get_relative(list, -3) == NULL);
+  mu_assert("error - get_relative(-2) != first", mz_arraylist_get_relative(list, -2) == first);
+  mz_arraylist_free(list);
+  return 0;
+}
+
 static char *it_gets_range_from_array() {
   const long ELEMENT_SIZE = sizeof(void *);
   const size_t INITIAL_CAPACITY = 2;
@@ -513,8 +600,8 @@ static char *it_enumerates_through_list_using_macro_definition() {
 }
 
 void *map_fn(const void *element) {
-  size_t size = 3;
-  char *result = (char *) calloc(size, sizeof(void *));
+  size_t size = 4;
+  char *result = (char *) calloc(size, sizeof(char));
   return memcpy(result, element, 3);
 }
 
@@ -529,9 +616,13 @@ static char *it_maps_arraylist_to_fn() {
   mz_arraylist_append(list, second);
   mz_arraylist_append(list, third);
   mz_ArrayList *result = mz_arraylist_map(list, *map_fn);
+  mu_assert("error - result size != 3", result->size == 3);
   mzm_arraylist_foreach(result, element, index) {
     mu_assert("error - result element length != 3", strlen(element) == 3);
   }
+  mzm_arraylist_foreach(result, mapped, i) {
+    free(mapped);
+  }
   mz_arraylist_free(result);
   mz_arraylist_free(list);
   return 0;
@@ -581,6 +672,20 @@ static char *it_finds_the_first_index_of_element() {
   return 0;
 }
 
+static char *it_returns_npos_when_no_index_matches() {
+  const long ELEMENT_SIZE = sizeof(void *);
+  const size_t INITIAL_CAPACITY = 2;
+  mz_ArrayList *list = mz_arraylist_new(INITIAL_CAPACITY, ELEMENT_SIZE);
+  char *first = "one";
+  char *second = "three";
+  mz_arraylist_append(list, first);
+  mz_arraylist_append(list, second);
+  size_t result = mz_arraylist_index_of(list, *index_of_fn);
+  mu_assert("error - result index != MZ_NPOS", result == MZ_NPOS);
+  mz_arraylist_free(list);
+  return 0;
+}
+
 void *arraylist_reduce_fn(const void *a, const void *b) {
   return (void *) ((long) a + (long) b);
 };
@@ -641,6 +746,26 @@ static char *it_finds_item_in_sorted_array_using_binary_search() {
   return 0;
 }
 
+static char *it_returns_npos_when_binary_search_does_not_find_item() {
+  const long ELEMENT_SIZE = sizeof(void *);
+  const size_t INITIAL_CAPACITY = 100;
+  mz_ArrayList *list = mz_arraylist_new(INITIAL_CAPACITY, ELEMENT_SIZE);
+  for (int i = 0; i < 1000; i++) {
+    void *item = (void *) (long) (2 * i);
+    mz_arraylist_append(list, item);
+  }
+  mu_assert("error - index of 857 != MZ_NPOS",
+            mz_arraylist_binary_search(list, (void *) (long) 857, arraylist_comparator_fn) == MZ_NPOS);
+  mu_assert("error - index of -1 != MZ_NPOS",
+            mz_arraylist_binary_search(list, (void *) (long) -1, arraylist_comparator_fn) == MZ_NPOS);
+  mu_assert("error - index of 2000 != MZ_NPOS",
+            mz_arraylist_binary_search(list, (void *) (long) 2000, arraylist_comparator_fn) == MZ_NPOS);
+  mu_assert("error - index of 1998 != 999",
+            mz_arraylist_binary_search(list, (void *) (long) 1998, arraylist_comparator_fn) == 999);
+  mz_arraylist_free(list);
+  return 0;
+}
+
 static char *it_sorts_using_mergesort() {
   const long ELEMENT_SIZE = sizeof(void *);
   const size_t INITIAL_CAPACITY = 100;
@@ -710,8 +835,138 @@ static char *it_sorts_using_quicksort() {
   return 0;
 }
 
+static char *it_slices_list_without_copying() {
+  const long ELEMENT_SIZE = sizeof(void *);
+  const size_t INITIAL_CAPACITY = 2;
+  mz_ArrayList *list = mz_arraylist_new(INITIAL_CAPACITY, ELEMENT_SIZE);
+  for (int i = 0; i < 10; i++) {
+    mz_arraylist_append(list, (void *) (intptr_t) i);
+  }
+  mz_ArraySlice slice = mz_arraylist_slice(list, 2, 10);
+  mu_assert("error - slice size != 8", slice.size == 8);
+  mu_assert("error - slice is not borrowed from list", slice.array == list->array + 2);
+  mzm_arrayslice_foreach(slice, element, index) {
+    mu_assert("error - slice element != expected", element == (void *) (intptr_t) (index + 2));
+  }
+  mz_ArraySlice window = mz_arrayslice_sub(slice, 6, 100);
+  mu_assert("error - window size != 2", window.size == 2);
+  mu_assert("error - window[0] != 8", window.array[0] == (void *) (intptr_t) 8);
+  mz_ArraySlice invalid = mz_arraylist_slice(list, 5, 11);
+  mu_assert("error - invalid slice is not empty", invalid.array == NULL && invalid.size == 0);
+  mz_arraylist_free(list);
+  return 0;
+}
+
+bool slice_filter_fn(const void *element) {
+  return (intptr_t) element % 2 == 0;
+}
+
+static char *it_runs_functional_operations_on_a_slice() {
+  const long ELEMENT_SIZE = sizeof(void *);
+  const size_t INITIAL_CAPACITY = 2;
+  mz_ArrayList *list = mz_arraylist_new(INITIAL_CAPACITY, ELEMENT_SIZE);
+  for (int i = 0; i < 10; i++) {
+    mz_arraylist_append(list, (void *) (intptr_t) (9 - i));
+  }
+  //slice holds 6 5 4 3
+  mz_ArraySlice slice = mz_arraylist_slice(list, 3, 7);
+  mz_ArrayList *filtered = mz_arrayslice_filter(slice, slice_filter_fn);
+  mu_assert("error - filtered size != 2", filtered->size == 2);
+  mu_assert("error - filtered[0] != 6", filtered->array[0] == (void *) (intptr_t) 6);
+  int sum = (int) (long) mz_arrayslice_reduce(slice, arraylist_reduce_fn);
+  mu_assert("error - slice sum != 18", sum == 18);
+  mu_assert("error - sort failed", mz_arrayslice_sort(slice, mz_ArrayListSortOptionQuick, arraylist_comparator_fn));
+  mu_assert("error - list[3] != 3", list->array[3] == (void *) (intptr_t) 3);
+  mu_assert("error - list[6] != 6", list->array[6] == (void *) (intptr_t) 6);
+  mu_assert("error - list[7] != 2", list->array[7] == (void *) (intptr_t) 2);
+  mu_assert("error - index of 5 != 2",
+            mz_arrayslice_binary_search(slice, (void *) (intptr_t) 5, arraylist_comparator_fn) == 2);
+  mu_assert("error - index of first even != 1", mz_arrayslice_index_of(slice, slice_filter_fn) == 1);
+  mz_arraylist_free(filtered);
+  mz_arraylist_free(list);
+  return 0;
+}
+
+static char *it_selects_nth_element_without_sorting() {
+  mz_ArrayList *list = mz_arraylist_new(MZ_ARRAYLIST_INLINE_CAPACITY, sizeof(void *));
+  mz_ArrayList *sorted = mz_arraylist_new(MZ_ARRAYLIST_INLINE_CAPACITY, sizeof(void *));
+  for (int i = 0; i < 10000; i++) {
+    void *item = (void *) (long) (rand() % 1000);
+    mz_arraylist_append(list, item);
+    mz_arraylist_append(sorted, item);
+  }
+  mz_arraylist_sort(sorted, mz_ArrayListSortOptionQuick, arraylist_comparator_fn);
+  size_t positions[] = {0, 17, 5000, 9999};
+  for (size_t p = 0; p < sizeof(positions) / sizeof(positions[0]); p++) {
+    size_t n = positions[p];
+    mu_assert("error - nth_element failed", mz_arraylist_nth_element(list, n, arraylist_comparator_fn));
+    int nth = (int) (long) list->array[n];
+    mu_assert("error - nth element != sorted nth element", nth == (int) (long) sorted->array[n]);
+    for (size_t i = 0; i < list->size; i++) {
+      int current = (int) (long) list->array[i];
+      mu_assert("error - list is not partitioned around nth element", i < n ? current <= nth : current >= nth);
+    }
+  }
+  mu_assert("error - nth_element out of range succeeded",
+            !mz_arraylist_nth_element(list, 10000, arraylist_comparator_fn));
+  mz_arraylist_free(sorted);
+  mz_arraylist_free(list);
+  return 0;
+}
+
+static char *it_partially_sorts_the_smallest_elements() {
+  mz_ArrayList *list = mz_arraylist_new(MZ_ARRAYLIST_INLINE_CAPACITY, sizeof(void *));
+  for (int i = 0; i < 5000; i++) {
+    mz_arraylist_append(list, (void *) (long) ((i * 7919) % 5000));
+  }
+  mu_assert("error - partial sort failed", mz_arraylist_partial_sort(list, 100, arraylist_comparator_fn));
+  for (int i = 0; i < 100; i++) {
+    mu_assert("error - front is not the sorted smallest elements", (int) (long) list->array[i] == i);
+  }
+  mu_assert("error - partial sort of whole list failed",
+            mz_arraylist_partial_sort(list, 6000, arraylist_comparator_fn));
+  mu_assert("error - last element != 4999", (int) (long) list->array[4999] == 4999);
+  mz_arraylist_free(list);
+  return 0;
+}
+
+static char *it_gets_sets_and_appends_unchecked() {
+  mz_ArrayList *list = mz_arraylist_new(MZ_ARRAYLIST_INLINE_CAPACITY, sizeof(void *));
+  mu_assert("error - reserve failed", mz_arraylist_reserve(list, 1000));
+  for (long i = 0; i < 1000; i++) {
+    mz_arraylist_append_unchecked(list, (void *) i);
+  }
+  mu_assert("error - size != 1000", mz_arraylist_size(list) == 1000);
+  for (size_t i = 0; i < 1000; i++) {
+    mz_arraylist_set_unchecked(list, i, (void *) ((long) mz_arraylist_get_unchecked(list, i) * 2));
+  }
+  for (size_t i = 0; i < 1000; i++) {
+    mu_assert("error - unchecked value differs", mz_arraylist_get(list, i) == (void *) (long) (i * 2));
+  }
+  mz_arraylist_free(list);
+  return 0;
+}
+
+static char *it_truncates_a_list() {
+  mz_ArrayList *list = mz_arraylist_new(MZ_ARRAYLIST_INLINE_CAPACITY, sizeof(void *));
+  for (long i = 0; i < 100; i++) {
+    mz_arraylist_append(list, (void *) i);
+  }
+  mu_assert("error - truncate past the size succeeded", !mz_arraylist_truncate(list, 101));
+  mu_assert("error - truncate failed", mz_arraylist_truncate(list, 3));
+  mu_assert("error - size != 3", mz_arraylist_size(list) == 3 && list->array[2] == (void *) 2);
+  mu_assert("error - capacity did not shrink back inline", mz_arraylist_is_inline(list));
+  mu_assert("error - truncate to 0 failed", mz_arraylist_truncate(list, 0) && mz_arraylist_is_empty(list));
+  mz_arraylist_free(list);
+  return 0;
+}
+
 static char *mz_arraylist_tests() {
   mu_run_test(it_creates_and_initializes_an_arraylist);
+  mu_run_test(it_initializes_a_stack_allocated_arraylist);
+  mu_run_test(it_spills_inline_array_to_heap_and_back);
+  mu_run_test(it_moves_an_inline_arraylist);
+  mu_run_test(it_keeps_reserved_capacity_when_appending);
   mu_run_test(it_appends_item_to_arraylist);
   mu_run_test(it_doubles_capacity_when_appending_items_over_initial_capacity);
   mu_run_test(it_appends_range_of_items_to_list);
@@ -732,6 +987,7 @@ static char *mz_arraylist_tests() {
   mu_run_test(it_set_an_item_at_index);
   mu_run_test(it_set_an_item_with_negative_index);
   mu_run_test(it_gets_an_item_with_negative_index);
+  mu_run_test(it_fails_to_get_an_item_with_index_out_of_range);
   mu_run_test(it_gets_range_from_array);
   mu_run_test(it_gets_list_properties);
   mu_run_test(it_inserts_first_item);
@@ -740,12 +996,20 @@ static char *mz_arraylist_tests() {
   mu_run_test(it_maps_arraylist_to_fn);
   mu_run_test(it_filters_arraylist_based_on_filter_fn);
   mu_run_test(it_finds_the_first_index_of_element);
+  mu_run_test(it_returns_npos_when_no_index_matches);
   mu_run_test(it_reduces_list);
   mu_run_test(it_returns_null_when_reducing_a_null_list);
   mu_run_test(it_returns_value_when_reducing_a_single_item_list);
   mu_run_test(it_finds_item_in_sorted_array_using_binary_search);
+  mu_run_test(it_returns_npos_when_binary_search_does_not_find_item);
   mu_run_test(it_sorts_using_mergesort);
   mu_run_test(it_sorts_using_quicksort);
   mu_run_test(it_sorts_using_heapsort);
+  mu_run_test(it_slices_list_without_copying);
+  mu_run_test(it_runs_functional_operations_on_a_slice);
+  mu_run_test(it_selects_nth_element_without_sorting);
+  mu_run_test(it_partially_sorts_the_smallest_elements);
+  mu_run_test(it_gets_sets_and_appends_unchecked);
+  mu_run_test(it_truncates_a_list);
   return 0;
 }
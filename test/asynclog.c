@@ -0,0 +1,163 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "../lib/minunit.h"
+#include "../mz/asynclog.h"
+#include "../mz/logger.h"
+
+#define ASYNCLOG_TEST_THREADS 4
+#define ASYNCLOG_TEST_RECORDS 2000
+
+int asynclog_temp_file() {
+  char path[] = "/tmp/mz_asynclog_XXXXXX";
+  int fd = mkstemp(path);
+  unlink(path);
+  return fd;
+}
+
+//everything written to fd, as a string the caller frees
+char *asynclog_read_all(int fd) {
+  off_t len = lseek(fd, 0, SEEK_END);
+  char *text = malloc(len + 1);
+  pread(fd, text, len, 0);
+  text[len] = '\0';
+  return text;
+}
+
+size_t asynclog_count(const char *text, const char *needle) {
+  size_t count = 0;
+  for (const char *p = strstr(text, needle); p; p = strstr(p + 1, needle)) {
+    count++;
+  }
+  return count;
+}
+
+void *asynclog_test_producer(void *arg) {
+  uintptr_t thread = (uintptr_t) arg;
+  for (int i = 0; i < ASYNCLOG_TEST_RECORDS; i++) {
+    mz_asynclog_log(mz_AsyncLogLevelInfo, "producer.c", 1, 0, "thread %u record %d", (unsigned) thread, i);
+  }
+  return NULL;
+}
+
+static char *it_formats_captured_arguments_like_printf() {
+  int fd = asynclog_temp_file();
+  mz_AsyncLogOptions options = {fd, mz_AsyncLogPolicyBlock, 0, 100};
+  mu_assert("error - start failed", mz_asynclog_start(&options));
+  char name[] = "temporary";
+  mz_asynclog_log(mz_AsyncLogLevelError, "a.c", 12, ENOENT, "%d|%5.2f|%-12s|%#x|%zu|%c|%%", -42, 3.14159, name, 255u,
+                  (size_t) 7, 'z');
+  mz_asynclog_log(mz_AsyncLogLevelWarn, "a.c", 13, 0, "%*d|%.*s|%lld|%hhd|%p", 6, 9, 3, "abcdef", -1234567890123ll, 300,
+                  (void *) name);
+  //the string was copied, so the caller can reuse it right away
+  strcpy(name, "changed");
+  mz_asynclog_log(mz_AsyncLogLevelInfo, "b.c", 3, 0, "%d %d %d %d %d %d %d %d %d %d", 1, 2, 3, 4, 5, 6, 7, 8, 9, 10);
+  mz_asynclog_log(mz_AsyncLogLevelDebug, "c.c", 4, 0, "no arguments");
+  mz_asynclog_flush();
+  mz_asynclog_stop();
+  char expected[1024];
+  int len = snprintf(expected, sizeof(expected),
+                     "[ERROR] (a.c:12: errno: %s) %d|%5.2f|%-12s|%#x|%zu|%c|%%\n"
+                     "[WARN] (a.c:13: errno: None) %*d|%.*s|%lld|%hhd|%p\n",
+                     strerror(ENOENT), -42, 3.14159, "temporary", 255u, (size_t) 7, 'z',
+                     6, 9, 3, "abcdef", -1234567890123ll, (signed char) 300, (void *) name);
+  //arguments past MZ_ASYNCLOG_MAX_ARGS leave the rest of the format as it is
+  snprintf(expected + len, sizeof(expected) - len, "[INFO] (b.c:3:) 1 2 3 4 5 6 7 8 %%d %%d\n[DEBUG] c.c:4: no arguments\n");
+  char *text = asynclog_read_all(fd);
+  mu_assert("error - output does not match printf", strcmp(text, expected) == 0);
+  free(text);
+  close(fd);
+  return 0;
+}
+
+static char *it_writes_the_records_of_every_thread_in_order() {
+  int fd = asynclog_temp_file();
+  mz_AsyncLogOptions options = {fd, mz_AsyncLogPolicyBlock, 0, 100};
+  mz_asynclog_start(&options);
+  pthread_t threads[ASYNCLOG_TEST_THREADS];
+  for (uintptr_t t = 0; t < ASYNCLOG_TEST_THREADS; t++) {
+    pthread_create(&threads[t], NULL, asynclog_test_producer, (void *) t);
+  }
+  for (size_t t = 0; t < ASYNCLOG_TEST_THREADS; t++) {
+    pthread_join(threads[t], NULL);
+  }
+  mz_asynclog_flush();
+  mu_assert("error - blocking policy dropped records", mz_asynclog_dropped() == 0);
+  mz_asynclog_stop();
+  char *text = asynclog_read_all(fd);
+  mu_assert("error - lines were lost", asynclog_count(text, "\n") == ASYNCLOG_TEST_THREADS * ASYNCLOG_TEST_RECORDS);
+  int next[ASYNCLOG_TEST_THREADS] = {0};
+  for (char *line = strtok(text, "\n"); line; line = strtok(NULL, "\n")) {
+    unsigned thread = 0;
+    int record = 0;
+    mu_assert("error - line is malformed", sscanf(line, "[INFO] (producer.c:1:) thread %u record %d", &thread, &record) == 2);
+    mu_assert("error - records of a thread are out of order", thread < ASYNCLOG_TEST_THREADS && record == next[thread]++);
+  }
+  free(text);
+  close(fd);
+  return 0;
+}
+
+static char *it_drops_records_when_the_ring_is_full() {
+  int fd = asynclog_temp_file();
+  //the writer sleeps long enough for the ring to fill up
+  mz_AsyncLogOptions options = {fd, mz_AsyncLogPolicyDrop, 0, 200000};
+  mz_asynclog_start(&options);
+  size_t records = MZ_ASYNCLOG_RING_SIZE * 10;
+  for (size_t i = 0; i < records; i++) {
+    mz_asynclog_log(mz_AsyncLogLevelWarn, "full.c", 1, 0, "record %zu", i);
+  }
+  size_t dropped = mz_asynclog_dropped();
+  mz_asynclog_stop();
+  mu_assert("error - nothing was dropped", dropped > 0);
+  char *text = asynclog_read_all(fd);
+  mu_assert("error - written and dropped do not add up", asynclog_count(text, "record ") + dropped == records);
+  mu_assert("error - drops were not reported", asynclog_count(text, "of a full ring") > 0);
+  free(text);
+  close(fd);
+  return 0;
+}
+
+static char *it_drops_records_over_the_rate_limit() {
+  int fd = asynclog_temp_file();
+  mz_AsyncLogOptions options = {fd, mz_AsyncLogPolicyBlock, 50, 100};
+  mz_asynclog_start(&options);
+  for (size_t i = 0; i < 1000; i++) {
+    mz_asynclog_log(mz_AsyncLogLevelInfo, "rate.c", 1, 0, "record %zu", i);
+  }
+  size_t dropped = mz_asynclog_dropped();
+  mz_asynclog_stop();
+  char *text = asynclog_read_all(fd);
+  size_t written = asynclog_count(text, "record ");
+  //the loop may cross into the next second once
+  mu_assert("error - rate limit was not applied", written >= 50 && written <= 100 && written + dropped == 1000);
+  mu_assert("error - rate limited records were not reported", asynclog_count(text, "over the rate limit") > 0);
+  free(text);
+  close(fd);
+  return 0;
+}
+
+static char *it_runs_one_writer_at_a_time() {
+  int fd = asynclog_temp_file();
+  mz_AsyncLogOptions options = {fd, mz_AsyncLogPolicyBlock, 0, 100};
+  mu_assert("error - start failed", mz_asynclog_start(&options));
+  mu_assert("error - second start succeeded", !mz_asynclog_start(&options));
+  mz_asynclog_stop();
+  //stopping twice is harmless and a stopped logger starts again
+  mz_asynclog_stop();
+  mu_assert("error - restart failed", mz_asynclog_start(&options));
+  mz_asynclog_stop();
+  close(fd);
+  return 0;
+}
+
+static char *mz_asynclog_tests() {
+  mu_run_test(it_formats_captured_arguments_like_printf);
+  mu_run_test(it_writes_the_records_of_every_thread_in_order);
+  mu_run_test(it_drops_records_when_the_ring_is_full);
+  mu_run_test(it_drops_records_over_the_rate_limit);
+  mu_run_test(it_runs_one_writer_at_a_time);
+  return 0;
+}
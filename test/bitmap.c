@@ -0,0 +1,110 @@
+#include <stdio.h>
+#include <stdint.h>
+#include "../lib/minunit.h"
+#include "../mz/bitmap.h"
+#include "../mz/logger.h"
+
+bool bitmap_is_even(const void *element) {
+  return (uintptr_t) element % 2 == 0;
+}
+
+bool bitmap_is_multiple_of_three(const void *element) {
+  return (uintptr_t) element % 3 == 0;
+}
+
+mz_ArrayList *bitmap_numbers(uintptr_t count) {
+  mz_ArrayList *list = mz_arraylist_new(MZ_ARRAYLIST_INLINE_CAPACITY, sizeof(void *));
+  for (uintptr_t i = 0; i < count; i++) {
+    mz_arraylist_append(list, (void *) i);
+  }
+  return list;
+}
+
+static char *it_combines_and_counts_bitmaps() {
+  mz_Bitmap *a = mz_bitmap_new(130);
+  mz_Bitmap *b = mz_bitmap_new(130);
+  mz_Bitmap *result = mz_bitmap_new(130);
+  mz_Bitmap *other_size = mz_bitmap_new(64);
+  mz_bitmap_set(a, 0);
+  mz_bitmap_set(a, 64);
+  mz_bitmap_set(a, 129);
+  mz_bitmap_set(b, 64);
+  mz_bitmap_set(b, 100);
+  mu_assert("error - bit 129 not set", mz_bitmap_test(a, 129));
+  mu_assert("error - a count != 3", mz_bitmap_count(a) == 3);
+  mz_bitmap_and(result, a, b);
+  mu_assert("error - and count != 1", mz_bitmap_count(result) == 1 && mz_bitmap_test(result, 64));
+  mz_bitmap_or(result, a, b);
+  mu_assert("error - or count != 4", mz_bitmap_count(result) == 4);
+  //bits past size stay clear
+  mz_bitmap_not(result, result);
+  mu_assert("error - not count != 126", mz_bitmap_count(result) == 126);
+  mz_bitmap_clear(a, 64);
+  mu_assert("error - next after 1 != 129", mz_bitmap_next(a, 1) == 129);
+  mu_assert("error - next after 130 != NPOS", mz_bitmap_next(a, 130) == MZ_NPOS);
+  mu_assert("error - mismatched sizes combined", !mz_bitmap_and(result, a, other_size));
+  mz_bitmap_fill(b, true);
+  mu_assert("error - filled count != 130", mz_bitmap_count(b) == 130);
+  mz_bitmap_free(a);
+  mz_bitmap_free(b);
+  mz_bitmap_free(result);
+  mz_bitmap_free(other_size);
+  return 0;
+}
+
+static char *it_filters_into_bitmaps_and_compacts() {
+  mz_ArrayList *list = bitmap_numbers(200);
+  mz_Bitmap *even = mz_arraylist_filter_bitmap(list, bitmap_is_even);
+  mu_assert("error - even count != 100", mz_bitmap_count(even) == 100);
+  mz_arraylist_filter_bitmap_and(list, even, bitmap_is_multiple_of_three);
+  //multiples of six below 200
+  mu_assert("error - count != 34", mz_bitmap_count(even) == 34);
+  size_t visited = 0;
+  bool multiples = true;
+  mzm_bitmap_foreach(even, index) {
+    multiples = multiples && index % 6 == 0;
+    visited++;
+  }
+  mu_assert("error - foreach visited != 34", visited == 34);
+  mu_assert("error - foreach visited a non multiple of six", multiples);
+  mz_ArrayList *compacted = mz_arraylist_compact(list, even);
+  mu_assert("error - compacted size != 34", compacted->size == 34);
+  mu_assert("error - compacted element != 198", mz_arraylist_get(compacted, 33) == (void *) 198);
+  mz_arraylist_free(compacted);
+  mz_bitmap_free(even);
+  mz_arraylist_free(list);
+  return 0;
+}
+
+static char *it_filters_into_selections_and_gathers() {
+  mz_ArrayList *list = bitmap_numbers(100);
+  mz_PackedList *selection = mz_arraylist_filter_selection(list, bitmap_is_multiple_of_three);
+  mu_assert("error - selection size != 34", selection->size == 34);
+  size_t *indices = mz_packedlist_data(selection);
+  mu_assert("error - index != 99", indices[33] == 99);
+  mz_ArrayList *gathered = mz_arraylist_gather(list, indices, selection->size);
+  mu_assert("error - gathered size != 34", gathered->size == 34);
+  mu_assert("error - gathered element != 3", mz_arraylist_get(gathered, 1) == (void *) 3);
+  mz_arraylist_free(gathered);
+
+  mz_Bitmap *bitmap = mz_arraylist_filter_bitmap(list, bitmap_is_multiple_of_three);
+  mz_PackedList *converted = mz_bitmap_to_selection(bitmap);
+  mu_assert("error - converted selection differs",
+            converted->size == selection->size &&
+            memcmp(mz_packedlist_data(converted), indices, selection->size * sizeof(size_t)) == 0);
+
+  size_t out_of_range = 100;
+  mu_assert("error - gathered out of range index", mz_arraylist_gather(list, &out_of_range, 1) == NULL);
+  mz_packedlist_free(converted);
+  mz_bitmap_free(bitmap);
+  mz_packedlist_free(selection);
+  mz_arraylist_free(list);
+  return 0;
+}
+
+static char *mz_bitmap_tests() {
+  mu_run_test(it_combines_and_counts_bitmaps);
+  mu_run_test(it_filters_into_bitmaps_and_compacts);
+  mu_run_test(it_filters_into_selections_and_gathers);
+  return 0;
+}
@@ -0,0 +1,130 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "../lib/minunit.h"
+#include "../mz/columnlist.h"
+#include "../mz/simd.h"
+#include "../mz/logger.h"
+
+typedef struct columnlist_Event {
+  int64_t timestamp;
+  int32_t user;
+  char kind;
+  double amount;
+} columnlist_Event;
+
+enum {
+  columnlist_timestamp,
+  columnlist_user,
+  columnlist_kind,
+  columnlist_amount
+};
+
+const mz_ColumnListField columnlist_schema[] = {
+    MZ_COLUMNLIST_FIELD(columnlist_Event, timestamp),
+    MZ_COLUMNLIST_FIELD(columnlist_Event, user),
+    MZ_COLUMNLIST_FIELD(columnlist_Event, kind),
+    MZ_COLUMNLIST_FIELD(columnlist_Event, amount)
+};
+
+mz_ColumnList *columnlist_events(size_t count) {
+  mz_ColumnList *list = mz_columnlist_new(4, columnlist_schema, 4);
+  for (size_t i = 0; i < count; i++) {
+    columnlist_Event event = {
+        .timestamp = (int64_t) ((i * 7919) % count),
+        .user = (int32_t) (i % 10),
+        .kind = (char) ('a' + i % 3),
+        .amount = (double) i / 2
+    };
+    mz_columnlist_append_row(list, &event);
+  }
+  return list;
+}
+
+bool columnlist_is_user_three(const void *value) {
+  return *(const int32_t *) value == 3;
+}
+
+bool columnlist_is_kind_b(const void *value) {
+  return *(const char *) value == 'b';
+}
+
+int columnlist_compare_timestamp(const void *a, const void *b) {
+  int64_t x = *(const int64_t *) a;
+  int64_t y = *(const int64_t *) b;
+  return x < y ? -1 : x > y;
+}
+
+int columnlist_compare_user(const void *a, const void *b) {
+  return *(const int32_t *) a - *(const int32_t *) b;
+}
+
+static char *it_stores_rows_as_columns() {
+  mz_ColumnList *list = columnlist_events(1000);
+  mu_assert("error - size != 1000", mz_columnlist_size(list) == 1000);
+  columnlist_Event event;
+  mu_assert("error - get_row failed", mz_columnlist_get_row(list, 7, &event));
+  mu_assert("error - row 7 is wrong", event.user == 7 && event.kind == 'b' && event.amount == 3.5);
+  mu_assert("error - get_row past the end", !mz_columnlist_get_row(list, 1000, &event));
+  //a view is the column itself, so column kernels scan it without copying
+  mz_ColumnView users = mz_columnlist_view(list, columnlist_user);
+  mu_assert("error - view does not point into the column", users.data == list->columns[columnlist_user]->data);
+  mu_assert("error - count of user 3", mz_simd_count_int32((int32_t *) users.data, users.size, mz_SimdCompareEqual, 3) == 100);
+  mz_ColumnView tail = mz_columnview_sub(users, 995, 2000);
+  mu_assert("error - sub view", tail.size == 5 && *(int32_t *) mz_columnview_get(tail, 0) == 5);
+  mu_assert("error - amount column", *(double *) mz_columnlist_get(list, columnlist_amount, 10) == 5.0);
+  mz_columnlist_free(list);
+  return 0;
+}
+
+static char *it_filters_and_compacts_every_column() {
+  mz_ColumnList *list = columnlist_events(1000);
+  mz_Bitmap *matches = mz_columnlist_filter_bitmap(list, columnlist_user, columnlist_is_user_three);
+  mu_assert("error - filter count != 100", mz_bitmap_count(matches) == 100);
+  mu_assert("error - filter_bitmap_and failed",
+            mz_columnlist_filter_bitmap_and(list, columnlist_kind, matches, columnlist_is_kind_b));
+  //user 3 means i % 10 == 3, kind b means i % 3 == 1, so i % 30 == 13
+  mu_assert("error - filter_and count != 33", mz_bitmap_count(matches) == 33);
+  mu_assert("error - compact failed", mz_columnlist_compact(list, matches));
+  mu_assert("error - size != 33", mz_columnlist_size(list) == 33);
+  for (size_t i = 0; i < 33; i++) {
+    columnlist_Event event;
+    mz_columnlist_get_row(list, i, &event);
+    mu_assert("error - compacted row is wrong", event.amount == (double) (13 + 30 * i) / 2 && event.user == 3);
+  }
+  mz_bitmap_free(matches);
+  mz_columnlist_free(list);
+  return 0;
+}
+
+static char *it_sorts_every_column_by_one() {
+  mz_ColumnList *list = columnlist_events(1000);
+  mu_assert("error - sort failed", mz_columnlist_sort(list, columnlist_timestamp, columnlist_compare_timestamp));
+  for (size_t i = 0; i < 1000; i++) {
+    columnlist_Event event;
+    mz_columnlist_get_row(list, i, &event);
+    mu_assert("error - timestamps are not sorted", event.timestamp == (int64_t) i);
+    //the row that had this timestamp came along with it
+    size_t original = (size_t) (event.amount * 2);
+    mu_assert("error - columns were not permuted together",
+              (original * 7919) % 1000 == i && event.user == (int32_t) (original % 10));
+  }
+  mu_assert("error - stable sort failed", mz_columnlist_sort(list, columnlist_user, columnlist_compare_user));
+  for (size_t i = 1; i < 1000; i++) {
+    columnlist_Event previous, current;
+    mz_columnlist_get_row(list, i - 1, &previous);
+    mz_columnlist_get_row(list, i, &current);
+    mu_assert("error - users are not sorted", previous.user <= current.user);
+    mu_assert("error - equal users lost their timestamp order",
+              previous.user < current.user || previous.timestamp < current.timestamp);
+  }
+  mz_columnlist_free(list);
+  return 0;
+}
+
+static char *mz_columnlist_tests() {
+  mu_run_test(it_stores_rows_as_columns);
+  mu_run_test(it_filters_and_compacts_every_column);
+  mu_run_test(it_sorts_every_column_by_one);
+  return 0;
+}
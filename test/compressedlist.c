@@ -0,0 +1,121 @@
+#include <stdio.h>
+#include <stdint.h>
+#include "../lib/minunit.h"
+#include "../mz/compressedlist.h"
+#include "../mz/simd.h"
+#include "../mz/logger.h"
+
+//sorted values with gaps of every width, including runs of duplicates and 32 bit jumps
+#define COMPRESSEDLIST_TEST_LEN 5000
+
+uint32_t compressedlist_values[COMPRESSEDLIST_TEST_LEN];
+
+void compressedlist_fill() {
+  uint32_t value = 3;
+  for (size_t i = 0; i < COMPRESSEDLIST_TEST_LEN; i++) {
+    compressedlist_values[i] = value;
+    if (i == 3000) {
+      value += 0xf0000000u;
+    } else if (i % 700 < 300) {
+      value += (uint32_t) ((i * 7919) % 5);
+    } else {
+      value += (uint32_t) ((i * 7919) % 100000);
+    }
+  }
+}
+
+static char *it_round_trips_values_at_every_level() {
+  compressedlist_fill();
+  mz_CompressedList *list = mz_compressedlist_new();
+  mu_assert("error - append_range failed",
+            mz_compressedlist_append_range(list, compressedlist_values, COMPRESSEDLIST_TEST_LEN));
+  mu_assert("error - size is wrong", mz_compressedlist_size(list) == COMPRESSEDLIST_TEST_LEN);
+  mu_assert("error - block count is wrong", mz_compressedlist_block_count(list) == (COMPRESSEDLIST_TEST_LEN + 127) / 128);
+  mz_SimdLevel levels[] = {mz_SimdLevelScalar, mz_SimdLevelAuto};
+  for (size_t l = 0; l < 2; l++) {
+    mz_simd_force_level(levels[l]);
+    mz_PackedList *decoded = mz_compressedlist_to_packedlist(list);
+    mu_assert("error - decoded size is wrong", decoded->size == COMPRESSEDLIST_TEST_LEN);
+    for (size_t i = 0; i < COMPRESSEDLIST_TEST_LEN; i++) {
+      mu_assert("error - decoded value is wrong", ((uint32_t *) decoded->data)[i] == compressedlist_values[i]);
+    }
+    mz_packedlist_free(decoded);
+  }
+  mz_simd_force_level(mz_SimdLevelAuto);
+  uint32_t value = 0;
+  mu_assert("error - get 4321", mz_compressedlist_get(list, 4321, &value) && value == compressedlist_values[4321]);
+  mu_assert("error - get past the end", !mz_compressedlist_get(list, COMPRESSEDLIST_TEST_LEN, &value));
+  mu_assert("error - decreasing append succeeded", !mz_compressedlist_append(list, 2));
+  mz_compressedlist_free(list);
+  return 0;
+}
+
+static char *it_searches_through_the_skip_index() {
+  compressedlist_fill();
+  mz_CompressedList *list = mz_compressedlist_new();
+  mz_compressedlist_append_range(list, compressedlist_values, COMPRESSEDLIST_TEST_LEN);
+  for (size_t i = 0; i < COMPRESSEDLIST_TEST_LEN; i += 37) {
+    size_t expected = i;
+    while (expected > 0 && compressedlist_values[expected - 1] == compressedlist_values[i]) {
+      expected--;
+    }
+    mu_assert("error - lower_bound of a value", mz_compressedlist_lower_bound(list, compressedlist_values[i]) == expected);
+    mu_assert("error - contains", mz_compressedlist_contains(list, compressedlist_values[i]));
+  }
+  mu_assert("error - lower_bound below the first", mz_compressedlist_lower_bound(list, 0) == 0);
+  mu_assert("error - lower_bound past the last", mz_compressedlist_lower_bound(list, UINT32_MAX) == COMPRESSEDLIST_TEST_LEN ||
+                                                 compressedlist_values[COMPRESSEDLIST_TEST_LEN - 1] == UINT32_MAX);
+  mu_assert("error - contains a missing value", !mz_compressedlist_contains(list, 0));
+  mz_compressedlist_free(list);
+  return 0;
+}
+
+static char *it_intersects_block_by_block() {
+  mz_CompressedList *a = mz_compressedlist_new();
+  mz_CompressedList *b = mz_compressedlist_new();
+  for (uint32_t i = 0; i < 100000; i += 2) {
+    mz_compressedlist_append(a, i);
+  }
+  for (uint32_t i = 0; i < 100000; i += 3) {
+    mz_compressedlist_append(b, i);
+  }
+  //a long stretch of b that no block of a overlaps
+  for (uint32_t i = 0; i < 1000; i++) {
+    mz_compressedlist_append(b, 200001 + 2 * i);
+  }
+  mz_PackedList *result = mz_compressedlist_intersect(a, b);
+  mu_assert("error - intersection size is wrong", result->size == (100000 + 5) / 6);
+  for (size_t i = 0; i < result->size; i++) {
+    mu_assert("error - intersection value is wrong", ((uint32_t *) result->data)[i] == i * 6);
+  }
+  mz_packedlist_free(result);
+  mz_CompressedList *empty = mz_compressedlist_new();
+  result = mz_compressedlist_intersect(a, empty);
+  mu_assert("error - intersection with empty list", result->size == 0);
+  mz_packedlist_free(result);
+  mz_compressedlist_free(empty);
+  mz_compressedlist_free(a);
+  mz_compressedlist_free(b);
+  return 0;
+}
+
+static char *it_takes_less_memory_than_pointers() {
+  mz_CompressedList *list = mz_compressedlist_new();
+  for (uint32_t i = 0; i < 1000000; i++) {
+    mu_assert("error - append failed", mz_compressedlist_append(list, i * 3 + (i & 1)));
+  }
+  mu_assert("error - size != 1000000", mz_compressedlist_size(list) == 1000000);
+  //deltas alternate between 4 and 2, which need 3 bits, plus the skip index
+  size_t memory = mz_compressedlist_memory_size(list);
+  mu_assert("error - not 8 times smaller than 8 byte slots", memory * 8 < 1000000 * sizeof(void *));
+  mz_compressedlist_free(list);
+  return 0;
+}
+
+static char *mz_compressedlist_tests() {
+  mu_run_test(it_round_trips_values_at_every_level);
+  mu_run_test(it_searches_through_the_skip_index);
+  mu_run_test(it_intersects_block_by_block);
+  mu_run_test(it_takes_less_memory_than_pointers);
+  return 0;
+}
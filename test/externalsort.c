@@ -0,0 +1,165 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "../lib/minunit.h"
+#include "../mz/externalsort.h"
+#include "../mz/logger.h"
+
+int externalsort_compare(const void *a, const void *b) {
+  uintptr_t x = *(uintptr_t *) a;
+  uintptr_t y = *(uintptr_t *) b;
+  return x < y ? -1 : x > y;
+}
+
+//orders by the high bits only, so the low bits show whether equal values kept their order
+int externalsort_compare_bucket(const void *a, const void *b) {
+  uintptr_t x = *(uintptr_t *) a >> 24;
+  uintptr_t y = *(uintptr_t *) b >> 24;
+  return x < y ? -1 : x > y;
+}
+
+int externalsort_compare_string(const void *a, const void *b) {
+  return strcmp(*(char **) a, *(char **) b);
+}
+
+const void *externalsort_encode_string(const void *element, size_t *len) {
+  *len = strlen(element) + 1;
+  return element;
+}
+
+void *externalsort_decode_string(const void *data, size_t len) {
+  char *string = malloc(len);
+  memcpy(string, data, len);
+  return string;
+}
+
+size_t externalsort_frees = 0;
+
+void externalsort_free_string(void *element) {
+  externalsort_frees++;
+  free(element);
+}
+
+bool externalsort_collect(void *context, void *element) {
+  return mz_arraylist_append(context, element);
+}
+
+typedef struct externalsort_Limit {
+  mz_ArrayList *list;
+  size_t limit;
+} externalsort_Limit;
+
+bool externalsort_collect_limit(void *context, void *element) {
+  externalsort_Limit *limit = context;
+  mz_arraylist_append(limit->list, element);
+  return limit->list->size < limit->limit;
+}
+
+static char *it_sorts_more_than_the_memory_budget() {
+  mz_ExternalSort *sorter = mz_externalsort_new(16 * 1024, externalsort_compare, NULL, NULL, NULL, NULL);
+  for (uintptr_t i = 0; i < 100000; i++) {
+    mu_assert("error - add failed", mz_externalsort_add(sorter, (void *) ((i * 7919) % 100000)));
+  }
+  mu_assert("error - nothing was spilled", mz_externalsort_run_count(sorter) > 10);
+  mz_ArrayList *result = mz_arraylist_new(16, sizeof(void *));
+  mu_assert("error - finish failed", mz_externalsort_finish(sorter, externalsort_collect, result));
+  mu_assert("error - size != 100000", result->size == 100000);
+  for (uintptr_t i = 0; i < 100000; i++) {
+    mu_assert("error - output is not sorted", result->array[i] == (void *) i);
+  }
+  mu_assert("error - runs were not closed", mz_externalsort_run_count(sorter) == 0);
+  //the sorter can be reused, this time everything fits in memory
+  result->size = 0;
+  mz_externalsort_add(sorter, (void *) 2);
+  mz_externalsort_add(sorter, (void *) 1);
+  mu_assert("error - finish failed", mz_externalsort_finish(sorter, externalsort_collect, result));
+  mu_assert("error - in memory sort", result->size == 2 && result->array[0] == (void *) 1);
+  mz_arraylist_free(result);
+  mz_externalsort_free(sorter);
+  return 0;
+}
+
+static char *it_keeps_equal_elements_in_order_across_runs() {
+  mz_ExternalSort *sorter = mz_externalsort_new(4 * 1024, externalsort_compare_bucket, NULL, NULL, NULL, NULL);
+  for (uintptr_t i = 0; i < 20000; i++) {
+    mz_externalsort_add(sorter, (void *) (((i % 13) << 24) | i));
+  }
+  mz_ArrayList *result = mz_arraylist_new(16, sizeof(void *));
+  mz_externalsort_finish(sorter, externalsort_collect, result);
+  mu_assert("error - size != 20000", result->size == 20000);
+  for (size_t i = 1; i < result->size; i++) {
+    uintptr_t previous = (uintptr_t) result->array[i - 1];
+    uintptr_t current = (uintptr_t) result->array[i];
+    mu_assert("error - output is not sorted", (current >> 24) >= (previous >> 24));
+    mu_assert("error - equal elements reordered", (current >> 24) > (previous >> 24) || current > previous);
+  }
+  mz_arraylist_free(result);
+  mz_externalsort_free(sorter);
+  return 0;
+}
+
+static char *it_refuses_to_release_elements_it_does_not_encode() {
+  mz_ExternalSort *sorter = mz_externalsort_new(1024, externalsort_compare_string, NULL, NULL,
+                                                externalsort_free_string, NULL);
+  mu_assert("error - free_fn without encode_fn was accepted", sorter == NULL);
+  return 0;
+}
+
+static char *it_sorts_encoded_elements() {
+  externalsort_frees = 0;
+  mz_ExternalSort *sorter = mz_externalsort_new(1024, externalsort_compare_string, externalsort_encode_string,
+                                                externalsort_decode_string, externalsort_free_string, NULL);
+  char text[32];
+  for (size_t i = 0; i < 2000; i++) {
+    snprintf(text, sizeof(text), "key-%05zu", (i * 7919) % 2000);
+    mz_externalsort_add(sorter, strdup(text));
+  }
+  mu_assert("error - nothing was spilled", mz_externalsort_run_count(sorter) > 1);
+  mu_assert("error - spilled elements were not released", externalsort_frees > 0);
+  mz_ArrayList *result = mz_arraylist_new(16, sizeof(void *));
+  mu_assert("error - finish failed", mz_externalsort_finish(sorter, externalsort_collect, result));
+  mu_assert("error - size != 2000", result->size == 2000);
+  mu_assert("error - every added element was not released", externalsort_frees == 2000);
+  for (size_t i = 0; i < result->size; i++) {
+    snprintf(text, sizeof(text), "key-%05zu", i);
+    mu_assert("error - output is not sorted", strcmp(result->array[i], text) == 0);
+    free(result->array[i]);
+  }
+  mz_arraylist_free(result);
+  mz_externalsort_free(sorter);
+  return 0;
+}
+
+static char *it_stops_when_the_output_says_so() {
+  externalsort_frees = 0;
+  mz_ExternalSort *sorter = mz_externalsort_new(1024, externalsort_compare_string, externalsort_encode_string,
+                                                externalsort_decode_string, externalsort_free_string, NULL);
+  char text[32];
+  for (size_t i = 0; i < 500; i++) {
+    snprintf(text, sizeof(text), "key-%05zu", 499 - i);
+    mz_externalsort_add(sorter, strdup(text));
+  }
+  //the buffered elements are spilled as one more run
+  size_t runs = mz_externalsort_run_count(sorter) + (sorter->buffer->size > 0);
+  externalsort_Limit limit = {mz_arraylist_new(16, sizeof(void *)), 10};
+  mu_assert("error - finish failed", mz_externalsort_finish(sorter, externalsort_collect_limit, &limit));
+  mu_assert("error - size != 10", limit.list->size == 10);
+  mu_assert("error - first != key-00000", strcmp(limit.list->array[0], "key-00000") == 0);
+  //the first ten come from the last run, the current element of every other run was read and had to be released
+  mu_assert("error - unread elements were not released", externalsort_frees == 500 + runs - 1);
+  for (size_t i = 0; i < limit.list->size; i++) {
+    free(limit.list->array[i]);
+  }
+  mz_arraylist_free(limit.list);
+  mz_externalsort_free(sorter);
+  return 0;
+}
+
+static char *mz_externalsort_tests() {
+  mu_run_test(it_sorts_more_than_the_memory_budget);
+  mu_run_test(it_keeps_equal_elements_in_order_across_runs);
+  mu_run_test(it_refuses_to_release_elements_it_does_not_encode);
+  mu_run_test(it_sorts_encoded_elements);
+  mu_run_test(it_stops_when_the_output_says_so);
+  return 0;
+}
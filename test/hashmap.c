@@ -0,0 +1,106 @@
+#include <stdio.h>
+#include <stdint.h>
+#include "../lib/minunit.h"
+#include "../mz/hashmap.h"
+#include "../mz/logger.h"
+
+//every key lands in the same group, so probing has to walk past full groups
+uint64_t hashmap_colliding_hash(const void *key) {
+  return 42;
+}
+
+static char *it_puts_gets_and_replaces_values() {
+  mz_HashMap *map = mz_hashmap_new(4, mz_hash_pointer, mz_equal_pointer);
+  for (uintptr_t i = 0; i < 1000; i++) {
+    mu_assert("error - put failed", mz_hashmap_put(map, (void *) i, (void *) (i * 2)));
+  }
+  mu_assert("error - size != 1000", mz_hashmap_size(map) == 1000);
+  void *value = NULL;
+  for (uintptr_t i = 0; i < 1000; i++) {
+    mu_assert("error - key not found", mz_hashmap_get(map, (void *) i, &value));
+    mu_assert("error - value != 2 * key", value == (void *) (i * 2));
+  }
+  mu_assert("error - missing key found", !mz_hashmap_get(map, (void *) 1000, &value));
+  mz_hashmap_put(map, (void *) 7, (void *) 1);
+  mu_assert("error - value not replaced", mz_hashmap_get(map, (void *) 7, &value) && value == (void *) 1);
+  mu_assert("error - size changed on replace", mz_hashmap_size(map) == 1000);
+  mu_assert("error - index of key 7 != 7", mz_hashmap_index_of(map, (void *) 7) == 7);
+  mz_hashmap_free(map);
+  return 0;
+}
+
+static char *it_removes_and_iterates_in_insertion_order() {
+  mz_HashMap *map = mz_hashmap_new(16, mz_hash_pointer, mz_equal_pointer);
+  for (uintptr_t i = 0; i < 100; i++) {
+    mz_hashmap_put(map, (void *) (1000 - i), (void *) i);
+  }
+  for (uintptr_t i = 0; i < 100; i += 2) {
+    mu_assert("error - remove failed", mz_hashmap_remove(map, (void *) (1000 - i)));
+  }
+  mu_assert("error - removed twice", !mz_hashmap_remove(map, (void *) 1000));
+  mu_assert("error - size != 50", mz_hashmap_size(map) == 50);
+  uintptr_t expected = 1;
+  size_t visited = 0;
+  bool ordered = true;
+  mzm_hashmap_foreach(map, key, value, index) {
+    ordered = ordered && value == (void *) expected && key == (void *) (1000 - expected);
+    expected += 2;
+    visited++;
+  }
+  mu_assert("error - iteration visited != 50", visited == 50);
+  mu_assert("error - iteration is not in insertion order", ordered);
+  //a rehash closes the holes and keeps the order
+  mu_assert("error - rehash failed", mz_hashmap_rehash(map));
+  mu_assert("error - holes left after rehash", map->keys->size == 50);
+  mu_assert("error - first key != 999", mz_hashmap_key_at(map, 0) == (void *) 999);
+  mu_assert("error - key lost in rehash", mz_hashmap_contains(map, (void *) 901));
+  mz_hashmap_free(map);
+  return 0;
+}
+
+static char *it_probes_past_full_groups() {
+  mz_HashMap *map = mz_hashmap_new(0, hashmap_colliding_hash, mz_equal_pointer);
+  for (uintptr_t i = 0; i < 100; i++) {
+    mz_hashmap_put(map, (void *) i, (void *) i);
+  }
+  for (uintptr_t i = 0; i < 100; i += 3) {
+    mz_hashmap_remove(map, (void *) i);
+  }
+  bool found = true;
+  for (uintptr_t i = 0; i < 100; i++) {
+    found = found && mz_hashmap_contains(map, (void *) i) == (i % 3 != 0);
+  }
+  mu_assert("error - colliding keys lost", found);
+  mz_hashmap_put(map, (void *) 0, (void *) 0);
+  mu_assert("error - reinserted key not found", mz_hashmap_contains(map, (void *) 0));
+  mz_hashmap_free(map);
+  return 0;
+}
+
+static char *it_holds_string_keys_in_a_set() {
+  mz_HashSet *set = mz_hashset_new(0, mz_hash_string, mz_equal_string);
+  char *words[] = {"alpha", "beta", "gamma", "beta"};
+  for (int i = 0; i < 4; i++) {
+    mu_assert("error - add failed", mz_hashset_add(set, words[i]));
+  }
+  mu_assert("error - size != 3", mz_hashset_size(set) == 3);
+  char key[] = "gamma";
+  mu_assert("error - equal string not found", mz_hashset_contains(set, key));
+  mu_assert("error - remove failed", mz_hashset_remove(set, "alpha"));
+  mu_assert("error - removed string found", !mz_hashset_contains(set, "alpha"));
+  size_t visited = 0;
+  mzm_hashset_foreach(set, word, index) {
+    visited += word != NULL;
+  }
+  mu_assert("error - iteration visited != 2", visited == 2);
+  mz_hashset_free(set);
+  return 0;
+}
+
+static char *mz_hashmap_tests() {
+  mu_run_test(it_puts_gets_and_replaces_values);
+  mu_run_test(it_removes_and_iterates_in_insertion_order);
+  mu_run_test(it_probes_past_full_groups);
+  mu_run_test(it_holds_string_keys_in_a_set);
+  return 0;
+}
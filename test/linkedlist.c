@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <string.h>
+#include <stdint.h>
 #include "../lib/minunit.h"
 #include "../mz/linkedlist.h"
 #include "../mz/logger.h"
@@ -206,6 +207,139 @@ static char *it_pushes_item_at_list_head() {
   return 0;
 }
 
+static char *it_moves_nodes_without_reallocating() {
+  mz_LinkedList *list = mz_linkedlist_new();
+  char *one = "one";
+  char *two = "two";
+  char *three = "three";
+  mz_linkedlist_push(list, one);
+  mz_linkedlist_push(list, two);
+  mz_linkedlist_push(list, three);
+  mz_LinkedListNode *node_three = list->last;
+  mz_linkedlist_move_to_front(list, node_three);
+  mu_assert("error - first != node_three", list->first == node_three);
+  mu_assert("error - last->value != two", list->last->value == two);
+  mu_assert("error - count != 3", list->count == 3);
+  mz_linkedlist_move_to_front(list, node_three);
+  mu_assert("error - moving the first node changed the list", list->first == node_three && list->count == 3);
+  mz_LinkedListNode *node_one = list->first->next;
+  mz_linkedlist_unlink(list, node_one);
+  mu_assert("error - count != 2", list->count == 2);
+  mu_assert("error - first->next != last", list->first->next == list->last && list->last->prev == list->first);
+  mz_linkedlist_link_last(list, node_one);
+  mu_assert("error - last != node_one", list->last == node_one && node_one->prev->value == two);
+  mz_LinkedListNode *node_two = node_one->prev;
+  mz_linkedlist_unlink(list, node_three);
+  mz_linkedlist_unlink(list, node_two);
+  mu_assert("error - list does not hold only node_one", list->first == node_one && list->last == node_one);
+  mz_linkedlist_unlink(list, node_one);
+  mu_assert("error - list is not empty", list->count == 0 && list->first == NULL && list->last == NULL);
+  mz_linkedlist_link_first(list, node_one);
+  mu_assert("error - list does not hold only node_one", list->first == node_one && list->last == node_one);
+  free(node_two);
+  free(node_three);
+  mz_linkedlist_free(list);
+  return 0;
+}
+
+//orders by the high bits only, so the low bits show whether equal values kept their order
+int linkedlist_compare_bucket(const void *a, const void *b) {
+  uintptr_t x = *(uintptr_t *) a >> 16;
+  uintptr_t y = *(uintptr_t *) b >> 16;
+  return x < y ? -1 : x > y;
+}
+
+static char *it_sorts_a_list_in_place() {
+  mz_LinkedList *list = mz_linkedlist_new();
+  for (uintptr_t i = 0; i < 1000; i++) {
+    mz_linkedlist_push(list, (void *) ((((i * 7919) % 37) << 16) | i));
+  }
+  mz_LinkedListNode *node_zero = list->first;
+  mu_assert("error - sort failed", mz_linkedlist_sort(list, linkedlist_compare_bucket));
+  mu_assert("error - count != 1000", list->count == 1000);
+  mu_assert("error - sort reallocated the first node", list->first == node_zero);
+  size_t count = 0;
+  uintptr_t previous = 0;
+  mz_LinkedListNode *prev = NULL;
+  mz_m_linkedlist_foreach(list, first, next, node) {
+    uintptr_t current = (uintptr_t) node->value;
+    mu_assert("error - list is not sorted", (current >> 16) >= (previous >> 16));
+    mu_assert("error - sort is not stable",
+              (current >> 16) > (previous >> 16) || (current & 0xffff) > (previous & 0xffff) || count == 0);
+    mu_assert("error - prev link is broken", node->prev == prev);
+    previous = current;
+    prev = node;
+    count++;
+  }
+  mu_assert("error - last is wrong", list->last == prev && count == 1000);
+  mz_LinkedList *empty = mz_linkedlist_new();
+  mu_assert("error - sorting an empty list failed", mz_linkedlist_sort(empty, linkedlist_compare_bucket));
+  mz_linkedlist_free(empty);
+  mz_linkedlist_free(list);
+  return 0;
+}
+
+static char *it_splices_and_concatenates_lists() {
+  void *a[] = {(void *) 1, (void *) 2, (void *) 3};
+  void *b[] = {(void *) 10, (void *) 11};
+  mz_LinkedList *list = mz_linkedlist_from_array(a, 3);
+  mz_LinkedList *other = mz_linkedlist_from_array(b, 2);
+  mz_linkedlist_splice(list, list->first->next, other);
+  mu_assert("error - other is not empty", other->count == 0 && other->first == NULL && other->last == NULL);
+  mz_ArrayList *array = mz_linkedlist_to_array(list);
+  void *expected[] = {(void *) 1, (void *) 10, (void *) 11, (void *) 2, (void *) 3};
+  mu_assert("error - size != 5", array->size == 5);
+  for (size_t i = 0; i < 5; i++) {
+    mu_assert("error - splice put nodes in the wrong place", array->array[i] == expected[i]);
+  }
+  mz_arraylist_free(array);
+  mz_linkedlist_push(other, (void *) 4);
+  mz_linkedlist_concat(list, other);
+  mu_assert("error - concat did not append", list->count == 6 && list->last->value == (void *) 4);
+  mu_assert("error - concat broke prev", list->last->prev->value == (void *) 3);
+  mz_linkedlist_push(other, (void *) 0);
+  mz_linkedlist_splice(list, list->first, other);
+  mu_assert("error - splice at first", list->first->value == (void *) 0 && list->first->prev == NULL);
+  mu_assert("error - splice at first broke next", list->first->next->prev == list->first);
+  mz_linkedlist_free(other);
+  mz_linkedlist_free(list);
+  return 0;
+}
+
+static char *it_splits_a_list() {
+  void *values[] = {(void *) 1, (void *) 2, (void *) 3, (void *) 4, (void *) 5};
+  mz_LinkedList *list = mz_linkedlist_from_array(values, 5);
+  mz_LinkedList *rest = mz_linkedlist_split_at(list, 3);
+  mu_assert("error - split sizes", list->count == 3 && rest->count == 2);
+  mu_assert("error - list ends at 3", list->last->value == (void *) 3 && list->last->next == NULL);
+  mu_assert("error - rest starts at 4", rest->first->value == (void *) 4 && rest->first->prev == NULL);
+  mz_LinkedList *all = mz_linkedlist_split_at(list, 0);
+  mu_assert("error - split at 0", list->count == 0 && list->first == NULL && all->count == 3);
+  mz_LinkedList *none = mz_linkedlist_split_at(all, 3);
+  mu_assert("error - split at the end", none->count == 0 && all->count == 3);
+  mu_assert("error - split past the end succeeded", mz_linkedlist_split_at(all, 4) == NULL);
+  mz_linkedlist_free(none);
+  mz_linkedlist_free(all);
+  mz_linkedlist_free(rest);
+  mz_linkedlist_free(list);
+  return 0;
+}
+
+static char *it_pushes_and_shifts_unchecked() {
+  mz_LinkedList *list = mz_linkedlist_new();
+  for (long i = 0; i < 100; i++) {
+    mu_assert("error - push_unchecked failed", mz_linkedlist_push_unchecked(list, (void *) i));
+  }
+  mu_assert("error - count != 100", list->count == 100 && list->last->value == (void *) 99);
+  for (long i = 0; i < 100; i++) {
+    mu_assert("error - shift_unchecked out of order", mz_linkedlist_shift_unchecked(list) == (void *) i);
+  }
+  mu_assert("error - list is not empty", list->count == 0 && list->first == NULL && list->last == NULL);
+  mu_assert("error - shift of empty list", mz_linkedlist_shift(list) == NULL);
+  mz_linkedlist_free(list);
+  return 0;
+}
+
 static char *mz_linkedlist_tests() {
   mu_run_test(it_creates_a_list);
   mu_run_test(it_pushes_item_into_empty_list);
@@ -221,5 +355,10 @@ static char *mz_linkedlist_tests() {
   mu_run_test(it_pops_first_item_from_list);
   mu_run_test(it_returns_null_when_popping_first_item_from_empty_list);
   mu_run_test(it_pushes_item_at_list_head);
+  mu_run_test(it_moves_nodes_without_reallocating);
+  mu_run_test(it_sorts_a_list_in_place);
+  mu_run_test(it_splices_and_concatenates_lists);
+  mu_run_test(it_splits_a_list);
+  mu_run_test(it_pushes_and_shifts_unchecked);
   return 0;
 }
@@ -0,0 +1,101 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <sched.h>
+#include <pthread.h>
+#include "../lib/minunit.h"
+#include "../mz/lockfreestack.h"
+#include "../mz/logger.h"
+
+#define LOCKFREESTACK_TEST_THREADS 4
+#define LOCKFREESTACK_TEST_ITEMS 1000
+#define LOCKFREESTACK_TEST_ROUNDS 20000
+
+//every thread pops an item and pushes it back, as a free list user would
+void *lockfreestack_test_recycler(void *arg) {
+  mz_LockFreeStack *stack = arg;
+  for (int i = 0; i < LOCKFREESTACK_TEST_ROUNDS; i++) {
+    void *value = NULL;
+    if (mz_lockfreestack_pop(stack, &value)) {
+      mz_lockfreestack_push(stack, value);
+    } else {
+      sched_yield();
+    }
+  }
+  return NULL;
+}
+
+static char *it_pushes_and_pops_in_lifo_order() {
+  mz_LockFreeStack *stack = mz_lockfreestack_new(2);
+  void *value = NULL;
+  mu_assert("error - new stack is not empty", mz_lockfreestack_is_empty(stack));
+  mu_assert("error - popped from empty stack", !mz_lockfreestack_pop(stack, &value));
+  for (uintptr_t i = 1; i <= 10; i++) {
+    mu_assert("error - push failed", mz_lockfreestack_push(stack, (void *) i));
+  }
+  for (uintptr_t i = 10; i >= 1; i--) {
+    mu_assert("error - pop failed", mz_lockfreestack_pop(stack, &value));
+    mu_assert("error - value != i", value == (void *) i);
+  }
+  mu_assert("error - stack is not empty", mz_lockfreestack_is_empty(stack));
+  //popped nodes are reused instead of allocating more
+  mz_lockfreestack_push(stack, (void *) 11);
+  mu_assert("error - nodes were not recycled", atomic_load(&stack->allocated) == 10);
+  mz_lockfreestack_free(stack);
+  return 0;
+}
+
+static char *it_pops_all_elements_at_once() {
+  mz_LockFreeStack *stack = mz_lockfreestack_new(4);
+  mz_ArrayList *list = mz_arraylist_new(4, sizeof(void *));
+  mu_assert("error - pop_all of empty stack failed", mz_lockfreestack_pop_all(stack, list));
+  mu_assert("error - list is not empty", list->size == 0);
+  for (uintptr_t i = 1; i <= 20; i++) {
+    mz_lockfreestack_push(stack, (void *) i);
+  }
+  mu_assert("error - pop_all failed", mz_lockfreestack_pop_all(stack, list));
+  mu_assert("error - size != 20", list->size == 20);
+  mu_assert("error - first != top", mz_arraylist_get(list, 0) == (void *) 20);
+  mu_assert("error - last != bottom", mz_arraylist_get(list, 19) == (void *) 1);
+  mu_assert("error - stack is not empty", mz_lockfreestack_is_empty(stack));
+  mz_lockfreestack_push(stack, (void *) 21);
+  mu_assert("error - nodes were not recycled", atomic_load(&stack->allocated) == 20);
+  mz_arraylist_free(list);
+  mz_lockfreestack_free(stack);
+  return 0;
+}
+
+static char *it_recycles_items_between_threads() {
+  mz_LockFreeStack *stack = mz_lockfreestack_new(64);
+  for (uintptr_t i = 1; i <= LOCKFREESTACK_TEST_ITEMS; i++) {
+    mz_lockfreestack_push(stack, (void *) i);
+  }
+  pthread_t threads[LOCKFREESTACK_TEST_THREADS];
+  for (int i = 0; i < LOCKFREESTACK_TEST_THREADS; i++) {
+    pthread_create(&threads[i], NULL, lockfreestack_test_recycler, stack);
+  }
+  for (int i = 0; i < LOCKFREESTACK_TEST_THREADS; i++) {
+    pthread_join(threads[i], NULL);
+  }
+  //no item may be lost or duplicated
+  mz_ArrayList *list = mz_arraylist_new(LOCKFREESTACK_TEST_ITEMS, sizeof(void *));
+  mz_lockfreestack_pop_all(stack, list);
+  char seen[LOCKFREESTACK_TEST_ITEMS + 1] = {0};
+  bool unique = true;
+  mzm_arraylist_foreach(list, value, index) {
+    uintptr_t item = (uintptr_t) value;
+    unique = unique && item >= 1 && item <= LOCKFREESTACK_TEST_ITEMS && !seen[item];
+    seen[item <= LOCKFREESTACK_TEST_ITEMS ? item : 0] = 1;
+  }
+  mu_assert("error - size != pushed", list->size == LOCKFREESTACK_TEST_ITEMS);
+  mu_assert("error - item lost or duplicated", unique);
+  mz_arraylist_free(list);
+  mz_lockfreestack_free(stack);
+  return 0;
+}
+
+static char *mz_lockfreestack_tests() {
+  mu_run_test(it_pushes_and_pops_in_lifo_order);
+  mu_run_test(it_pops_all_elements_at_once);
+  mu_run_test(it_recycles_items_between_threads);
+  return 0;
+}
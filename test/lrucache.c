@@ -0,0 +1,167 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include "../lib/minunit.h"
+#include "../mz/lrucache.h"
+#include "../mz/logger.h"
+
+typedef struct lrucache_Evictions {
+  size_t count;
+  void *keys[16];
+} lrucache_Evictions;
+
+void lrucache_record_eviction(void *context, void *key, void *value) {
+  lrucache_Evictions *evictions = context;
+  if (evictions->count < 16) {
+    evictions->keys[evictions->count] = key;
+  }
+  evictions->count++;
+}
+
+size_t lrucache_value_size(const void *key, const void *value) {
+  return (uintptr_t) value;
+}
+
+static char *it_evicts_the_least_recently_used_entry() {
+  lrucache_Evictions evictions = {0};
+  mz_LruCache *cache = mz_lrucache_new(3, mz_hash_pointer, mz_equal_pointer);
+  mz_lrucache_set_evict_fn(cache, lrucache_record_eviction, &evictions);
+  for (uintptr_t i = 1; i <= 3; i++) {
+    mu_assert("error - put failed", mz_lrucache_put(cache, (void *) i, (void *) (i * 10)));
+  }
+  void *value = NULL;
+  mu_assert("error - get 1 failed", mz_lrucache_get(cache, (void *) 1, &value) && value == (void *) 10);
+  mu_assert("error - put 4 failed", mz_lrucache_put(cache, (void *) 4, (void *) 40));
+  mu_assert("error - size != 3", mz_lrucache_size(cache) == 3);
+  mu_assert("error - 2 was not evicted", evictions.count == 1 && evictions.keys[0] == (void *) 2);
+  mu_assert("error - 2 is still cached", !mz_lrucache_contains(cache, (void *) 2));
+  mu_assert("error - peek 3 failed", mz_lrucache_peek(cache, (void *) 3, &value) && value == (void *) 30);
+  mu_assert("error - put 5 failed", mz_lrucache_put(cache, (void *) 5, (void *) 50));
+  mu_assert("error - peek moved 3 to the front", evictions.count == 2 && evictions.keys[1] == (void *) 3);
+  mu_assert("error - get of evicted key succeeded", !mz_lrucache_get(cache, (void *) 3, &value));
+  mu_assert("error - hits != 1 or misses != 1", cache->hits == 1 && cache->misses == 1);
+  mu_assert("error - evictions != 2", cache->evictions == 2);
+  mz_lrucache_free(cache);
+  mu_assert("error - free did not hand out the remaining entries", evictions.count == 5);
+  return 0;
+}
+
+static char *it_reuses_nodes_on_hits_and_evictions() {
+  mz_LruCache *cache = mz_lrucache_new(2, mz_hash_pointer, mz_equal_pointer);
+  mz_lrucache_put(cache, (void *) 1, (void *) 10);
+  mz_lrucache_put(cache, (void *) 2, (void *) 20);
+  mz_LinkedListNode *node_one = cache->recency->last;
+  mz_lrucache_get(cache, (void *) 1, NULL);
+  mu_assert("error - hit did not relink the same node", cache->recency->first == node_one);
+  mz_LinkedListNode *node_two = cache->recency->last;
+  mz_lrucache_put(cache, (void *) 3, (void *) 30);
+  mu_assert("error - put did not reuse the evicted entry", cache->recency->first == node_two);
+  mu_assert("error - recency list is not 3, 1", cache->recency->last == node_one);
+  mu_assert("error - replace failed", mz_lrucache_put(cache, (void *) 1, (void *) 11));
+  mu_assert("error - replace allocated a node", cache->recency->first == node_one && mz_lrucache_size(cache) == 2);
+  void *value = NULL;
+  mu_assert("error - value was not replaced", mz_lrucache_get(cache, (void *) 1, &value) && value == (void *) 11);
+  mu_assert("error - remove failed", mz_lrucache_remove(cache, (void *) 3, &value) && value == (void *) 30);
+  mu_assert("error - remove of missing key succeeded", !mz_lrucache_remove(cache, (void *) 3, NULL));
+  mu_assert("error - evict failed", mz_lrucache_evict(cache) && mz_lrucache_size(cache) == 0);
+  mu_assert("error - evict of empty cache succeeded", !mz_lrucache_evict(cache));
+  mz_lrucache_free(cache);
+  return 0;
+}
+
+static char *it_bounds_the_cache_by_bytes() {
+  lrucache_Evictions evictions = {0};
+  mz_LruCache *cache = mz_lrucache_new(0, mz_hash_pointer, mz_equal_pointer);
+  mz_lrucache_set_evict_fn(cache, lrucache_record_eviction, &evictions);
+  mu_assert("error - set_byte_limit failed", mz_lrucache_set_byte_limit(cache, 100, lrucache_value_size));
+  mz_lrucache_put(cache, (void *) 1, (void *) 40);
+  mz_lrucache_put(cache, (void *) 2, (void *) 40);
+  mu_assert("error - bytes != 80", cache->bytes == 80);
+  mz_lrucache_put(cache, (void *) 3, (void *) 30);
+  mu_assert("error - 1 was not evicted", evictions.count == 1 && evictions.keys[0] == (void *) 1);
+  mu_assert("error - bytes != 70", cache->bytes == 70);
+  mu_assert("error - oversized entry was accepted", !mz_lrucache_put(cache, (void *) 4, (void *) 101));
+  mu_assert("error - oversized entry evicted entries", mz_lrucache_size(cache) == 2);
+  mz_lrucache_put(cache, (void *) 3, (void *) 90);
+  mu_assert("error - growing 3 did not evict 2", evictions.count == 2 && evictions.keys[1] == (void *) 2);
+  mu_assert("error - bytes != 90", cache->bytes == 90 && mz_lrucache_size(cache) == 1);
+  mz_lrucache_set_byte_limit(cache, 50, lrucache_value_size);
+  mu_assert("error - lowering the limit did not evict", mz_lrucache_size(cache) == 0 && cache->bytes == 0);
+  mz_lrucache_free(cache);
+  return 0;
+}
+
+static char *it_handles_string_keys() {
+  mz_LruCache *cache = mz_lrucache_new(2, mz_hash_string, mz_equal_string);
+  char key[16];
+  strcpy(key, "apple");
+  mz_lrucache_put(cache, "apple", (void *) 1);
+  mz_lrucache_put(cache, "pear", (void *) 2);
+  void *value = NULL;
+  mu_assert("error - lookup by equal string failed", mz_lrucache_get(cache, key, &value) && value == (void *) 1);
+  mz_lrucache_put(cache, "plum", (void *) 3);
+  mu_assert("error - pear is still cached", !mz_lrucache_contains(cache, "pear"));
+  mu_assert("error - apple was evicted", mz_lrucache_contains(cache, key));
+  mz_lrucache_free(cache);
+  return 0;
+}
+
+typedef struct lrucache_Worker {
+  mz_ShardedLruCache *cache;
+  uintptr_t base;
+  size_t mismatches;
+} lrucache_Worker;
+
+void *lrucache_worker(void *arg) {
+  lrucache_Worker *worker = arg;
+  for (uintptr_t i = 0; i < 20000; i++) {
+    uintptr_t key = worker->base + i % 512;
+    void *value = NULL;
+    if (mz_shardedlrucache_get(worker->cache, (void *) key, &value)) {
+      if (value != (void *) (key * 2)) {
+        worker->mismatches++;
+      }
+    } else {
+      mz_shardedlrucache_put(worker->cache, (void *) key, (void *) (key * 2));
+    }
+    if (i % 64 == 0) {
+      sched_yield();
+    }
+  }
+  return NULL;
+}
+
+static char *it_shares_a_sharded_cache_between_threads() {
+  mz_ShardedLruCache *cache = mz_shardedlrucache_new(6, 1024, mz_hash_pointer, mz_equal_pointer);
+  mu_assert("error - shard_count != 8", cache->shard_count == 8);
+  pthread_t threads[4];
+  lrucache_Worker workers[4];
+  for (size_t i = 0; i < 4; i++) {
+    workers[i] = (lrucache_Worker) {cache, 1 + i * 100000, 0};
+    pthread_create(&threads[i], NULL, lrucache_worker, &workers[i]);
+  }
+  for (size_t i = 0; i < 4; i++) {
+    pthread_join(threads[i], NULL);
+    mu_assert("error - a thread read a wrong value", workers[i].mismatches == 0);
+  }
+  size_t size = mz_shardedlrucache_size(cache);
+  mu_assert("error - sharded cache exceeds its capacity", size > 0 && size <= 1024);
+  void *value = NULL;
+  mu_assert("error - put failed", mz_shardedlrucache_put(cache, (void *) 7, (void *) 70));
+  mu_assert("error - get failed", mz_shardedlrucache_get(cache, (void *) 7, &value) && value == (void *) 70);
+  mu_assert("error - remove failed", mz_shardedlrucache_remove(cache, (void *) 7, NULL));
+  mu_assert("error - removed key is still cached", !mz_shardedlrucache_get(cache, (void *) 7, &value));
+  mz_shardedlrucache_free(cache);
+  return 0;
+}
+
+static char *mz_lrucache_tests() {
+  mu_run_test(it_evicts_the_least_recently_used_entry);
+  mu_run_test(it_reuses_nodes_on_hits_and_evictions);
+  mu_run_test(it_bounds_the_cache_by_bytes);
+  mu_run_test(it_handles_string_keys);
+  mu_run_test(it_shares_a_sharded_cache_between_threads);
+  return 0;
+}
@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "../lib/minunit.h"
+#include "../mz/mpmcqueue.h"
+#include "../mz/logger.h"
+
+#define MPMCQUEUE_TEST_THREADS 4
+#define MPMCQUEUE_TEST_ITEMS 100000
+
+typedef struct mpmcqueue_test_context {
+  mz_MpmcQueue *queue;
+  atomic_size_t consumed;
+  atomic_uint_fast64_t sum;
+} mpmcqueue_test_context;
+
+void *mpmcqueue_test_producer(void *arg) {
+  mpmcqueue_test_context *context = arg;
+  for (uintptr_t i = 1; i <= MPMCQUEUE_TEST_ITEMS; i++) {
+    while (!mz_mpmcqueue_push(context->queue, (void *) i)) {
+      sched_yield();
+    }
+  }
+  return NULL;
+}
+
+void *mpmcqueue_test_consumer(void *arg) {
+  mpmcqueue_test_context *context = arg;
+  const size_t total = (size_t) MPMCQUEUE_TEST_THREADS * MPMCQUEUE_TEST_ITEMS;
+  uint64_t sum = 0;
+  while (atomic_load(&context->consumed) < total) {
+    void *value;
+    if (mz_mpmcqueue_shift(context->queue, &value)) {
+      sum += (uintptr_t) value;
+      atomic_fetch_add(&context->consumed, 1);
+    } else {
+      sched_yield();
+    }
+  }
+  atomic_fetch_add(&context->sum, sum);
+  return NULL;
+}
+
+static char *it_creates_mpmcqueue_with_power_of_two_capacity() {
+  mz_MpmcQueue *queue = mz_mpmcqueue_new(100);
+  mu_assert("error - capacity != 128", mz_mpmcqueue_capacity(queue) == 128);
+  mu_assert("error - size != 0", mz_mpmcqueue_size(queue) == 0);
+  mz_mpmcqueue_free(queue);
+  return 0;
+}
+
+static char *it_pushes_and_shifts_in_fifo_order() {
+  mz_MpmcQueue *queue = mz_mpmcqueue_new(4);
+  void *value = NULL;
+  mu_assert("error - shift from empty queue succeeded", !mz_mpmcqueue_shift(queue, &value));
+  for (uintptr_t lap = 0; lap < 3; lap++) {
+    for (uintptr_t i = 0; i < 4; i++) {
+      mu_assert("error - push failed", mz_mpmcqueue_push(queue, (void *) (lap * 4 + i)));
+    }
+    mu_assert("error - push into full queue succeeded", !mz_mpmcqueue_push(queue, NULL));
+    mu_assert("error - size != 4", mz_mpmcqueue_size(queue) == 4);
+    for (uintptr_t i = 0; i < 4; i++) {
+      mu_assert("error - shift failed", mz_mpmcqueue_shift(queue, &value));
+      mu_assert("error - value out of order", value == (void *) (lap * 4 + i));
+    }
+    mu_assert("error - shift from empty queue succeeded", !mz_mpmcqueue_shift(queue, &value));
+  }
+  mz_mpmcqueue_free(queue);
+  return 0;
+}
+
+static char *it_passes_every_value_between_many_producers_and_consumers() {
+  mpmcqueue_test_context context;
+  context.queue = mz_mpmcqueue_new(1024);
+  atomic_init(&context.consumed, 0);
+  atomic_init(&context.sum, 0);
+  pthread_t producers[MPMCQUEUE_TEST_THREADS];
+  pthread_t consumers[MPMCQUEUE_TEST_THREADS];
+  for (int i = 0; i < MPMCQUEUE_TEST_THREADS; i++) {
+    pthread_create(&consumers[i], NULL, mpmcqueue_test_consumer, &context);
+    pthread_create(&producers[i], NULL, mpmcqueue_test_producer, &context);
+  }
+  for (int i = 0; i < MPMCQUEUE_TEST_THREADS; i++) {
+    pthread_join(producers[i], NULL);
+    pthread_join(consumers[i], NULL);
+  }
+  uint64_t expected = (uint64_t) MPMCQUEUE_TEST_THREADS * MPMCQUEUE_TEST_ITEMS * (MPMCQUEUE_TEST_ITEMS + 1) / 2;
+  mu_assert("error - sum of consumed values != sum of produced values", atomic_load(&context.sum) == expected);
+  mu_assert("error - queue is not empty", mz_mpmcqueue_size(context.queue) == 0);
+  mz_mpmcqueue_free(context.queue);
+  return 0;
+}
+
+static char *mz_mpmcqueue_tests() {
+  mu_run_test(it_creates_mpmcqueue_with_power_of_two_capacity);
+  mu_run_test(it_pushes_and_shifts_in_fifo_order);
+  mu_run_test(it_passes_every_value_between_many_producers_and_consumers);
+  return 0;
+}
@@ -0,0 +1,143 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "../lib/minunit.h"
+#include "../mz/packedlist.h"
+#include "../mz/logger.h"
+
+int packedlist_comparator_fn(const void *first, const void *second) {
+  int64_t a = *((int64_t *) first);
+  int64_t b = *((int64_t *) second);
+  return (a > b) - (a < b);
+}
+
+char *packedlist_temp_path(char *buffer) {
+  strcpy(buffer, "/tmp/mz_packedlist_XXXXXX");
+  int fd = mkstemp(buffer);
+  if (fd != -1) {
+    close(fd);
+  }
+  return buffer;
+}
+
+static char *it_appends_inline_values_to_packedlist() {
+  const size_t INITIAL_CAPACITY = 2;
+  mz_PackedList *list = mz_packedlist_new(INITIAL_CAPACITY, sizeof(int64_t));
+  for (int64_t i = 0; i < 10; i++) {
+    mz_packedlist_append(list, &i);
+  }
+  int64_t range[] = {10, 11};
+  bool result = mz_packedlist_append_range(list, range, 2);
+  mu_assert("error - result != true", result == true);
+  mu_assert("error - size != 12", list->size == 12);
+  mu_assert("error - capacity != 16", list->capacity == 16);
+  mzm_packedlist_foreach(list, int64_t, element, index) {
+    mu_assert("error - element != index", *element == (int64_t) index);
+  }
+  int64_t value = 42;
+  mu_assert("error - set failed", mz_packedlist_set(list, 3, &value));
+  mu_assert("error - element at index 3 != 42", *(int64_t *) mz_packedlist_get(list, 3) == 42);
+  mu_assert("error - get out of range != NULL", mz_packedlist_get(list, 12) == NULL);
+  mz_packedlist_free(list);
+  return 0;
+}
+
+static char *it_sorts_and_searches_packedlist() {
+  const size_t INITIAL_CAPACITY = 100;
+  mz_PackedList *list = mz_packedlist_new(INITIAL_CAPACITY, sizeof(int64_t));
+  for (int64_t i = 0; i < 100; i++) {
+    int64_t value = (i * 37) % 100;
+    mz_packedlist_append(list, &value);
+  }
+  mu_assert("error - sort failed", mz_packedlist_sort(list, packedlist_comparator_fn));
+  mzm_packedlist_foreach(list, int64_t, element, index) {
+    mu_assert("error - element not sorted", *element == (int64_t) index);
+  }
+  int64_t item_to_find = 57;
+  int64_t missing = 100;
+  mu_assert("error - index of 57 != 57",
+            mz_packedlist_binary_search(list, &item_to_find, packedlist_comparator_fn) == 57);
+  mu_assert("error - index of 100 != MZ_NPOS",
+            mz_packedlist_binary_search(list, &missing, packedlist_comparator_fn) == MZ_NPOS);
+  mz_packedlist_free(list);
+  return 0;
+}
+
+static char *it_saves_and_maps_packedlist_read_only() {
+  char path[32];
+  packedlist_temp_path(path);
+  mz_PackedList *list = mz_packedlist_new(16, sizeof(int64_t));
+  for (int64_t i = 0; i < 1000; i++) {
+    mz_packedlist_append(list, &i);
+  }
+  mu_assert("error - save failed", mz_packedlist_save(list, path));
+  mz_PackedList *mapped = mz_packedlist_map(path, mz_PackedListMapModeReadOnly, true);
+  mu_assert("error - map failed", mapped != NULL);
+  mu_assert("error - mapped list is not mapped", mz_packedlist_is_mapped(mapped));
+  mu_assert("error - mapped size != 1000", mapped->size == 1000);
+  mu_assert("error - mapped element_size != 8", mapped->element_size == sizeof(int64_t));
+  mu_assert("error - mapped data differs", memcmp(mapped->data, list->data, 1000 * sizeof(int64_t)) == 0);
+  int64_t value = 7;
+  mu_assert("error - set on read only mapping succeeded", !mz_packedlist_set(mapped, 0, &value));
+  mu_assert("error - append on read only mapping succeeded", !mz_packedlist_append(mapped, &value));
+  mz_packedlist_free(mapped);
+  mz_packedlist_free(list);
+  unlink(path);
+  return 0;
+}
+
+static char *it_maps_packedlist_copy_on_write() {
+  char path[32];
+  packedlist_temp_path(path);
+  mz_PackedList *list = mz_packedlist_new(16, sizeof(int64_t));
+  for (int64_t i = 0; i < 100; i++) {
+    mz_packedlist_append(list, &i);
+  }
+  mz_packedlist_save(list, path);
+  mz_PackedList *mapped = mz_packedlist_map(path, mz_PackedListMapModeCopyOnWrite, false);
+  int64_t value = -1;
+  mu_assert("error - set on copy on write mapping failed", mz_packedlist_set(mapped, 0, &value));
+  mu_assert("error - append on copy on write mapping failed", mz_packedlist_append(mapped, &value));
+  mu_assert("error - list still mapped after growing", !mz_packedlist_is_mapped(mapped));
+  mu_assert("error - size != 101", mapped->size == 101);
+  mu_assert("error - element at index 0 != -1", *(int64_t *) mz_packedlist_get(mapped, 0) == -1);
+  mu_assert("error - element at index 99 != 99", *(int64_t *) mz_packedlist_get(mapped, 99) == 99);
+  mz_PackedList *reopened = mz_packedlist_map(path, mz_PackedListMapModeReadOnly, true);
+  mu_assert("error - file was modified", *(int64_t *) mz_packedlist_get(reopened, 0) == 0);
+  mz_packedlist_free(reopened);
+  mz_packedlist_free(mapped);
+  mz_packedlist_free(list);
+  unlink(path);
+  return 0;
+}
+
+static char *it_rejects_corrupted_packedlist_file() {
+  char path[32];
+  packedlist_temp_path(path);
+  mz_PackedList *list = mz_packedlist_new(16, sizeof(int64_t));
+  for (int64_t i = 0; i < 100; i++) {
+    mz_packedlist_append(list, &i);
+  }
+  mz_packedlist_save(list, path);
+  FILE *file = fopen(path, "r+b");
+  fseek(file, MZ_PACKEDLIST_DATA_OFFSET + 8, SEEK_SET);
+  fputc(0xff, file);
+  fclose(file);
+  mu_assert("error - corrupted file mapped", mz_packedlist_map(path, mz_PackedListMapModeReadOnly, true) == NULL);
+  truncate(path, MZ_PACKEDLIST_DATA_OFFSET + 8);
+  mu_assert("error - truncated file mapped", mz_packedlist_map(path, mz_PackedListMapModeReadOnly, false) == NULL);
+  mz_packedlist_free(list);
+  unlink(path);
+  return 0;
+}
+
+static char *mz_packedlist_tests() {
+  mu_run_test(it_appends_inline_values_to_packedlist);
+  mu_run_test(it_sorts_and_searches_packedlist);
+  mu_run_test(it_saves_and_maps_packedlist_read_only);
+  mu_run_test(it_maps_packedlist_copy_on_write);
+  mu_run_test(it_rejects_corrupted_packedlist_file);
+  return 0;
+}
@@ -0,0 +1,84 @@
+#include <stdio.h>
+#include <stdint.h>
+#include "../lib/minunit.h"
+#include "../mz/priorityqueue.h"
+#include "../mz/logger.h"
+
+int priorityqueue_compare(const void *a, const void *b) {
+  uintptr_t x = *(uintptr_t *) a;
+  uintptr_t y = *(uintptr_t *) b;
+  return x < y ? -1 : x > y;
+}
+
+//pops everything and checks the values come out in ascending order
+bool priorityqueue_drains_in_order(mz_PriorityQueue *queue, size_t expected_count) {
+  size_t count = 0;
+  uintptr_t previous = 0;
+  void *value = NULL;
+  bool ordered = true;
+  while (mz_priorityqueue_pop(queue, &value)) {
+    ordered = ordered && (uintptr_t) value >= previous;
+    previous = (uintptr_t) value;
+    count++;
+  }
+  return ordered && count == expected_count;
+}
+
+static char *it_pops_in_priority_order_for_every_arity() {
+  for (size_t arity = 2; arity <= 8; arity *= 2) {
+    mz_PriorityQueue *queue = mz_priorityqueue_new(arity, priorityqueue_compare);
+    void *value = NULL;
+    mu_assert("error - peeked into empty queue", !mz_priorityqueue_peek(queue, &value));
+    for (uintptr_t i = 0; i < 500; i++) {
+      mu_assert("error - push failed", mz_priorityqueue_push(queue, (void *) ((i * 7919) % 500)) != NULL);
+    }
+    mu_assert("error - size != 500", mz_priorityqueue_size(queue) == 500);
+    mu_assert("error - peek != 0", mz_priorityqueue_peek(queue, &value) && value == (void *) 0);
+    mu_assert("error - values out of order", priorityqueue_drains_in_order(queue, 500));
+    mu_assert("error - queue is not empty", mz_priorityqueue_is_empty(queue));
+    mz_priorityqueue_free(queue);
+  }
+  return 0;
+}
+
+static char *it_heapifies_in_bulk() {
+  mz_PriorityQueue *queue = mz_priorityqueue_new(4, priorityqueue_compare);
+  void *values[300];
+  mz_PriorityQueueNode *handles[300];
+  for (uintptr_t i = 0; i < 300; i++) {
+    values[i] = (void *) (300 - i);
+  }
+  mz_priorityqueue_push(queue, (void *) 150);
+  mu_assert("error - heapify failed", mz_priorityqueue_heapify(queue, values, 300, handles));
+  mu_assert("error - handle has wrong value", handles[10]->value == (void *) 290);
+  mu_assert("error - values out of order", priorityqueue_drains_in_order(queue, 301));
+  mz_priorityqueue_free(queue);
+  return 0;
+}
+
+static char *it_updates_and_removes_through_handles() {
+  mz_PriorityQueue *queue = mz_priorityqueue_new(2, priorityqueue_compare);
+  mz_PriorityQueueNode *handles[100];
+  for (uintptr_t i = 0; i < 100; i++) {
+    handles[i] = mz_priorityqueue_push(queue, (void *) (i + 100));
+  }
+  void *value = NULL;
+  //decrease-key moves the node to the top, increase-key to the bottom
+  mz_priorityqueue_update(queue, handles[70], (void *) 1);
+  mu_assert("error - decreased key is not on top", mz_priorityqueue_peek(queue, &value) && value == (void *) 1);
+  mz_priorityqueue_update(queue, handles[70], (void *) 1000);
+  mu_assert("error - increased key is still on top", mz_priorityqueue_peek(queue, &value) && value == (void *) 100);
+  mu_assert("error - remove failed", mz_priorityqueue_remove(queue, handles[0]));
+  mu_assert("error - removed node is still on top", mz_priorityqueue_peek(queue, &value) && value == (void *) 101);
+  mu_assert("error - removed node removed twice", !mz_priorityqueue_remove(queue, handles[0]));
+  mu_assert("error - values out of order", priorityqueue_drains_in_order(queue, 99));
+  mz_priorityqueue_free(queue);
+  return 0;
+}
+
+static char *mz_priorityqueue_tests() {
+  mu_run_test(it_pops_in_priority_order_for_every_arity);
+  mu_run_test(it_heapifies_in_bulk);
+  mu_run_test(it_updates_and_removes_through_handles);
+  return 0;
+}
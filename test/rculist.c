@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <sched.h>
+#include <pthread.h>
+#include "../lib/minunit.h"
+#include "../mz/rculist.h"
+#include "../mz/logger.h"
+
+#define RCULIST_TEST_READERS 4
+#define RCULIST_TEST_UPDATES 2000
+#define RCULIST_TEST_SIZE 32
+
+typedef struct rculist_test_context {
+  mz_RcuList *list;
+  atomic_bool done;
+  atomic_bool reader_saw_torn_version;
+} rculist_test_context;
+
+void *rculist_test_reader(void *arg) {
+  rculist_test_context *context = arg;
+  mz_RcuListReader *reader = mz_rculist_reader_register(context->list);
+  uintptr_t last = 0;
+  while (!atomic_load(&context->done)) {
+    //every element of a version holds the version number
+    const mz_ArrayList *snapshot = mz_rculist_read_lock(context->list, reader);
+    uintptr_t version = snapshot->size > 0 ? (uintptr_t) snapshot->array[0] : 0;
+    bool torn = version < last;
+    for (size_t i = 0; i < snapshot->size; i++) {
+      torn = torn || (uintptr_t) snapshot->array[i] != version;
+    }
+    mz_rculist_read_unlock(reader);
+    if (torn) {
+      atomic_store(&context->reader_saw_torn_version, true);
+    }
+    last = version;
+    sched_yield();
+  }
+  mz_rculist_reader_unregister(context->list, reader);
+  return NULL;
+}
+
+static char *it_publishes_updates_to_readers() {
+  mz_RcuList *list = mz_rculist_new(4);
+  mz_RcuListReader *reader = mz_rculist_reader_register(list);
+  mu_assert("error - reader is NULL", reader != NULL);
+  const mz_ArrayList *snapshot = mz_rculist_read_lock(list, reader);
+  mu_assert("error - new list is not empty", snapshot->size == 0);
+  mz_rculist_read_unlock(reader);
+
+  mz_ArrayList *update = mz_rculist_update_begin(list);
+  mz_arraylist_append(update, (void *) 1);
+  mz_arraylist_append(update, (void *) 2);
+  mu_assert("error - commit failed", mz_rculist_update_commit(list, update));
+
+  snapshot = mz_rculist_read_lock(list, reader);
+  mu_assert("error - size != 2", snapshot->size == 2);
+  mu_assert("error - element != 2", snapshot->array[1] == (void *) 2);
+  mz_rculist_read_unlock(reader);
+
+  update = mz_rculist_update_begin(list);
+  mz_arraylist_append(update, (void *) 3);
+  mz_rculist_update_abort(list, update);
+  snapshot = mz_rculist_read_lock(list, reader);
+  mu_assert("error - aborted update is visible", snapshot->size == 2);
+  mz_rculist_read_unlock(reader);
+  mz_rculist_reader_unregister(list, reader);
+  mz_rculist_free(list);
+  return 0;
+}
+
+static char *it_keeps_versions_alive_while_read() {
+  mz_RcuList *list = mz_rculist_new(4);
+  mz_RcuListReader *reader = mz_rculist_reader_register(list);
+  const mz_ArrayList *snapshot = mz_rculist_read_lock(list, reader);
+
+  mz_ArrayList *update = mz_rculist_update_begin(list);
+  mz_arraylist_append(update, (void *) 1);
+  mz_rculist_update_commit(list, update);
+  mu_assert("error - snapshot changed under the reader", snapshot->size == 0);
+  mu_assert("error - version read from was reclaimed", mz_rculist_reclaim(list) == 1);
+
+  mz_rculist_read_unlock(reader);
+  mu_assert("error - version was not reclaimed", mz_rculist_reclaim(list) == 0);
+  mz_rculist_reader_unregister(list, reader);
+  mz_rculist_free(list);
+  return 0;
+}
+
+static char *it_gives_readers_consistent_snapshots() {
+  rculist_test_context context;
+  context.list = mz_rculist_new(RCULIST_TEST_SIZE);
+  atomic_init(&context.done, false);
+  atomic_init(&context.reader_saw_torn_version, false);
+  pthread_t readers[RCULIST_TEST_READERS];
+  for (int i = 0; i < RCULIST_TEST_READERS; i++) {
+    pthread_create(&readers[i], NULL, rculist_test_reader, &context);
+  }
+  for (uintptr_t version = 1; version <= RCULIST_TEST_UPDATES; version++) {
+    mz_ArrayList *update = mz_rculist_update_begin(context.list);
+    if (update->size == 0) {
+      for (size_t i = 0; i < RCULIST_TEST_SIZE; i++) {
+        mz_arraylist_append(update, (void *) version);
+      }
+    }
+    for (size_t i = 0; i < RCULIST_TEST_SIZE; i++) {
+      update->array[i] = (void *) version;
+    }
+    mz_rculist_update_commit(context.list, update);
+    sched_yield();
+  }
+  atomic_store(&context.done, true);
+  for (int i = 0; i < RCULIST_TEST_READERS; i++) {
+    pthread_join(readers[i], NULL);
+  }
+  mu_assert("error - reader saw a torn or older version", !atomic_load(&context.reader_saw_torn_version));
+  mu_assert("error - versions left after all readers left", mz_rculist_reclaim(context.list) == 0);
+  mz_rculist_free(context.list);
+  return 0;
+}
+
+static char *mz_rculist_tests() {
+  mu_run_test(it_publishes_updates_to_readers);
+  mu_run_test(it_keeps_versions_alive_while_read);
+  mu_run_test(it_gives_readers_consistent_snapshots);
+  return 0;
+}
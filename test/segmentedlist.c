@@ -0,0 +1,110 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "../lib/minunit.h"
+#include "../mz/segmentedlist.h"
+#include "../mz/logger.h"
+
+#define SEGMENTEDLIST_TEST_THREADS 8
+#define SEGMENTEDLIST_TEST_ITEMS 50000
+
+typedef struct segmentedlist_test_context {
+  mz_SegmentedList *list;
+  atomic_bool done;
+  bool reader_saw_gap;
+} segmentedlist_test_context;
+
+void *segmentedlist_test_appender(void *arg) {
+  segmentedlist_test_context *context = arg;
+  for (uintptr_t i = 1; i <= SEGMENTEDLIST_TEST_ITEMS; i++) {
+    mz_segmentedlist_append(context->list, (void *) i);
+  }
+  return NULL;
+}
+
+void *segmentedlist_test_reader(void *arg) {
+  segmentedlist_test_context *context = arg;
+  while (!atomic_load(&context->done)) {
+    //every published element must already be written
+    for (size_t k = 0; k < MZ_SEGMENTEDLIST_MAX_SEGMENTS; k++) {
+      mz_ArraySlice slice = mz_segmentedlist_segment(context->list, k);
+      if (slice.size == 0) {
+        break;
+      }
+      mzm_arrayslice_foreach(slice, element, index) {
+        context->reader_saw_gap = context->reader_saw_gap || element == NULL;
+      }
+    }
+  }
+  return NULL;
+}
+
+static char *it_appends_and_gets_across_segments() {
+  mz_SegmentedList *list = mz_segmentedlist_new(3);
+  for (uintptr_t i = 0; i < 100; i++) {
+    mu_assert("error - index != i", mz_segmentedlist_append(list, (void *) i) == i);
+  }
+  mu_assert("error - size != 100", mz_segmentedlist_size(list) == 100);
+  for (uintptr_t i = 0; i < 100; i++) {
+    mu_assert("error - element != i", mz_segmentedlist_get(list, i) == (void *) i);
+  }
+  mu_assert("error - get out of range != NULL", mz_segmentedlist_get(list, 100) == NULL);
+  //segments hold 4, 8, 16, 32, 64 elements
+  mz_ArraySlice slice = mz_segmentedlist_segment(list, 2);
+  mu_assert("error - segment 2 size != 16", slice.size == 16);
+  mu_assert("error - segment 2 starts at != 12", slice.array[0] == (void *) 12);
+  slice = mz_segmentedlist_segment(list, 4);
+  mu_assert("error - segment 4 size != 40", slice.size == 40);
+  slice = mz_segmentedlist_segment(list, 5);
+  mu_assert("error - segment 5 is not empty", slice.size == 0);
+  mz_segmentedlist_free(list);
+  return 0;
+}
+
+static char *it_keeps_element_addresses_stable() {
+  mz_SegmentedList *list = mz_segmentedlist_new(1);
+  mz_segmentedlist_append(list, (void *) 1);
+  void **first_segment = mz_segmentedlist_segment(list, 0).array;
+  for (uintptr_t i = 0; i < 1000; i++) {
+    mz_segmentedlist_append(list, (void *) i);
+  }
+  mu_assert("error - first segment moved", mz_segmentedlist_segment(list, 0).array == first_segment);
+  mz_segmentedlist_free(list);
+  return 0;
+}
+
+static char *it_appends_from_many_threads_while_reading() {
+  segmentedlist_test_context context;
+  context.list = mz_segmentedlist_new(64);
+  context.reader_saw_gap = false;
+  atomic_init(&context.done, false);
+  pthread_t reader;
+  pthread_t appenders[SEGMENTEDLIST_TEST_THREADS];
+  pthread_create(&reader, NULL, segmentedlist_test_reader, &context);
+  for (int i = 0; i < SEGMENTEDLIST_TEST_THREADS; i++) {
+    pthread_create(&appenders[i], NULL, segmentedlist_test_appender, &context);
+  }
+  for (int i = 0; i < SEGMENTEDLIST_TEST_THREADS; i++) {
+    pthread_join(appenders[i], NULL);
+  }
+  atomic_store(&context.done, true);
+  pthread_join(reader, NULL);
+  size_t size = mz_segmentedlist_size(context.list);
+  uint64_t sum = 0;
+  for (size_t i = 0; i < size; i++) {
+    sum += (uintptr_t) mz_segmentedlist_get(context.list, i);
+  }
+  uint64_t expected = (uint64_t) SEGMENTEDLIST_TEST_THREADS * SEGMENTEDLIST_TEST_ITEMS * (SEGMENTEDLIST_TEST_ITEMS + 1) / 2;
+  mu_assert("error - size != appended", size == SEGMENTEDLIST_TEST_THREADS * SEGMENTEDLIST_TEST_ITEMS);
+  mu_assert("error - sum of elements != sum of appended values", sum == expected);
+  mu_assert("error - reader saw an unwritten element", !context.reader_saw_gap);
+  mz_segmentedlist_free(context.list);
+  return 0;
+}
+
+static char *mz_segmentedlist_tests() {
+  mu_run_test(it_appends_and_gets_across_segments);
+  mu_run_test(it_keeps_element_addresses_stable);
+  mu_run_test(it_appends_from_many_threads_while_reading);
+  return 0;
+}
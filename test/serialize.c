@@ -0,0 +1,277 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "../lib/minunit.h"
+#include "../mz/serialize.h"
+#include "../mz/logger.h"
+
+typedef struct serialize_memory_stream {
+  mz_PackedList *bytes;
+  size_t position;
+  size_t write_calls;
+} serialize_memory_stream;
+
+bool serialize_memory_write(void *context, const void *data, size_t len) {
+  serialize_memory_stream *stream = context;
+  stream->write_calls += 1;
+  return mz_packedlist_append_range(stream->bytes, data, len);
+}
+
+size_t serialize_memory_read(void *context, void *data, size_t len) {
+  serialize_memory_stream *stream = context;
+  size_t remaining = stream->bytes->size - stream->position;
+  size_t count = remaining < len ? remaining : len;
+  memcpy(data, stream->bytes->data + stream->position, count);
+  stream->position += count;
+  return count;
+}
+
+const void *serialize_encode_string(const void *element, size_t *len) {
+  *len = strlen(element) + 1;
+  return element;
+}
+
+void *serialize_decode_string(const void *data, size_t len) {
+  char *result = malloc(len);
+  return memcpy(result, data, len);
+}
+
+static char *it_round_trips_arraylist_of_strings() {
+  serialize_memory_stream stream = {mz_packedlist_new(64, sizeof(char)), 0, 0};
+  mz_StreamWriter writer;
+  mz_StreamReader reader;
+  //a buffer smaller than some elements exercises the unbuffered paths
+  mz_streamwriter_init(&writer, serialize_memory_write, &stream, 16);
+  mz_streamreader_init(&reader, serialize_memory_read, &stream, 16);
+  mz_ArrayList *list = mz_arraylist_new(2, sizeof(void *));
+  char *first = "first";
+  char *second = "a string that does not fit into the stream buffer";
+  char *third = "";
+  mz_arraylist_append(list, first);
+  mz_arraylist_append(list, second);
+  mz_arraylist_append(list, third);
+  mu_assert("error - serialize failed", mz_arraylist_serialize(list, &writer, serialize_encode_string));
+  mu_assert("error - flush failed", mz_streamwriter_flush(&writer));
+  mz_ArrayList *result = mz_arraylist_deserialize(&reader, serialize_decode_string, free);
+  mu_assert("error - deserialize failed", result != NULL);
+  mu_assert("error - size != 3", result->size == 3);
+  mu_assert("error - element at index 0 != first", strcmp(result->array[0], first) == 0);
+  mu_assert("error - element at index 1 != second", strcmp(result->array[1], second) == 0);
+  mu_assert("error - element at index 2 != third", strcmp(result->array[2], third) == 0);
+  mzm_arraylist_foreach(result, element, index) {
+    free(element);
+  }
+  mz_arraylist_free(result);
+  mz_arraylist_free(list);
+  mz_streamwriter_destroy(&writer);
+  mz_streamreader_destroy(&reader);
+  mz_packedlist_free(stream.bytes);
+  return 0;
+}
+
+static char *it_batches_writes_of_large_arraylist() {
+  const size_t COUNT = 100000;
+  const size_t BUFFER_SIZE = 4096;
+  serialize_memory_stream stream = {mz_packedlist_new(BUFFER_SIZE, sizeof(char)), 0, 0};
+  mz_StreamWriter writer;
+  mz_StreamReader reader;
+  mz_streamwriter_init(&writer, serialize_memory_write, &stream, BUFFER_SIZE);
+  mz_streamreader_init(&reader, serialize_memory_read, &stream, BUFFER_SIZE);
+  mz_ArrayList *list = mz_arraylist_new(2, sizeof(void *));
+  for (size_t i = 0; i < COUNT; i++) {
+    mz_arraylist_append(list, (void *) (intptr_t) i);
+  }
+  mz_arraylist_serialize(list, &writer, NULL);
+  mz_streamwriter_flush(&writer);
+  mu_assert("error - writes were not batched", stream.write_calls <= stream.bytes->size / BUFFER_SIZE + 1);
+  mz_ArrayList *result = mz_arraylist_deserialize(&reader, NULL, NULL);
+  mu_assert("error - size != COUNT", result->size == COUNT);
+  mu_assert("error - elements differ", memcmp(result->array, list->array, COUNT * sizeof(void *)) == 0);
+  mz_arraylist_free(result);
+  mz_arraylist_free(list);
+  mz_streamwriter_destroy(&writer);
+  mz_streamreader_destroy(&reader);
+  mz_packedlist_free(stream.bytes);
+  return 0;
+}
+
+static char *it_round_trips_linkedlist_through_a_file() {
+  char path[] = "/tmp/mz_serialize_XXXXXX";
+  int fd = mkstemp(path);
+  mz_StreamWriter writer;
+  mz_StreamReader reader;
+  mz_streamwriter_init(&writer, mz_stream_fd_write, &fd, MZ_STREAM_DEFAULT_BUFFER_SIZE);
+  mz_streamreader_init(&reader, mz_stream_fd_read, &fd, MZ_STREAM_DEFAULT_BUFFER_SIZE);
+  mz_LinkedList *list = mz_linkedlist_new();
+  mz_linkedlist_push(list, "one");
+  mz_linkedlist_push(list, "two");
+  mz_linkedlist_push(list, "three");
+  mu_assert("error - serialize failed", mz_linkedlist_serialize(list, &writer, serialize_encode_string));
+  mu_assert("error - flush failed", mz_streamwriter_flush(&writer));
+  lseek(fd, 0, SEEK_SET);
+  mz_LinkedList *result = mz_linkedlist_deserialize(&reader, serialize_decode_string, free);
+  mu_assert("error - deserialize failed", result != NULL);
+  mu_assert("error - count != 3", result->count == 3);
+  mu_assert("error - first != one", strcmp(result->first->value, "one") == 0);
+  mu_assert("error - last != three", strcmp(result->last->value, "three") == 0);
+  mz_m_linkedlist_foreach(result, first, next, node) {
+    free(node->value);
+  }
+  mz_linkedlist_free(result);
+  mz_linkedlist_free(list);
+  mz_streamwriter_destroy(&writer);
+  mz_streamreader_destroy(&reader);
+  close(fd);
+  unlink(path);
+  return 0;
+}
+
+static char *it_round_trips_packedlist() {
+  serialize_memory_stream stream = {mz_packedlist_new(64, sizeof(char)), 0, 0};
+  mz_StreamWriter writer;
+  mz_StreamReader reader;
+  mz_streamwriter_init(&writer, serialize_memory_write, &stream, 64);
+  mz_streamreader_init(&reader, serialize_memory_read, &stream, 64);
+  mz_PackedList *list = mz_packedlist_new(16, sizeof(int32_t));
+  for (int32_t i = 0; i < 1000; i++) {
+    mz_packedlist_append(list, &i);
+  }
+  mz_packedlist_serialize(list, &writer);
+  mz_streamwriter_flush(&writer);
+  mz_PackedList *result = mz_packedlist_deserialize(&reader);
+  mu_assert("error - deserialize failed", result != NULL);
+  mu_assert("error - size != 1000", result->size == 1000);
+  mu_assert("error - element_size != 4", result->element_size == sizeof(int32_t));
+  mu_assert("error - elements differ", memcmp(result->data, list->data, 1000 * sizeof(int32_t)) == 0);
+  mz_packedlist_free(result);
+  mz_packedlist_free(list);
+  mz_streamwriter_destroy(&writer);
+  mz_streamreader_destroy(&reader);
+  mz_packedlist_free(stream.bytes);
+  return 0;
+}
+
+static char *it_fails_to_deserialize_truncated_stream() {
+  serialize_memory_stream stream = {mz_packedlist_new(64, sizeof(char)), 0, 0};
+  mz_StreamWriter writer;
+  mz_StreamReader reader;
+  mz_streamwriter_init(&writer, serialize_memory_write, &stream, 64);
+  mz_streamreader_init(&reader, serialize_memory_read, &stream, 64);
+  mz_ArrayList *list = mz_arraylist_new(2, sizeof(void *));
+  mz_arraylist_append(list, "first");
+  mz_arraylist_append(list, "second");
+  mz_arraylist_serialize(list, &writer, serialize_encode_string);
+  mz_streamwriter_flush(&writer);
+  stream.bytes->size -= 3;
+  mz_ArrayList *result = mz_arraylist_deserialize(&reader, serialize_decode_string, free);
+  mu_assert("error - result != NULL", result == NULL);
+  mz_arraylist_free(list);
+  mz_streamwriter_destroy(&writer);
+  mz_streamreader_destroy(&reader);
+  mz_packedlist_free(stream.bytes);
+  return 0;
+}
+
+//a header as the serializers write it, followed by trailing bytes of garbage
+void serialize_write_corrupt_header(serialize_memory_stream *stream, uint32_t magic, uint64_t count) {
+  uint32_t header[2] = {magic, MZ_SERIALIZE_VERSION};
+  mz_packedlist_append_range(stream->bytes, header, sizeof(header));
+  mz_packedlist_append_range(stream->bytes, &count, sizeof(count));
+}
+
+static char *it_rejects_corrupt_element_counts() {
+  uint64_t counts[] = {(uint64_t) 1 << 61, ((uint64_t) 1 << 63) + 1, 1000000};
+  for (size_t i = 0; i < 3; i++) {
+    serialize_memory_stream stream = {mz_packedlist_new(64, sizeof(char)), 0, 0};
+    mz_StreamReader reader;
+    mz_streamreader_init(&reader, serialize_memory_read, &stream, 64);
+    //a plausible count with a single element behind it fails at the missing elements
+    serialize_write_corrupt_header(&stream, MZ_SERIALIZE_ARRAYLIST_MAGIC, counts[i]);
+    uint64_t len = 6;
+    mz_packedlist_append_range(stream.bytes, &len, sizeof(len));
+    mz_packedlist_append_range(stream.bytes, "first", 6);
+    mu_assert("error - corrupt arraylist count was accepted",
+              mz_arraylist_deserialize(&reader, serialize_decode_string, free) == NULL);
+    mz_streamreader_destroy(&reader);
+    mz_packedlist_free(stream.bytes);
+  }
+  //the last header is valid but claims far more bytes than follow it
+  uint64_t element_sizes[] = {8, 0, 3, 4};
+  uint64_t packed_counts[] = {(uint64_t) 1 << 61, 16, UINT64_MAX / 2, (uint64_t) 1 << 40};
+  for (size_t i = 0; i < 4; i++) {
+    serialize_memory_stream stream = {mz_packedlist_new(64, sizeof(char)), 0, 0};
+    mz_StreamReader reader;
+    mz_streamreader_init(&reader, serialize_memory_read, &stream, 64);
+    serialize_write_corrupt_header(&stream, MZ_SERIALIZE_PACKEDLIST_MAGIC, packed_counts[i]);
+    mz_packedlist_append_range(stream.bytes, &element_sizes[i], sizeof(uint64_t));
+    mz_packedlist_append_range(stream.bytes, "garbage", 8);
+    mu_assert("error - corrupt packedlist header was accepted", mz_packedlist_deserialize(&reader) == NULL);
+    mz_streamreader_destroy(&reader);
+    mz_packedlist_free(stream.bytes);
+  }
+  return 0;
+}
+
+size_t serialize_live_elements = 0;
+
+void *serialize_decode_counted(const void *data, size_t len) {
+  serialize_live_elements++;
+  return serialize_decode_string(data, len);
+}
+
+void serialize_free_counted(void *element) {
+  serialize_live_elements--;
+  free(element);
+}
+
+static char *it_releases_decoded_elements_of_a_truncated_stream() {
+  serialize_memory_stream stream = {mz_packedlist_new(64, sizeof(char)), 0, 0};
+  mz_StreamWriter writer;
+  mz_streamwriter_init(&writer, serialize_memory_write, &stream, 64);
+  mz_LinkedList *list = mz_linkedlist_new();
+  for (int i = 0; i < 10; i++) {
+    mz_linkedlist_push(list, "element");
+  }
+  mz_linkedlist_serialize(list, &writer, serialize_encode_string);
+  mz_streamwriter_flush(&writer);
+  size_t linkedlist_bytes = stream.bytes->size;
+  mz_ArrayList *array = mz_linkedlist_to_array(list);
+  mz_arraylist_serialize(array, &writer, serialize_encode_string);
+  mz_streamwriter_flush(&writer);
+  //cut the arraylist short, after some of its elements
+  stream.bytes->size -= 20;
+  //and the linkedlist, by reading it from a copy that ends in its last element
+  serialize_memory_stream cut = {mz_packedlist_new(64, sizeof(char)), 0, 0};
+  mz_packedlist_append_range(cut.bytes, stream.bytes->data, linkedlist_bytes - 3);
+  mz_StreamReader reader;
+  mz_streamreader_init(&reader, serialize_memory_read, &cut, 64);
+  mu_assert("error - truncated linkedlist was accepted",
+            mz_linkedlist_deserialize(&reader, serialize_decode_counted, serialize_free_counted) == NULL);
+  mu_assert("error - decoded linkedlist elements leaked", serialize_live_elements == 0);
+  mz_streamreader_destroy(&reader);
+  stream.position = linkedlist_bytes;
+  mz_streamreader_init(&reader, serialize_memory_read, &stream, 64);
+  mu_assert("error - truncated arraylist was accepted",
+            mz_arraylist_deserialize(&reader, serialize_decode_counted, serialize_free_counted) == NULL);
+  mu_assert("error - decoded arraylist elements leaked", serialize_live_elements == 0);
+  mz_streamreader_destroy(&reader);
+  mz_streamwriter_destroy(&writer);
+  mz_arraylist_free(array);
+  mz_linkedlist_free(list);
+  mz_packedlist_free(cut.bytes);
+  mz_packedlist_free(stream.bytes);
+  return 0;
+}
+
+static char *mz_serialize_tests() {
+  mu_run_test(it_round_trips_arraylist_of_strings);
+  mu_run_test(it_batches_writes_of_large_arraylist);
+  mu_run_test(it_round_trips_linkedlist_through_a_file);
+  mu_run_test(it_round_trips_packedlist);
+  mu_run_test(it_fails_to_deserialize_truncated_stream);
+  mu_run_test(it_rejects_corrupt_element_counts);
+  mu_run_test(it_releases_decoded_elements_of_a_truncated_stream);
+  return 0;
+}
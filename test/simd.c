@@ -0,0 +1,156 @@
+#include <stdio.h>
+#include <stdint.h>
+#include "../lib/minunit.h"
+#include "../mz/simd.h"
+#include "../mz/logger.h"
+
+//long enough for several vectors of every width plus a remainder
+#define SIMD_TEST_LEN 1003
+
+int32_t simd_int32_data[SIMD_TEST_LEN];
+int64_t simd_int64_data[SIMD_TEST_LEN];
+float simd_float_data[SIMD_TEST_LEN];
+double simd_double_data[SIMD_TEST_LEN];
+
+void simd_fill() {
+  for (int i = 0; i < SIMD_TEST_LEN; i++) {
+    int32_t value = (int32_t) ((i * 7919) % 1000) - 500;
+    simd_int32_data[i] = value;
+    simd_int64_data[i] = (int64_t) value * 10000000000LL;
+    simd_float_data[i] = (float) value / 4;
+    simd_double_data[i] = (double) value / 8;
+  }
+}
+
+mz_SimdLevel simd_detected_level() {
+  mz_simd_force_level(mz_SimdLevelAuto);
+  return mz_simd_level();
+}
+
+static char *it_finds_values_at_every_level() {
+  simd_fill();
+  simd_int32_data[700] = 1000;
+  simd_int32_data[1001] = 1001;
+  simd_double_data[5] = 0.1;
+  for (mz_SimdLevel level = mz_SimdLevelScalar; level <= simd_detected_level(); level++) {
+    mz_simd_force_level(level);
+    mu_assert("error - level not forced", mz_simd_level() == level);
+    mu_assert("error - int32 index != 700", mz_simd_find_int32(simd_int32_data, SIMD_TEST_LEN, 1000) == 700);
+    mu_assert("error - int32 in remainder not found", mz_simd_find_int32(simd_int32_data, SIMD_TEST_LEN, 1001) == 1001);
+    mu_assert("error - missing int32 found", mz_simd_find_int32(simd_int32_data, SIMD_TEST_LEN, 2000) == MZ_NPOS);
+    mu_assert("error - int64 index != 0",
+              mz_simd_find_int64(simd_int64_data, SIMD_TEST_LEN, simd_int64_data[0]) == 0);
+    mu_assert("error - float index != 1",
+              mz_simd_find_float(simd_float_data, SIMD_TEST_LEN, simd_float_data[1]) == 1);
+    mu_assert("error - double index != 5", mz_simd_find_double(simd_double_data, SIMD_TEST_LEN, 0.1) == 5);
+    mu_assert("error - found in empty array", mz_simd_find_int32(simd_int32_data, 0, 1000) == MZ_NPOS);
+  }
+  mz_simd_force_level(mz_SimdLevelAuto);
+  return 0;
+}
+
+static char *it_counts_with_every_comparison() {
+  simd_fill();
+  for (mz_SimdLevel level = mz_SimdLevelScalar; level <= simd_detected_level(); level++) {
+    mz_simd_force_level(level);
+    for (mz_SimdCompare compare = mz_SimdCompareEqual; compare <= mz_SimdCompareGreaterEqual; compare++) {
+      size_t expected_int32 = 0;
+      size_t expected_float = 0;
+      for (int i = 0; i < SIMD_TEST_LEN; i++) {
+        int32_t a = simd_int32_data[i];
+        float b = simd_float_data[i];
+        switch (compare) {
+          case mz_SimdCompareEqual: expected_int32 += a == 42; expected_float += b == 10.5f; break;
+          case mz_SimdCompareNotEqual: expected_int32 += a != 42; expected_float += b != 10.5f; break;
+          case mz_SimdCompareLess: expected_int32 += a < 42; expected_float += b < 10.5f; break;
+          case mz_SimdCompareLessEqual: expected_int32 += a <= 42; expected_float += b <= 10.5f; break;
+          case mz_SimdCompareGreater: expected_int32 += a > 42; expected_float += b > 10.5f; break;
+          default: expected_int32 += a >= 42; expected_float += b >= 10.5f; break;
+        }
+      }
+      mu_assert("error - int32 count is wrong",
+                mz_simd_count_int32(simd_int32_data, SIMD_TEST_LEN, compare, 42) == expected_int32);
+      mu_assert("error - float count is wrong",
+                mz_simd_count_float(simd_float_data, SIMD_TEST_LEN, compare, 10.5f) == expected_float);
+    }
+    mu_assert("error - int64 count != 2",
+              mz_simd_count_int64(simd_int64_data, SIMD_TEST_LEN, mz_SimdCompareEqual, simd_int64_data[0]) == 2);
+    mu_assert("error - double count != len",
+              mz_simd_count_double(simd_double_data, SIMD_TEST_LEN, mz_SimdCompareLess, 1000) == SIMD_TEST_LEN);
+  }
+  mz_simd_force_level(mz_SimdLevelAuto);
+  return 0;
+}
+
+static char *it_reduces_min_max_and_sum() {
+  simd_fill();
+  int64_t expected_sum = 0;
+  for (int i = 0; i < SIMD_TEST_LEN; i++) {
+    expected_sum += simd_int32_data[i];
+  }
+  for (mz_SimdLevel level = mz_SimdLevelScalar; level <= simd_detected_level(); level++) {
+    mz_simd_force_level(level);
+    int32_t int32_result;
+    int64_t int64_result;
+    float float_result;
+    double double_result;
+    mu_assert("error - min of empty array", !mz_simd_min_int32(simd_int32_data, 0, &int32_result));
+    mu_assert("error - int32 min != -500",
+              mz_simd_min_int32(simd_int32_data, SIMD_TEST_LEN, &int32_result) && int32_result == -500);
+    mu_assert("error - int32 max != 499",
+              mz_simd_max_int32(simd_int32_data, SIMD_TEST_LEN, &int32_result) && int32_result == 499);
+    mu_assert("error - short int32 max != 419",
+              mz_simd_max_int32(simd_int32_data, 3, &int32_result) && int32_result == 419);
+    mu_assert("error - int64 min is wrong",
+              mz_simd_min_int64(simd_int64_data, SIMD_TEST_LEN, &int64_result) && int64_result == -5000000000000LL);
+    mu_assert("error - float max != 124.75",
+              mz_simd_max_float(simd_float_data, SIMD_TEST_LEN, &float_result) && float_result == 124.75f);
+    mu_assert("error - double min != -62.5",
+              mz_simd_min_double(simd_double_data, SIMD_TEST_LEN, &double_result) && double_result == -62.5);
+    mu_assert("error - int32 sum is wrong", mz_simd_sum_int32(simd_int32_data, SIMD_TEST_LEN) == expected_sum);
+    mu_assert("error - int64 sum is wrong",
+              mz_simd_sum_int64(simd_int64_data, SIMD_TEST_LEN) == expected_sum * 10000000000LL);
+    //quarters and eighths of small integers add up exactly
+    mu_assert("error - float sum is wrong",
+              mz_simd_sum_float(simd_float_data, SIMD_TEST_LEN) == (double) expected_sum / 4);
+    mu_assert("error - double sum is wrong",
+              mz_simd_sum_double(simd_double_data, SIMD_TEST_LEN) == (double) expected_sum / 8);
+  }
+  mz_simd_force_level(mz_SimdLevelAuto);
+  return 0;
+}
+
+static char *it_compacts_matching_elements_in_place() {
+  for (mz_SimdLevel level = mz_SimdLevelScalar; level <= simd_detected_level(); level++) {
+    mz_simd_force_level(level);
+    simd_fill();
+    int32_t expected[SIMD_TEST_LEN];
+    size_t expected_count = 0;
+    for (int i = 0; i < SIMD_TEST_LEN; i++) {
+      if (simd_int32_data[i] >= 250) {
+        expected[expected_count++] = simd_int32_data[i];
+      }
+    }
+    size_t count = mz_simd_compact_int32(simd_int32_data, SIMD_TEST_LEN, mz_SimdCompareGreaterEqual, 250,
+                                         simd_int32_data);
+    mu_assert("error - int32 count != expected", count == expected_count);
+    mu_assert("error - int32 compacted elements differ",
+              memcmp(simd_int32_data, expected, count * sizeof(int32_t)) == 0);
+    double out[SIMD_TEST_LEN];
+    count = mz_simd_compact_double(simd_double_data, SIMD_TEST_LEN, mz_SimdCompareLess, -62, out);
+    mu_assert("error - double count != 5", count == 5);
+    for (size_t i = 0; i < count; i++) {
+      mu_assert("error - double compacted element >= -62", out[i] < -62);
+    }
+  }
+  mz_simd_force_level(mz_SimdLevelAuto);
+  return 0;
+}
+
+static char *mz_simd_tests() {
+  mu_run_test(it_finds_values_at_every_level);
+  mu_run_test(it_counts_with_every_comparison);
+  mu_run_test(it_reduces_min_max_and_sum);
+  mu_run_test(it_compacts_matching_elements_in_place);
+  return 0;
+}
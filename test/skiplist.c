@@ -0,0 +1,113 @@
+#include <stdio.h>
+#include <stdint.h>
+#include "../lib/minunit.h"
+#include "../mz/skiplist.h"
+#include "../mz/logger.h"
+
+int skiplist_compare(const void *a, const void *b) {
+  uintptr_t x = *(uintptr_t *) a;
+  uintptr_t y = *(uintptr_t *) b;
+  return x < y ? -1 : x > y;
+}
+
+//orders by the high bits only, so values with equal high bits compare equal
+int skiplist_compare_bucket(const void *a, const void *b) {
+  uintptr_t x = *(uintptr_t *) a >> 8;
+  uintptr_t y = *(uintptr_t *) b >> 8;
+  return x < y ? -1 : x > y;
+}
+
+static char *it_keeps_values_ordered() {
+  mz_SkipList *list = mz_skiplist_new(skiplist_compare);
+  for (uintptr_t i = 0; i < 10000; i++) {
+    mu_assert("error - insert failed", mz_skiplist_insert(list, (void *) ((i * 7919) % 10000)));
+  }
+  mu_assert("error - size != 10000", mz_skiplist_size(list) == 10000);
+  uintptr_t expected = 0;
+  mzm_skiplist_foreach(list, value) {
+    mu_assert("error - values are not in order", value == (void *) expected);
+    expected++;
+  }
+  mu_assert("error - foreach did not visit every value", expected == 10000);
+  mz_skiplist_free(list);
+  return 0;
+}
+
+static char *it_finds_and_removes_values() {
+  mz_SkipList *list = mz_skiplist_new(skiplist_compare);
+  for (uintptr_t i = 0; i < 1000; i += 2) {
+    mz_skiplist_insert(list, (void *) i);
+  }
+  mu_assert("error - 500 not found", mz_skiplist_find(list, (void *) 500)->value == (void *) 500);
+  mu_assert("error - 501 found", mz_skiplist_find(list, (void *) 501) == NULL);
+  void *value = NULL;
+  for (uintptr_t i = 0; i < 1000; i += 4) {
+    mu_assert("error - remove failed", mz_skiplist_remove(list, (void *) i, &value) && value == (void *) i);
+  }
+  mu_assert("error - remove of missing value succeeded", !mz_skiplist_remove(list, (void *) 4, NULL));
+  mu_assert("error - size != 250", mz_skiplist_size(list) == 250);
+  uintptr_t expected = 2;
+  mzm_skiplist_foreach(list, remaining) {
+    mu_assert("error - wrong value left", remaining == (void *) expected);
+    expected += 4;
+  }
+  //removed nodes are reused
+  size_t slabs = list->slabs->size;
+  for (uintptr_t i = 0; i < 1000; i += 4) {
+    mz_skiplist_insert(list, (void *) i);
+  }
+  mu_assert("error - reinserting allocated a slab per node", list->slabs->size < slabs + 4);
+  mu_assert("error - size != 500", mz_skiplist_size(list) == 500);
+  mz_skiplist_clear(list);
+  mu_assert("error - clear left values", mz_skiplist_size(list) == 0 && mz_skiplist_first(list) == NULL);
+  mu_assert("error - find in empty list", mz_skiplist_find(list, (void *) 2) == NULL);
+  mz_skiplist_free(list);
+  return 0;
+}
+
+static char *it_iterates_a_range() {
+  mz_SkipList *list = mz_skiplist_new(skiplist_compare);
+  for (uintptr_t i = 0; i < 100; i++) {
+    mz_skiplist_insert(list, (void *) (i * 10));
+  }
+  uintptr_t sum = 0;
+  size_t count = 0;
+  for (mz_SkipListNode *node = mz_skiplist_lower_bound(list, (void *) 95);
+       node && (uintptr_t) node->value < 200; node = mz_skiplist_next(node)) {
+    sum += (uintptr_t) node->value;
+    count++;
+  }
+  mu_assert("error - range is not 100..190", count == 10 && sum == 1450);
+  mu_assert("error - lower_bound past the end", mz_skiplist_lower_bound(list, (void *) 991) == NULL);
+  mu_assert("error - lower_bound of 0", mz_skiplist_lower_bound(list, (void *) 0) == mz_skiplist_first(list));
+  mz_skiplist_free(list);
+  return 0;
+}
+
+static char *it_keeps_equal_values_in_insertion_order() {
+  mz_SkipList *list = mz_skiplist_new(skiplist_compare_bucket);
+  for (uintptr_t i = 0; i < 64; i++) {
+    mz_skiplist_insert(list, (void *) (((i % 4) << 8) | i));
+  }
+  uintptr_t previous = 0;
+  mzm_skiplist_foreach(list, value) {
+    uintptr_t current = (uintptr_t) value;
+    mu_assert("error - equal values reordered", (current >> 8) > (previous >> 8) || (current & 0xff) >= (previous & 0xff));
+    previous = current;
+  }
+  void *removed = NULL;
+  mu_assert("error - remove failed", mz_skiplist_remove(list, (void *) (2 << 8), &removed));
+  mu_assert("error - did not remove the first equal value", removed == (void *) ((2 << 8) | 2));
+  mu_assert("error - find did not return the first equal value",
+            mz_skiplist_find(list, (void *) (1 << 8))->value == (void *) ((1 << 8) | 1));
+  mz_skiplist_free(list);
+  return 0;
+}
+
+static char *mz_skiplist_tests() {
+  mu_run_test(it_keeps_values_ordered);
+  mu_run_test(it_finds_and_removes_values);
+  mu_run_test(it_iterates_a_range);
+  mu_run_test(it_keeps_equal_values_in_insertion_order);
+  return 0;
+}
@@ -0,0 +1,84 @@
+#include <stdio.h>
+#include <stdint.h>
+#include "../lib/minunit.h"
+#include "../mz/sortedlist.h"
+#include "../mz/logger.h"
+
+int sortedlist_compare(const void *a, const void *b) {
+  uintptr_t x = *(uintptr_t *) a;
+  uintptr_t y = *(uintptr_t *) b;
+  return x < y ? -1 : x > y;
+}
+
+//orders by the high bits only, so the low bits show whether equal values kept their order
+int sortedlist_compare_bucket(const void *a, const void *b) {
+  uintptr_t x = *(uintptr_t *) a >> 16;
+  uintptr_t y = *(uintptr_t *) b >> 16;
+  return x < y ? -1 : x > y;
+}
+
+static char *it_keeps_inserted_values_in_order() {
+  mz_SortedList *list = mz_sortedlist_new(16, sortedlist_compare);
+  for (uintptr_t i = 0; i < 100000; i++) {
+    mu_assert("error - insert failed", mz_sortedlist_insert(list, (void *) ((i * 7919) % 100000)));
+  }
+  mu_assert("error - size != 100000", mz_sortedlist_size(list) == 100000);
+  mu_assert("error - delta was never merged", list->base->size > 0);
+  mz_ArrayList *values = mz_sortedlist_values(list);
+  mu_assert("error - values did not flush", list->delta->size == 0 && values->size == 100000);
+  for (uintptr_t i = 0; i < 100000; i++) {
+    mu_assert("error - values are not in order", values->array[i] == (void *) i);
+  }
+  mz_sortedlist_free(list);
+  return 0;
+}
+
+static char *it_finds_values_in_both_parts() {
+  mz_SortedList *list = mz_sortedlist_new(16, sortedlist_compare);
+  for (uintptr_t i = 0; i < 1000; i += 2) {
+    mz_sortedlist_insert(list, (void *) i);
+  }
+  mz_sortedlist_flush(list);
+  mz_sortedlist_insert(list, (void *) 501);
+  mz_sortedlist_insert(list, (void *) 2001);
+  mu_assert("error - delta is empty", list->delta->size == 2);
+  void *value = NULL;
+  mu_assert("error - 500 not found in the base", mz_sortedlist_find(list, (void *) 500, &value) && value == (void *) 500);
+  mu_assert("error - 501 not found in the delta", mz_sortedlist_find(list, (void *) 501, &value) && value == (void *) 501);
+  mu_assert("error - 503 found", !mz_sortedlist_find(list, (void *) 503, NULL));
+  mu_assert("error - remove from base failed", mz_sortedlist_remove(list, (void *) 500, NULL));
+  mu_assert("error - remove from delta failed", mz_sortedlist_remove(list, (void *) 2001, &value) && value == (void *) 2001);
+  mu_assert("error - removed value found", !mz_sortedlist_find(list, (void *) 500, NULL));
+  mu_assert("error - remove of missing value succeeded", !mz_sortedlist_remove(list, (void *) 500, NULL));
+  mu_assert("error - size != 500", mz_sortedlist_size(list) == 500);
+  mz_ArrayList *values = mz_sortedlist_values(list);
+  mu_assert("error - 501 not merged in place", values->array[250] == (void *) 501);
+  mz_sortedlist_free(list);
+  return 0;
+}
+
+static char *it_keeps_equal_sorted_values_in_insertion_order() {
+  mz_SortedList *list = mz_sortedlist_new(16, sortedlist_compare_bucket);
+  for (uintptr_t i = 0; i < 5000; i++) {
+    mz_sortedlist_insert(list, (void *) (((i % 7) << 16) | i));
+  }
+  mz_ArrayList *values = mz_sortedlist_values(list);
+  for (size_t i = 1; i < values->size; i++) {
+    uintptr_t previous = (uintptr_t) values->array[i - 1];
+    uintptr_t current = (uintptr_t) values->array[i];
+    mu_assert("error - values are not in order", (current >> 16) >= (previous >> 16));
+    mu_assert("error - equal values reordered", (current >> 16) > (previous >> 16) || current > previous);
+  }
+  void *removed = NULL;
+  mu_assert("error - remove failed", mz_sortedlist_remove(list, (void *) (3 << 16), &removed));
+  mu_assert("error - did not remove the first equal value", removed == (void *) ((3 << 16) | 3));
+  mz_sortedlist_free(list);
+  return 0;
+}
+
+static char *mz_sortedlist_tests() {
+  mu_run_test(it_keeps_inserted_values_in_order);
+  mu_run_test(it_finds_values_in_both_parts);
+  mu_run_test(it_keeps_equal_sorted_values_in_insertion_order);
+  return 0;
+}
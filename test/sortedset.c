@@ -0,0 +1,127 @@
+#include <stdio.h>
+#include <stdint.h>
+#include "../lib/minunit.h"
+#include "../mz/sortedset.h"
+#include "../mz/losertree.h"
+#include "../mz/logger.h"
+
+int sortedset_compare(const void *a, const void *b) {
+  uintptr_t x = *(uintptr_t *) a;
+  uintptr_t y = *(uintptr_t *) b;
+  return x < y ? -1 : x > y;
+}
+
+//multiples of step below limit
+mz_ArrayList *sortedset_multiples(uintptr_t step, uintptr_t limit) {
+  mz_ArrayList *list = mz_arraylist_new(MZ_ARRAYLIST_INLINE_CAPACITY, sizeof(void *));
+  for (uintptr_t i = 0; i < limit; i += step) {
+    mz_arraylist_append(list, (void *) i);
+  }
+  return list;
+}
+
+bool sortedset_is_sorted(mz_ArrayList *list) {
+  for (size_t i = 1; i < list->size; i++) {
+    if ((uintptr_t) list->array[i - 1] > (uintptr_t) list->array[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+//checks every operation against sizes counted by hand, for balanced and lopsided inputs
+char *sortedset_check(uintptr_t step_a, uintptr_t step_b, uintptr_t limit) {
+  mz_ArrayList *a = sortedset_multiples(step_a, limit);
+  mz_ArrayList *b = sortedset_multiples(step_b, limit);
+  size_t common = 0;
+  for (uintptr_t i = 0; i < limit; i++) {
+    common += i % step_a == 0 && i % step_b == 0;
+  }
+  mz_ArrayList *result = mz_arraylist_union(a, b, sortedset_compare);
+  mu_assert("error - union size is wrong", result->size == a->size + b->size - common);
+  mu_assert("error - union is not sorted", sortedset_is_sorted(result));
+  mz_arraylist_free(result);
+  result = mz_arraylist_intersect(a, b, sortedset_compare);
+  mu_assert("error - intersection size is wrong", result->size == common);
+  mu_assert("error - intersection is not sorted", sortedset_is_sorted(result));
+  mz_arraylist_free(result);
+  result = mz_arraylist_intersect(b, a, sortedset_compare);
+  mu_assert("error - swapped intersection size is wrong", result->size == common);
+  mz_arraylist_free(result);
+  result = mz_arraylist_difference(a, b, sortedset_compare);
+  mu_assert("error - difference size is wrong", result->size == a->size - common);
+  mu_assert("error - difference is not sorted", sortedset_is_sorted(result));
+  mz_arraylist_free(result);
+  result = mz_arraylist_difference(b, a, sortedset_compare);
+  mu_assert("error - swapped difference size is wrong", result->size == b->size - common);
+  mz_arraylist_free(result);
+  result = mz_arraylist_merge(a, b, sortedset_compare);
+  mu_assert("error - merge size is wrong", result->size == a->size + b->size);
+  mu_assert("error - merge is not sorted", sortedset_is_sorted(result));
+  mz_arraylist_free(result);
+  result = mz_arraylist_merge(b, a, sortedset_compare);
+  mu_assert("error - swapped merge is not sorted", result->size == a->size + b->size && sortedset_is_sorted(result));
+  mz_arraylist_free(result);
+  mz_arraylist_free(a);
+  mz_arraylist_free(b);
+  return 0;
+}
+
+static char *it_combines_balanced_sorted_lists() {
+  char *message = sortedset_check(2, 3, 1000);
+  return message ? message : sortedset_check(1, 1, 100);
+}
+
+static char *it_combines_lopsided_sorted_lists_by_galloping() {
+  char *message = sortedset_check(1, 97, 10000);
+  return message ? message : sortedset_check(113, 1, 10000);
+}
+
+static char *it_merges_many_lists_with_a_loser_tree() {
+  mz_ArrayList *lists[5];
+  size_t total = 0;
+  for (uintptr_t i = 0; i < 5; i++) {
+    lists[i] = sortedset_multiples(i + 1, 200);
+    total += lists[i]->size;
+  }
+  //one empty source
+  mz_arraylist_remove_range(lists[4], 0, lists[4]->size - 1);
+  mz_arraylist_remove_last(lists[4]);
+  total -= 40;
+  mz_ArrayList *result = mz_arraylist_merge_many(lists, 5, sortedset_compare);
+  mu_assert("error - merged size != total", result->size == total);
+  mu_assert("error - merged list is not sorted", sortedset_is_sorted(result));
+  mu_assert("error - last element != 199", result->array[total - 1] == (void *) 199);
+  mz_arraylist_free(result);
+  result = mz_arraylist_merge_many(lists, 1, sortedset_compare);
+  mu_assert("error - single list merge size != 200", result->size == 200);
+  mz_arraylist_free(result);
+  for (int i = 0; i < 5; i++) {
+    mz_arraylist_free(lists[i]);
+  }
+  return 0;
+}
+
+static char *it_removes_duplicates_in_place() {
+  mz_ArrayList *list = mz_arraylist_new(MZ_ARRAYLIST_INLINE_CAPACITY, sizeof(void *));
+  uintptr_t values[] = {1, 1, 2, 3, 3, 3, 4, 5, 5};
+  for (size_t i = 0; i < 9; i++) {
+    mz_arraylist_append(list, (void *) values[i]);
+  }
+  mu_assert("error - unique failed", mz_arraylist_unique(list, sortedset_compare));
+  mu_assert("error - size != 5", list->size == 5);
+  for (uintptr_t i = 0; i < 5; i++) {
+    mu_assert("error - element != i + 1", list->array[i] == (void *) (i + 1));
+  }
+  mu_assert("error - unique of unique list failed", mz_arraylist_unique(list, sortedset_compare) && list->size == 5);
+  mz_arraylist_free(list);
+  return 0;
+}
+
+static char *mz_sortedset_tests() {
+  mu_run_test(it_combines_balanced_sorted_lists);
+  mu_run_test(it_combines_lopsided_sorted_lists_by_galloping);
+  mu_run_test(it_merges_many_lists_with_a_loser_tree);
+  mu_run_test(it_removes_duplicates_in_place);
+  return 0;
+}
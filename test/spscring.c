@@ -0,0 +1,115 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "../lib/minunit.h"
+#include "../mz/spscring.h"
+#include "../mz/logger.h"
+
+#define SPSCRING_TEST_ITEMS 1000000
+
+void *spscring_test_producer(void *arg) {
+  mz_SpscRing *ring = arg;
+  void *batch[32];
+  uintptr_t next = 0;
+  while (next < SPSCRING_TEST_ITEMS) {
+    //alternate single and bulk pushes
+    if (next % 2 == 0) {
+      if (!mz_spscring_push(ring, (void *) next)) {
+        sched_yield();
+        continue;
+      }
+      next += 1;
+    } else {
+      size_t len = 0;
+      for (; len < 32 && next + len < SPSCRING_TEST_ITEMS; len++) {
+        batch[len] = (void *) (next + len);
+      }
+      size_t pushed = mz_spscring_push_bulk(ring, batch, len);
+      next += pushed;
+      if (pushed == 0) {
+        sched_yield();
+      }
+    }
+  }
+  return NULL;
+}
+
+static char *it_creates_spscring_with_power_of_two_capacity() {
+  mz_SpscRing *ring = mz_spscring_new(5);
+  mu_assert("error - capacity != 8", mz_spscring_capacity(ring) == 8);
+  mu_assert("error - size != 0", mz_spscring_size(ring) == 0);
+  mz_spscring_free(ring);
+  return 0;
+}
+
+static char *it_pushes_and_pops_single_items_around_the_ring() {
+  mz_SpscRing *ring = mz_spscring_new(4);
+  void *value = NULL;
+  mu_assert("error - pop from empty ring succeeded", !mz_spscring_pop(ring, &value));
+  for (uintptr_t i = 0; i < 10; i++) {
+    mu_assert("error - push failed", mz_spscring_push(ring, (void *) i));
+    mu_assert("error - push failed", mz_spscring_push(ring, (void *) (i + 100)));
+    mu_assert("error - pop failed", mz_spscring_pop(ring, &value));
+    mu_assert("error - value != i", value == (void *) i);
+    mu_assert("error - pop failed", mz_spscring_pop(ring, &value));
+    mu_assert("error - value != i + 100", value == (void *) (i + 100));
+  }
+  for (uintptr_t i = 0; i < 4; i++) {
+    mz_spscring_push(ring, (void *) i);
+  }
+  mu_assert("error - push into full ring succeeded", !mz_spscring_push(ring, NULL));
+  mz_spscring_free(ring);
+  return 0;
+}
+
+static char *it_pushes_and_pops_in_bulk_across_the_wrap() {
+  mz_SpscRing *ring = mz_spscring_new(8);
+  void *input[16];
+  void *output[16];
+  for (uintptr_t i = 0; i < 16; i++) {
+    input[i] = (void *) i;
+  }
+  mu_assert("error - pushed != 6", mz_spscring_push_bulk(ring, input, 6) == 6);
+  mu_assert("error - popped != 5", mz_spscring_pop_bulk(ring, output, 5) == 5);
+  //only 7 slots are free
+  mu_assert("error - pushed != 7", mz_spscring_push_bulk(ring, input + 6, 10) == 7);
+  mu_assert("error - size != 8", mz_spscring_size(ring) == 8);
+  mu_assert("error - popped != 8", mz_spscring_pop_bulk(ring, output + 5, 11) == 8);
+  for (uintptr_t i = 0; i < 13; i++) {
+    mu_assert("error - output != input", output[i] == (void *) i);
+  }
+  mu_assert("error - popped from empty ring", mz_spscring_pop_bulk(ring, output, 16) == 0);
+  mz_spscring_free(ring);
+  return 0;
+}
+
+static char *it_hands_off_items_in_order_between_two_threads() {
+  mz_SpscRing *ring = mz_spscring_new(256);
+  pthread_t producer;
+  pthread_create(&producer, NULL, spscring_test_producer, ring);
+  void *batch[64];
+  uintptr_t expected = 0;
+  bool in_order = true;
+  while (expected < SPSCRING_TEST_ITEMS) {
+    size_t popped = mz_spscring_pop_bulk(ring, batch, 64);
+    for (size_t i = 0; i < popped; i++) {
+      in_order = in_order && batch[i] == (void *) expected;
+      expected += 1;
+    }
+    if (popped == 0) {
+      sched_yield();
+    }
+  }
+  pthread_join(producer, NULL);
+  mu_assert("error - items out of order", in_order);
+  mz_spscring_free(ring);
+  return 0;
+}
+
+static char *mz_spscring_tests() {
+  mu_run_test(it_creates_spscring_with_power_of_two_capacity);
+  mu_run_test(it_pushes_and_pops_single_items_around_the_ring);
+  mu_run_test(it_pushes_and_pops_in_bulk_across_the_wrap);
+  mu_run_test(it_hands_off_items_in_order_between_two_threads);
+  return 0;
+}
@@ -0,0 +1,49 @@
+#include <stdio.h>
+#include <stdint.h>
+#include "../lib/minunit.h"
+#include "../mz/topk.h"
+#include "../mz/logger.h"
+
+int topk_compare(const void *a, const void *b) {
+  uintptr_t x = *(uintptr_t *) a;
+  uintptr_t y = *(uintptr_t *) b;
+  return x < y ? -1 : x > y;
+}
+
+static char *it_keeps_the_k_greatest_values() {
+  mz_TopK *topk = mz_topk_new(10, topk_compare);
+  void *threshold = NULL;
+  mu_assert("error - threshold of empty topk", !mz_topk_threshold(topk, &threshold));
+  for (uintptr_t i = 0; i < 10000; i++) {
+    mu_assert("error - add failed", mz_topk_add(topk, (void *) ((i * 7919) % 10000)));
+  }
+  mu_assert("error - size != 10", mz_topk_size(topk) == 10);
+  mu_assert("error - threshold != 9990", mz_topk_threshold(topk, &threshold) && threshold == (void *) 9990);
+  mz_ArrayList *result = mz_topk_result(topk);
+  mu_assert("error - result size != 10", result->size == 10);
+  for (uintptr_t i = 0; i < 10; i++) {
+    mu_assert("error - result is not the greatest values first", result->array[i] == (void *) (9999 - i));
+  }
+  mz_arraylist_free(result);
+  mz_topk_free(topk);
+  return 0;
+}
+
+static char *it_keeps_everything_below_k() {
+  mz_TopK *topk = mz_topk_new(10, topk_compare);
+  void *values[] = {(void *) 3, (void *) 1, (void *) 2};
+  mz_topk_add_range(topk, values, 3);
+  mz_ArrayList *result = mz_topk_result(topk);
+  mu_assert("error - result size != 3", result->size == 3);
+  mu_assert("error - result[0] != 3", result->array[0] == (void *) 3);
+  mu_assert("error - result[2] != 1", result->array[2] == (void *) 1);
+  mz_arraylist_free(result);
+  mz_topk_free(topk);
+  return 0;
+}
+
+static char *mz_topk_tests() {
+  mu_run_test(it_keeps_the_k_greatest_values);
+  mu_run_test(it_keeps_everything_below_k);
+  return 0;
+}